@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "SIMDHelpers.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <random>
+#include <absl/algorithm/container.h>
+
+// Gather and interpolate a source read at a pitch ratio, as the voices do
+
+constexpr float maxJump { 2 };
+
+class InterpolateLinear : public benchmark::Fixture {
+public:
+  void SetUp(const ::benchmark::State& state) {
+    std::random_device rd { };
+    std::mt19937 gen { rd() };
+    std::uniform_real_distribution<float> jumpDist { 0, maxJump };
+    std::uniform_real_distribution<float> sampleDist { -1.0f, 1.0f };
+    const auto size = static_cast<size_t>(state.range(0));
+    indices = std::vector<int>(size);
+    leftCoeffs = std::vector<float>(size);
+    rightCoeffs = std::vector<float>(size);
+    output = std::vector<float>(size);
+
+    std::vector<float> jumps(size);
+    std::vector<float> positions(size);
+    absl::c_generate(jumps, [&]() { return jumpDist(gen); });
+    sfz::cumsum<float>(jumps, absl::MakeSpan(positions));
+    sfz::sfzInterpolationCast<float>(positions, absl::MakeSpan(indices), absl::MakeSpan(leftCoeffs), absl::MakeSpan(rightCoeffs));
+
+    floatInput = std::vector<float>(indices.back() + 2);
+    absl::c_generate(floatInput, [&]() { return sampleDist(gen); });
+    int16Input = std::vector<int16_t>(floatInput.size());
+    absl::c_transform(floatInput, int16Input.begin(), [](float value) { return static_cast<int16_t>(value * 32767); });
+  }
+
+  void TearDown(const ::benchmark::State& state [[maybe_unused]]) {
+
+  }
+
+    std::vector<float> floatInput;
+    std::vector<int16_t> int16Input;
+    std::vector<int> indices;
+    std::vector<float> leftCoeffs;
+    std::vector<float> rightCoeffs;
+    std::vector<float> output;
+};
+
+
+BENCHMARK_DEFINE_F(InterpolateLinear, Scalar)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        sfz::interpolateLinear<float, false>(floatInput, indices, leftCoeffs, rightCoeffs, absl::MakeSpan(output));
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+
+BENCHMARK_DEFINE_F(InterpolateLinear, SIMD)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        sfz::interpolateLinear<float, true>(floatInput, indices, leftCoeffs, rightCoeffs, absl::MakeSpan(output));
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+
+BENCHMARK_DEFINE_F(InterpolateLinear, Scalar_Int16)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        sfz::interpolateLinear<int16_t, false>(int16Input, indices, leftCoeffs, rightCoeffs, absl::MakeSpan(output));
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+
+BENCHMARK_DEFINE_F(InterpolateLinear, SIMD_Int16)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        sfz::interpolateLinear<int16_t, true>(int16Input, indices, leftCoeffs, rightCoeffs, absl::MakeSpan(output));
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+
+// Register the function as a benchmark
+BENCHMARK_REGISTER_F(InterpolateLinear, Scalar)->RangeMultiplier(2)->Range((2<<6), (2<<12));
+BENCHMARK_REGISTER_F(InterpolateLinear, SIMD)->RangeMultiplier(2)->Range((2<<6), (2<<12));
+BENCHMARK_REGISTER_F(InterpolateLinear, Scalar_Int16)->RangeMultiplier(2)->Range((2<<6), (2<<12));
+BENCHMARK_REGISTER_F(InterpolateLinear, SIMD_Int16)->RangeMultiplier(2)->Range((2<<6), (2<<12));
+BENCHMARK_MAIN();
@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "SIMDHelpers.h"
+#include "Oversampler.h"
+#include "AudioBuffer.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <random>
+#include <absl/algorithm/container.h>
+
+// The cost of a voice block at each interpolation quality, compared to the
+// linear interpolation of an oversampled render or of oversampled samples,
+// which are the other ways to reduce the aliasing of transposed samples
+
+constexpr float pitchRatio { 1.37f };
+constexpr int oversampling { 4 };
+
+class InterpolationQuality : public benchmark::Fixture {
+public:
+  void SetUp(const ::benchmark::State& state) {
+    std::random_device rd { };
+    std::mt19937 gen { rd() };
+    std::uniform_real_distribution<float> sampleDist { -1.0f, 1.0f };
+    const auto size = static_cast<size_t>(state.range(0));
+    output = std::vector<float>(size);
+
+    castPositions(size, pitchRatio, indices, leftCoeffs, rightCoeffs);
+    // The render at 4 times the rate reads 4 times as many positions
+    castPositions(size * oversampling, pitchRatio / oversampling, renderIndices, renderLeftCoeffs, renderRightCoeffs);
+    // The oversampled sample is read at 4 times the pitch ratio
+    castPositions(size, pitchRatio * oversampling, upsampledIndices, upsampledLeftCoeffs, upsampledRightCoeffs);
+
+    input = std::vector<float>(indices.back() + sfz::SincTable::tapsAfter + 1);
+    absl::c_generate(input, [&]() { return sampleDist(gen); });
+    int16Input = std::vector<int16_t>(input.size());
+    absl::c_transform(input, int16Input.begin(), [](float value) { return static_cast<int16_t>(value * 32767); });
+    upsampledInput = std::vector<float>(upsampledIndices.back() + 2);
+    absl::c_generate(upsampledInput, [&]() { return sampleDist(gen); });
+
+    renderBuffer = sfz::AudioBuffer<float>(1, size * oversampling);
+    outputBuffer = sfz::AudioBuffer<float>(1, size);
+    downsampler.setSamplesPerBlock(static_cast<int>(size));
+    downsampler.setFactor(sfz::Oversampling::x4);
+  }
+
+  void TearDown(const ::benchmark::State& state [[maybe_unused]]) {
+
+  }
+
+  static void castPositions(size_t size, float ratio, std::vector<int>& indices, std::vector<float>& leftCoeffs, std::vector<float>& rightCoeffs)
+  {
+    indices = std::vector<int>(size);
+    leftCoeffs = std::vector<float>(size);
+    rightCoeffs = std::vector<float>(size);
+    std::vector<float> positions(size);
+    sfz::linearRamp<float>(absl::MakeSpan(positions), static_cast<float>(sfz::SincTable::tapsBefore), ratio);
+    sfz::sfzInterpolationCast<float>(positions, absl::MakeSpan(indices), absl::MakeSpan(leftCoeffs), absl::MakeSpan(rightCoeffs));
+  }
+
+    std::vector<float> input;
+    std::vector<int16_t> int16Input;
+    std::vector<float> upsampledInput;
+    std::vector<int> indices;
+    std::vector<float> leftCoeffs;
+    std::vector<float> rightCoeffs;
+    std::vector<int> renderIndices;
+    std::vector<float> renderLeftCoeffs;
+    std::vector<float> renderRightCoeffs;
+    std::vector<int> upsampledIndices;
+    std::vector<float> upsampledLeftCoeffs;
+    std::vector<float> upsampledRightCoeffs;
+    std::vector<float> output;
+    sfz::AudioBuffer<float> renderBuffer;
+    sfz::AudioBuffer<float> outputBuffer;
+    sfz::Downsampler downsampler;
+};
+
+BENCHMARK_DEFINE_F(InterpolationQuality, Linear)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        sfz::interpolateLinear<float>(input, indices, leftCoeffs, rightCoeffs, absl::MakeSpan(output));
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+
+BENCHMARK_DEFINE_F(InterpolationQuality, Hermite_Scalar)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        sfz::interpolateHermite<float, false>(input, indices, rightCoeffs, absl::MakeSpan(output));
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+
+BENCHMARK_DEFINE_F(InterpolationQuality, Hermite_SIMD)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        sfz::interpolateHermite<float, true>(input, indices, rightCoeffs, absl::MakeSpan(output));
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+
+BENCHMARK_DEFINE_F(InterpolationQuality, Hermite_SIMD_Int16)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        sfz::interpolateHermite<int16_t, true>(int16Input, indices, rightCoeffs, absl::MakeSpan(output));
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+
+BENCHMARK_DEFINE_F(InterpolationQuality, Sinc_Scalar)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        sfz::interpolateSinc<float, false>(input, indices, rightCoeffs, absl::MakeSpan(output));
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+
+BENCHMARK_DEFINE_F(InterpolationQuality, Sinc_SIMD)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        sfz::interpolateSinc<float, true>(input, indices, rightCoeffs, absl::MakeSpan(output));
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+
+BENCHMARK_DEFINE_F(InterpolationQuality, Sinc_SIMD_Int16)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        sfz::interpolateSinc<int16_t, true>(int16Input, indices, rightCoeffs, absl::MakeSpan(output));
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+
+BENCHMARK_DEFINE_F(InterpolationQuality, RenderOversampling_x4)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        sfz::interpolateLinear<float>(input, renderIndices, renderLeftCoeffs, renderRightCoeffs, renderBuffer.getSpan(0));
+        downsampler.process(renderBuffer, outputBuffer);
+        benchmark::DoNotOptimize(outputBuffer.channelReader(0));
+    }
+}
+
+BENCHMARK_DEFINE_F(InterpolationQuality, SampleOversampling_x4)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        sfz::interpolateLinear<float>(upsampledInput, upsampledIndices, upsampledLeftCoeffs, upsampledRightCoeffs, absl::MakeSpan(output));
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+
+// Register the function as a benchmark
+BENCHMARK_REGISTER_F(InterpolationQuality, Linear)->RangeMultiplier(4)->Range((1<<6), (1<<12));
+BENCHMARK_REGISTER_F(InterpolationQuality, Hermite_Scalar)->RangeMultiplier(4)->Range((1<<6), (1<<12));
+BENCHMARK_REGISTER_F(InterpolationQuality, Hermite_SIMD)->RangeMultiplier(4)->Range((1<<6), (1<<12));
+BENCHMARK_REGISTER_F(InterpolationQuality, Hermite_SIMD_Int16)->RangeMultiplier(4)->Range((1<<6), (1<<12));
+BENCHMARK_REGISTER_F(InterpolationQuality, Sinc_Scalar)->RangeMultiplier(4)->Range((1<<6), (1<<12));
+BENCHMARK_REGISTER_F(InterpolationQuality, Sinc_SIMD)->RangeMultiplier(4)->Range((1<<6), (1<<12));
+BENCHMARK_REGISTER_F(InterpolationQuality, Sinc_SIMD_Int16)->RangeMultiplier(4)->Range((1<<6), (1<<12));
+BENCHMARK_REGISTER_F(InterpolationQuality, RenderOversampling_x4)->RangeMultiplier(4)->Range((1<<6), (1<<12));
+BENCHMARK_REGISTER_F(InterpolationQuality, SampleOversampling_x4)->RangeMultiplier(4)->Range((1<<6), (1<<12));
+BENCHMARK_MAIN();
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+// Throughput of the loader I/O backends, depending on the number of chunk
+// reads submitted together
+
+#include "IOBackend.h"
+#include "ghc/fs_std.hpp"
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <vector>
+
+constexpr size_t fileSize { 64 << 20 };
+constexpr uint32_t chunkSize { 64 << 10 };
+
+class IOFixture : public benchmark::Fixture {
+public:
+    void SetUp(const ::benchmark::State& state)
+    {
+        path = fs::temp_directory_path() / "sfizz_bm_io_backend.bin";
+        if (!fs::exists(path) || fs::file_size(path) != fileSize) {
+            std::vector<char> data(fileSize);
+            std::mt19937 gen { 42 };
+            for (auto& byte : data)
+                byte = static_cast<char>(gen());
+            std::ofstream output { path.string(), std::ios::binary };
+            output.write(data.data(), static_cast<std::streamsize>(data.size()));
+        }
+
+        file = sfz::ReadableFile(path);
+        const auto numReads = static_cast<size_t>(state.range(0));
+        buffers.resize(numReads * chunkSize);
+        std::mt19937 gen { 0 };
+        std::uniform_int_distribution<uint64_t> chunk { 0, fileSize / chunkSize - 1 };
+        requests.clear();
+        for (size_t i = 0; i < numReads; ++i)
+            requests.push_back({ file.descriptor(), chunk(gen) * chunkSize, chunkSize, &buffers[i * chunkSize] });
+    }
+
+    void TearDown(const ::benchmark::State& /* state */)
+    {
+        file = sfz::ReadableFile();
+    }
+
+    void run(sfz::IOBackend& backend, benchmark::State& state)
+    {
+        if (!file) {
+            state.SkipWithError("Could not open the benchmark file");
+            return;
+        }
+
+        int64_t bytesRead = 0;
+        for (auto _ : state) {
+            backend.read(requests, [&](size_t, int64_t result) {
+                bytesRead += result;
+            });
+            benchmark::DoNotOptimize(buffers.data());
+        }
+        state.SetBytesProcessed(bytesRead);
+    }
+
+    fs::path path;
+    sfz::ReadableFile file;
+    std::vector<uint8_t> buffers;
+    std::vector<sfz::ReadRequest> requests;
+};
+
+BENCHMARK_DEFINE_F(IOFixture, Blocking)(benchmark::State& state)
+{
+    sfz::BlockingIOBackend backend;
+    run(backend, state);
+}
+
+BENCHMARK_DEFINE_F(IOFixture, Default)(benchmark::State& state)
+{
+    auto backend = sfz::createIOBackend();
+    state.SetLabel(backend->name());
+    run(*backend, state);
+}
+
+BENCHMARK_REGISTER_F(IOFixture, Blocking)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK_REGISTER_F(IOFixture, Default)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK_MAIN();
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "Synth.h"
+#include <benchmark/benchmark.h>
+#include <fstream>
+
+// Loading of large generated instruments, where each group holds the
+// opcodes shared by its regions. The regions play generators so that the
+// time is spent parsing and building the regions rather than reading files.
+class LargeInstrument : public benchmark::Fixture {
+public:
+    void SetUp(const ::benchmark::State& state)
+    {
+        const auto numRegions = static_cast<int>(state.range(0));
+        file = fs::temp_directory_path() / "sfizz_bm_loadSfz.sfz";
+        std::ofstream output { file.string() };
+        output << "<global> ampeg_attack=0.01 ampeg_release=0.5 amp_veltrack=80\n";
+        for (int i = 0; i < numRegions; ++i) {
+            const int key = i % 128;
+            if (key == 0)
+                output << "<group> volume=-6 pan=10 cutoff=2000 fil_type=lpf_2p resonance=2"
+                       << " fil_veltrack=1200 ampeg_decay=2 ampeg_sustain=60 volume_oncc7=-6"
+                       << " amplitude_oncc11=100 seq_length=4 lovel=1 hivel=127 trigger=attack\n";
+            output << "<region> sample=*sine key=" << key << " pitch_keycenter=" << key
+                   << " seq_position=" << (i / 128) % 4 + 1 << "\n";
+        }
+        output.close();
+    }
+
+    void TearDown(const ::benchmark::State& state [[maybe_unused]])
+    {
+        fs::remove(file);
+    }
+
+    fs::path file;
+};
+
+BENCHMARK_DEFINE_F(LargeInstrument, Load)(benchmark::State& state) {
+    sfz::Synth synth;
+    for (auto _ : state)
+        synth.loadSfzFile(file);
+    state.counters["Regions"] = synth.getNumRegions();
+}
+
+// Loading again from the instrument cache, which skips parsing and building the regions
+BENCHMARK_DEFINE_F(LargeInstrument, LoadCached)(benchmark::State& state) {
+    const auto cacheDirectory = fs::temp_directory_path() / "sfizz_bm_loadSfz_cache";
+    sfz::Synth synth;
+    synth.setInstrumentCacheDirectory(cacheDirectory);
+    synth.loadSfzFile(file);
+    for (auto _ : state)
+        synth.loadSfzFile(file);
+    state.counters["Regions"] = synth.getNumRegions();
+    fs::remove_all(cacheDirectory);
+}
+
+BENCHMARK_REGISTER_F(LargeInstrument, Load)->RangeMultiplier(8)->Range(1 << 9, 1 << 15)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(LargeInstrument, LoadCached)->RangeMultiplier(8)->Range(1 << 9, 1 << 15)->Unit(benchmark::kMillisecond);
+BENCHMARK_MAIN();
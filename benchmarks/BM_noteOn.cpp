@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "Synth.h"
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+// Note-ons on instruments with many regions. Each note-on is followed by an
+// all sound off, so that the voices are available for the next one.
+class ManyRegions : public benchmark::Fixture {
+public:
+    void SetUp(const ::benchmark::State& state)
+    {
+        const auto numRegions = static_cast<int>(state.range(0));
+        file = fs::temp_directory_path() / "sfizz_bm_noteOn.sfz";
+        std::ofstream output { file.string() };
+        writeRegions(output, numRegions);
+        output.close();
+        synth.loadSfzFile(file);
+    }
+
+    void TearDown(const ::benchmark::State& state [[maybe_unused]])
+    {
+        fs::remove(file);
+    }
+
+    virtual void writeRegions(std::ostream& output, int numRegions)
+    {
+        // Velocity layers of 4 round-robin regions on every key
+        const int numLayers = std::max(1, numRegions / (4 * 128));
+        for (int key = 0; key < 128; ++key) {
+            for (int layer = 0; layer < numLayers; ++layer) {
+                const auto loVel = layer * 128 / numLayers;
+                const auto hiVel = (layer + 1) * 128 / numLayers - 1;
+                output << "<group> sample=*sine key=" << key << " lovel=" << loVel
+                       << " hivel=" << hiVel << " seq_length=4 volume_oncc7=-6\n";
+                for (int position = 1; position <= 4; ++position)
+                    output << "<region> seq_position=" << position << "\n";
+            }
+        }
+    }
+
+    sfz::Synth synth;
+    fs::path file;
+    std::mt19937 gen { 42 };
+    std::uniform_int_distribution<int> noteDistribution { 0, 127 };
+    std::uniform_int_distribution<int> velocityDistribution { 1, 127 };
+};
+
+// The same, with a single sequence of round-robins on every key, so that all
+// the regions of a key are candidates for each of its note-ons.
+class LongSequences : public ManyRegions {
+public:
+    void writeRegions(std::ostream& output, int numRegions) override
+    {
+        const int sequenceLength = std::min(255, std::max(1, numRegions / 128));
+        for (int key = 0; key < 128; ++key) {
+            output << "<group> sample=*sine key=" << key << " seq_length="
+                   << sequenceLength << " volume_oncc7=-6\n";
+            for (int position = 1; position <= sequenceLength; ++position)
+                output << "<region> seq_position=" << position << "\n";
+        }
+    }
+};
+
+// Note-ons with all the voices busy, as in a fast drum roll. Each note-on
+// steals the voice that has been releasing the longest, and is released right
+// away so that its voice can be stolen in turn.
+class FullPolyphony : public benchmark::Fixture {
+public:
+    void SetUp(const ::benchmark::State& state)
+    {
+        const auto numVoices = static_cast<int>(state.range(0));
+        file = fs::temp_directory_path() / "sfizz_bm_fullPolyphony.sfz";
+        std::ofstream output { file.string() };
+        output << "<region> sample=*sine amplitude=0 ampeg_release=10\n";
+        output.close();
+        synth.setNumVoices(numVoices);
+        synth.loadSfzFile(file);
+
+        sfz::AudioBuffer<float> buffer { 2, sfz::config::defaultSamplesPerBlock };
+        for (int i = 0; i < numVoices; ++i)
+            playNote(i % 128);
+        synth.renderBlock(buffer);
+    }
+
+    void TearDown(const ::benchmark::State& state [[maybe_unused]])
+    {
+        fs::remove(file);
+    }
+
+    void playNote(int note)
+    {
+        synth.noteOn(0, note, 127);
+        // Late enough in the block for the voice to release rather than stop
+        synth.noteOff(sfz::config::defaultSamplesPerBlock - 1, note, 0);
+    }
+
+    sfz::Synth synth;
+    fs::path file;
+    std::mt19937 gen { 42 };
+    std::uniform_int_distribution<int> noteDistribution { 0, 127 };
+};
+
+BENCHMARK_DEFINE_F(ManyRegions, NoteOn)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        synth.noteOn(0, noteDistribution(gen), static_cast<uint8_t>(velocityDistribution(gen)));
+        synth.cc(0, sfz::config::allSoundOffCC, 0);
+    }
+    state.counters["Regions"] = synth.getNumRegions();
+}
+
+BENCHMARK_DEFINE_F(LongSequences, NoteOn)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        synth.noteOn(0, noteDistribution(gen), static_cast<uint8_t>(velocityDistribution(gen)));
+        synth.cc(0, sfz::config::allSoundOffCC, 0);
+    }
+    state.counters["Regions"] = synth.getNumRegions();
+}
+
+BENCHMARK_DEFINE_F(FullPolyphony, NoteOn)(benchmark::State& state) {
+    for (auto _ : state)
+        playNote(noteDistribution(gen));
+    state.counters["Voices"] = synth.getNumActiveVoices();
+}
+
+BENCHMARK_REGISTER_F(ManyRegions, NoteOn)->RangeMultiplier(4)->Range(1 << 9, 1 << 15);
+BENCHMARK_REGISTER_F(LongSequences, NoteOn)->RangeMultiplier(4)->Range(1 << 9, 1 << 15);
+BENCHMARK_REGISTER_F(FullPolyphony, NoteOn)->RangeMultiplier(4)->Range(16, sfz::config::maxVoices);
+BENCHMARK_MAIN();
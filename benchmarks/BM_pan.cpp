@@ -63,17 +63,39 @@ BENCHMARK_DEFINE_F(PanArray, SIMD)(benchmark::State& state) {
 BENCHMARK_DEFINE_F(PanArray, BlockOps)(benchmark::State& state) {
     for (auto _ : state)
     {
+        // The gains are applied out of place, so that the channels do not
+        // decay into denormals over the iterations
         sfz::fill<float>(span2, 1.0f);
-        sfz::add<float>(span1, span2);
+        sfz::add<float>(pan, span2);
         sfz::applyGain<float>(piFour<float>, span2);
         sfz::cos<float>(span2, span1);
         sfz::sin<float>(span2, span2);
-        sfz::applyGain<float>(span1, absl::MakeSpan(left));
-        sfz::applyGain<float>(span2, absl::MakeSpan(right));
+        sfz::applyGain<float>(span1, left, span1);
+        sfz::applyGain<float>(span2, right, span2);
+    }
+}
+
+BENCHMARK_DEFINE_F(PanArray, TableScalar)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        sfz::panGains<float, false>(pan, span1, span2);
+        sfz::applyGain<float>(span1, left, span1);
+        sfz::applyGain<float>(span2, right, span2);
+    }
+}
+
+BENCHMARK_DEFINE_F(PanArray, TableSIMD)(benchmark::State& state) {
+    for (auto _ : state)
+    {
+        sfz::panGains<float, true>(pan, span1, span2);
+        sfz::applyGain<float>(span1, left, span1);
+        sfz::applyGain<float>(span2, right, span2);
     }
 }
 
 BENCHMARK_REGISTER_F(PanArray, Scalar)->RangeMultiplier(4)->Range(1 << 2, 1 << 12);
 BENCHMARK_REGISTER_F(PanArray, SIMD)->RangeMultiplier(4)->Range(1 << 2, 1 << 12);
 BENCHMARK_REGISTER_F(PanArray, BlockOps)->RangeMultiplier(4)->Range(1 << 2, 1 << 12);
+BENCHMARK_REGISTER_F(PanArray, TableScalar)->RangeMultiplier(4)->Range(1 << 2, 1 << 12);
+BENCHMARK_REGISTER_F(PanArray, TableSIMD)->RangeMultiplier(4)->Range(1 << 2, 1 << 12);
 BENCHMARK_MAIN();
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "Parser.h"
+#include <benchmark/benchmark.h>
+#include <fstream>
+
+// Parsing of large generated files, with a parser that only counts the opcodes
+class OpcodeCounter : public sfz::Parser {
+public:
+    size_t numOpcodes { 0 };
+protected:
+    void callback(absl::string_view header [[maybe_unused]], const std::vector<sfz::Opcode>& members) final
+    {
+        numOpcodes += members.size();
+    }
+};
+
+class LargeFile : public benchmark::Fixture {
+public:
+    void SetUp(const ::benchmark::State& state)
+    {
+        const auto numRegions = static_cast<int>(state.range(0));
+        file = fs::temp_directory_path() / "sfizz_bm_parser.sfz";
+        std::ofstream output { file.string() };
+        output << "#define $VOLUME -6\n"
+               << "#define $CUTOFF 2000\n"
+               << "<control> default_path=Samples/\n"
+               << "<global> ampeg_release=0.5 // Some comment\n";
+        for (int i = 0; i < numRegions; ++i) {
+            const int key = i % 128;
+            if (key == 0)
+                output << "<group> volume=$VOLUME cutoff=$CUTOFF fil_type=lpf_2p seq_length=4\n";
+            output << "<region> sample=Instrument Samples/sample_" << i << ".wav"
+                   << " key=" << key << " lovel=1 hivel=127 pitch_keycenter=" << key
+                   << " volume_oncc7=-6 amp_velcurve_1=0.5\n";
+        }
+        output.close();
+        fileSize = static_cast<int64_t>(fs::file_size(file));
+    }
+
+    void TearDown(const ::benchmark::State& state [[maybe_unused]])
+    {
+        fs::remove(file);
+    }
+
+    fs::path file;
+    int64_t fileSize { 0 };
+};
+
+BENCHMARK_DEFINE_F(LargeFile, Parse)(benchmark::State& state) {
+    OpcodeCounter parser;
+    for (auto _ : state)
+    {
+        parser.numOpcodes = 0;
+        parser.loadSfzFile(file);
+        benchmark::DoNotOptimize(parser.numOpcodes);
+    }
+    state.SetBytesProcessed(state.iterations() * fileSize);
+    state.counters["Opcodes"] = static_cast<double>(parser.numOpcodes);
+}
+
+BENCHMARK_REGISTER_F(LargeFile, Parse)->RangeMultiplier(8)->Range(1 << 9, 1 << 18)->Unit(benchmark::kMillisecond);
+BENCHMARK_MAIN();
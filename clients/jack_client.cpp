@@ -206,6 +206,8 @@ int main(int argc, char** argv)
     std::cout << "\tRegions: " << synth.getNumRegions() << '\n';
     std::cout << "\tCurves: " << synth.getNumCurves() << '\n';
     std::cout << "\tPreloadedSamples: " << synth.getNumPreloadedSamples() << '\n';
+    if (synth.getNumRegions() > 0)
+        std::cout << "\tBytesPerRegion: " << synth.getRegionsMemoryUsage() / static_cast<size_t>(synth.getNumRegions()) << '\n';
     std::cout << "==========" << '\n';
     std::cout << "Included files:" << '\n';
     for (auto& file : synth.getIncludedFiles())
@@ -34,6 +34,15 @@ if (CMAKE_SYSTEM_PROCESSOR MATCHES "^i.86$")
     endif()
 endif()
 
+# Batch the sample reads through io_uring when the kernel headers support it
+if (CMAKE_SYSTEM_NAME STREQUAL "Linux")
+    include (CheckSymbolExists)
+    check_symbol_exists (IORING_FEAT_FAST_POLL "linux/io_uring.h" SFIZZ_HAVE_IO_URING)
+    if (SFIZZ_HAVE_IO_URING)
+        add_compile_definitions(SFIZZ_IO_URING=1)
+    endif()
+endif()
+
 add_library(sfizz-sndfile INTERFACE)
 
 if (SFIZZ_USE_VCPKG OR CMAKE_CXX_COMPILER_ID MATCHES "MSVC")
@@ -233,6 +233,61 @@ SFIZZ_EXPORTED_API unsigned int sfizz_get_preload_size(sfizz_synth_t* synth);
  */
 SFIZZ_EXPORTED_API void sfizz_set_preload_size(sfizz_synth_t* synth, unsigned int preload_size);
 
+/**
+ * @brief      Sets the directory of the on-disk preload cache. The preloaded
+ *             data of the samples is kept there between sessions, which makes
+ *             loading the same instruments again faster. The cache is used
+ *             for the next loaded files.
+ *
+ * @param      synth      The synth
+ * @param[in]  directory  A null-terminated path to the cache directory, or
+ *                        NULL or an empty string to disable the cache
+ */
+SFIZZ_EXPORTED_API void sfizz_set_preload_cache_directory(sfizz_synth_t* synth, const char* directory);
+
+/**
+ * @brief      Sets the directory of the on-disk instrument cache. The regions
+ *             built from the SFZ files are kept there between sessions, so
+ *             that loading the same instruments again does not parse them.
+ *             The cache is used for the next loaded files.
+ *
+ * @param      synth      The synth
+ * @param[in]  directory  A null-terminated path to the cache directory, or
+ *                        NULL or an empty string to disable the cache
+ */
+SFIZZ_EXPORTED_API void sfizz_set_instrument_cache_directory(sfizz_synth_t* synth, const char* directory);
+
+/**
+ * @brief      Sets the memory budget of the preloaded data, in bytes. The
+ *             least recently used preloads are evicted to fit in the budget,
+ *             and their samples are then streamed from disk with some added
+ *             latency. A budget of 0, which is the default, disables the
+ *             eviction. The budget only applies without oversampling.
+ *
+ * @param      synth   The synth
+ * @param[in]  budget  The budget in bytes
+ */
+SFIZZ_EXPORTED_API void sfizz_set_preload_memory_budget(sfizz_synth_t* synth, size_t budget);
+
+/**
+ * @brief      Gets the memory budget of the preloaded data, in bytes.
+ *
+ * @param      synth  The synth
+ *
+ * @return     size_t the budget in bytes
+ */
+SFIZZ_EXPORTED_API size_t sfizz_get_preload_memory_budget(sfizz_synth_t* synth);
+
+/**
+ * @brief      Returns the number of notes that streamed their sample from
+ *             disk because its preloaded data was evicted.
+ *
+ * @param      synth  The synth
+ *
+ * @return     size_t the number of cold loads
+ */
+SFIZZ_EXPORTED_API size_t sfizz_get_num_cold_loads(sfizz_synth_t* synth);
+
 /**
  * @brief      Get the internal oversampling rate. This is the sampling rate of
  *             the engine, not the output or expected rate of the calling
@@ -265,6 +320,78 @@ SFIZZ_EXPORTED_API sfizz_oversampling_factor_t sfizz_get_oversampling_factor(sfi
  */
 SFIZZ_EXPORTED_API bool sfizz_set_oversampling_factor(sfizz_synth_t* synth, sfizz_oversampling_factor_t oversampling);
 
+/**
+ * @brief      Get the render oversampling factor.
+ *
+ * @param      synth  The synth
+ *
+ * @return     The render oversampling factor
+ */
+SFIZZ_EXPORTED_API sfizz_oversampling_factor_t sfizz_get_render_oversampling_factor(sfizz_synth_t* synth);
+/**
+ * @brief      Set the render oversampling factor. The voices then render at
+ *             this multiple of the sample rate, and their mix is downsampled
+ *             to the output rate.
+ *
+ *             Unlike the oversampling factor, the samples stay in memory at
+ *             their native rate: changing this value does not reload them or
+ *             increase the memory consumption, and costs some processing time
+ *             in the render path instead.
+ *
+ * @param      synth         The synth
+ * @param[in]  oversampling  The render oversampling factor
+ *
+ * @return     True if the oversampling factor was correct
+ */
+SFIZZ_EXPORTED_API bool sfizz_set_render_oversampling_factor(sfizz_synth_t* synth, sfizz_oversampling_factor_t oversampling);
+
+/**
+ * @brief      Set the interpolation quality of the sample playback, with the
+ *             values of the sample_quality opcode: 1 is linear, 2 is cubic
+ *             Hermite and 3 is a windowed sinc. The regions which set
+ *             sample_quality keep their own quality.
+ *
+ *             The higher qualities reduce the aliasing of transposed samples
+ *             without increasing the memory consumption, and cost some
+ *             processing time in the render path instead.
+ *
+ * @param      synth    The synth
+ * @param[in]  quality  The interpolation quality
+ *
+ * @return     True if the quality was correct
+ */
+SFIZZ_EXPORTED_API bool sfizz_set_sample_quality(sfizz_synth_t* synth, int quality);
+
+/**
+ * @brief      Get the interpolation quality of the sample playback.
+ *
+ * @param      synth  The synth
+ *
+ * @return     The interpolation quality
+ */
+SFIZZ_EXPORTED_API int sfizz_get_sample_quality(sfizz_synth_t* synth);
+
+/**
+ * @brief      Sets the number of worker threads that render the voices in
+ *             parallel with the audio thread. The workers run with a
+ *             real-time priority where the system allows it. With 0 threads,
+ *             which is the default, all the voices are rendered in the
+ *             calling thread.
+ *
+ * @param      synth        The synth
+ * @param[in]  num_threads  The number of worker threads
+ */
+SFIZZ_EXPORTED_API void sfizz_set_num_render_threads(sfizz_synth_t* synth, int num_threads);
+
+/**
+ * @brief      Gets the number of worker threads that render the voices.
+ *
+ * @param      synth  The synth
+ *
+ * @return     int the number of worker threads
+ */
+SFIZZ_EXPORTED_API int sfizz_get_num_render_threads(sfizz_synth_t* synth);
+
 /**
  * @brief      Set the global instrument volume.
  *
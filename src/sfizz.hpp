@@ -197,6 +197,60 @@ public:
      */
     int getOversamplingFactor() const noexcept;
 
+    /**
+     * @brief Set the render oversampling factor. The voices then render at
+     * this multiple of the sample rate from the samples at their native rate,
+     * and their mix is downsampled to the output rate. Unlike the
+     * oversampling factor, this keeps the memory use of the samples and does
+     * not reload them. This will disable the callback and kill all the voices.
+     *
+     * @param factor
+     * @return true if the factor was correct
+     */
+    bool setRenderOversamplingFactor(int factor) noexcept;
+
+    /**
+     * @brief get the current render oversampling factor
+     *
+     * @return int
+     */
+    int getRenderOversamplingFactor() const noexcept;
+
+    /**
+     * @brief Set the interpolation quality of the sample playback, with the
+     * values of the sample_quality opcode: 1 is linear, 2 is cubic Hermite
+     * and 3 is a windowed sinc. The regions which set sample_quality keep
+     * their own quality. This will disable the callback.
+     *
+     * @param quality
+     * @return true if the quality was correct
+     */
+    bool setSampleQuality(int quality) noexcept;
+
+    /**
+     * @brief Get the current interpolation quality of the sample playback
+     *
+     * @return int
+     */
+    int getSampleQuality() const noexcept;
+
+    /**
+     * @brief Set the number of worker threads that render the voices in
+     * parallel with the audio thread. With 0 threads, which is the default,
+     * all the voices are rendered on the audio thread. This will disable the
+     * callback.
+     *
+     * @param numThreads
+     */
+    void setNumRenderThreads(int numThreads) noexcept;
+
+    /**
+     * @brief Get the number of worker threads that render the voices
+     *
+     * @return int
+     */
+    int getNumRenderThreads() const noexcept;
+
     /**
      * @brief Set the preloaded file size. This will disable the callback.
      *
@@ -211,6 +265,51 @@ public:
      */
     uint32_t getPreloadSize() const noexcept;
 
+    /**
+     * @brief Set the directory of the on-disk preload cache. The preloaded
+     * data of the samples is kept there between sessions, which makes loading
+     * the same instruments again faster. An empty path disables the cache,
+     * which is the default.
+     *
+     * @param directory
+     */
+    void setPreloadCacheDirectory(const std::string& directory);
+
+    /**
+     * @brief Set the directory of the on-disk instrument cache. The regions
+     * built from the SFZ files are kept there between sessions, so that
+     * loading the same instruments again does not parse them. An empty path
+     * disables the cache, which is the default.
+     *
+     * @param directory
+     */
+    void setInstrumentCacheDirectory(const std::string& directory);
+
+    /**
+     * @brief Set the memory budget of the preloaded data, in bytes. The least
+     * recently used preloads are evicted to fit in the budget, and their
+     * samples are then streamed from disk with some added latency. A budget
+     * of 0, which is the default, disables the eviction.
+     *
+     * @param budget
+     */
+    void setPreloadMemoryBudget(size_t budget) noexcept;
+
+    /**
+     * @brief Get the memory budget of the preloaded data, in bytes.
+     *
+     * @return size_t
+     */
+    size_t getPreloadMemoryBudget() const noexcept;
+
+    /**
+     * @brief Get the number of notes that streamed their sample from disk
+     * because its preloaded data was evicted.
+     *
+     * @return size_t
+     */
+    size_t getNumColdLoads() const noexcept;
+
     /**
      * @brief      Gets the number of allocated buffers.
      *
@@ -96,6 +96,47 @@ Type ADSREnvelope<Type>::getNextValue() noexcept
     }
 }
 
+template <class Type>
+absl::optional<Type> ADSREnvelope<Type>::getBlockOrConstant(absl::Span<Type> output) noexcept
+{
+    // A finished envelope stays at 0, even through the release it keeps pending
+    if (currentState == State::Done)
+        return currentValue;
+
+    const auto numFrames = static_cast<int>(output.size());
+    if (shouldRelease && releaseDelay <= numFrames) {
+        getBlock(output);
+        return {};
+    }
+
+    switch (currentState) {
+    case State::Delay:
+        if (delay < numFrames) {
+            getBlock(output);
+            return {};
+        }
+        delay -= numFrames;
+        break;
+    case State::Hold:
+        if (hold < numFrames) {
+            getBlock(output);
+            return {};
+        }
+        hold -= numFrames;
+        break;
+    case State::Sustain:
+        break;
+    default:
+        getBlock(output);
+        return {};
+    }
+
+    if (shouldRelease)
+        releaseDelay -= numFrames;
+
+    return currentValue;
+}
+
 template <class Type>
 void ADSREnvelope<Type>::getBlock(absl::Span<Type> output) noexcept
 {
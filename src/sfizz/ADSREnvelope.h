@@ -6,6 +6,7 @@
 
 #pragma once
 #include "LeakDetector.h"
+#include <absl/types/optional.h>
 #include <absl/types/span.h>
 namespace sfz {
 /**
@@ -45,6 +46,16 @@ public:
      * @param output
      */
     void getBlock(absl::Span<Type> output) noexcept;
+    /**
+     * @brief Get a block of values like `getBlock`, unless the envelope stays
+     * at the same value over the whole block, as in the sustain stage. In this
+     * case the output is left untouched and the value is returned instead, so
+     * that it can be applied as a scalar.
+     *
+     * @param output
+     * @return absl::optional<Type> the value if the envelope is constant
+     */
+    absl::optional<Type> getBlockOrConstant(absl::Span<Type> output) noexcept;
     /**
      * @brief Start the envelope release after a delay.
      *
@@ -6,7 +6,10 @@
 
 #pragma once
 #include "LeakDetector.h"
-#include <map>
+#include "absl/algorithm/container.h"
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace sfz {
 /**
@@ -15,11 +18,15 @@ namespace sfz {
  * that are specified in the SFZ file rather than a gazillion of dummy "disabled" modifiers. The default
  * value is set on construction.
  *
+ * Regions only specify a handful of CCs, if any, so the elements are held in a flat vector sorted by
+ * index. An empty map does not allocate, and a lookup is a binary search in a single block of memory.
+ *
  * @tparam ValueType The type held in the map
  */
 template <class ValueType>
 class CCMap {
 public:
+    using Element = std::pair<int, ValueType>;
     CCMap() = delete;
     /**
      * @brief Construct a new CCMap object with the specified default value.
@@ -42,7 +49,7 @@ public:
      */
     const ValueType& getWithDefault(int index) const noexcept
     {
-        auto it = container.find(index);
+        auto it = find(index);
         if (it == container.end()) {
             return defaultValue;
         } else {
@@ -58,9 +65,10 @@ public:
      */
     ValueType& operator[](const int& key) noexcept
     {
-        if (!contains(key))
-            container.emplace(key, defaultValue);
-        return container.operator[](key);
+        auto it = lowerBound(key);
+        if (it == container.end() || it->first != key)
+            it = container.emplace(it, key, defaultValue);
+        return it->second;
     }
 
     /**
@@ -76,7 +84,13 @@ public:
      * @param index
      * @return const ValueType&
      */
-    const ValueType& at(int index) const { return container.at(index); }
+    const ValueType& at(int index) const
+    {
+        auto it = find(index);
+        if (it == container.end())
+            throw std::out_of_range("CCMap::at");
+        return it->second;
+    }
     /**
      * @brief Returns true if the container containers an element at index
      *
@@ -84,12 +98,36 @@ public:
      * @return true
      * @return false
      */
-    bool contains(int index) const noexcept { return container.find(index) != container.end(); }
-    typename std::map<int, ValueType>::iterator begin() { return container.begin(); }
-    typename std::map<int, ValueType>::iterator end() { return container.end(); }
+    bool contains(int index) const noexcept { return find(index) != container.end(); }
+    /**
+     * @brief Get the memory allocated for the elements, in bytes
+     *
+     * @return size_t
+     */
+    size_t getAllocatedBytes() const noexcept { return container.capacity() * sizeof(Element); }
+    /**
+     * @brief Read or write the elements through an archive of the instrument cache
+     *
+     * @param archive
+     */
+    template <class Archive>
+    void serialize(Archive& archive) { archive(container); }
+    typename std::vector<Element>::iterator begin() { return container.begin(); }
+    typename std::vector<Element>::iterator end() { return container.end(); }
+    typename std::vector<Element>::const_iterator begin() const { return container.begin(); }
+    typename std::vector<Element>::const_iterator end() const { return container.end(); }
 private:
+    typename std::vector<Element>::iterator lowerBound(int index) noexcept
+    {
+        return absl::c_lower_bound(container, index, [](const Element& element, int index) { return element.first < index; });
+    }
+    typename std::vector<Element>::const_iterator find(int index) const noexcept
+    {
+        auto it = absl::c_lower_bound(container, index, [](const Element& element, int index) { return element.first < index; });
+        return (it != container.end() && it->first == index) ? it : container.end();
+    }
     const ValueType defaultValue;
-    std::map<int, ValueType> container;
+    std::vector<Element> container;
     LEAK_DETECTOR(CCMap);
 };
 }
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "CacheFile.h"
+#include "Debug.h"
+#include "absl/strings/str_cat.h"
+#include <fstream>
+#include <functional>
+#include <thread>
+
+bool sfz::getFileStatus(const fs::path& file, FileStatus& status) noexcept
+{
+    std::error_code ec;
+    status.size = static_cast<uint64_t>(fs::file_size(file, ec));
+    if (ec)
+        return false;
+
+    status.modificationTime = static_cast<int64_t>(fs::last_write_time(file, ec).time_since_epoch().count());
+    return !ec;
+}
+
+void sfz::createCacheDirectory(const fs::path& directory) noexcept
+{
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec) {
+        DBG("[sfizz] Could not create the cache directory " << directory.string() << ": " << ec.message());
+    }
+}
+
+std::string sfz::cacheEntryName(const fs::path& file)
+{
+    const auto hash = std::hash<std::string>{}(file.string());
+    return absl::StrCat(absl::Hex(hash, absl::kZeroPad16));
+}
+
+bool sfz::writeCacheEntry(const fs::path& target, absl::FunctionRef<void(std::ostream&)> write) noexcept
+{
+    auto temporary = target;
+    temporary += absl::StrCat(".", std::hash<std::thread::id>{}(std::this_thread::get_id()), ".tmp");
+    {
+        std::ofstream output { temporary.string(), std::ios::binary | std::ios::trunc };
+        write(output);
+        if (!output) {
+            DBG("[sfizz] Could not write the cache entry " << target.string());
+            output.close();
+            std::error_code ec;
+            fs::remove(temporary, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(temporary, target, ec);
+    if (ec) {
+        fs::remove(temporary, ec);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "ghc/fs_std.hpp"
+#include "absl/functional/function_ref.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace sfz {
+/**
+ * Helpers shared by the on-disk caches. The cache entries are only meant to be
+ * read back on the machine that wrote them, so they hold values as they are in
+ * memory; each cache checks that the entries it reads match its own layout.
+ */
+
+/**
+ * @brief The size and modification time of a file, which the cache entries
+ * keep to tell whether they are still valid for the file.
+ */
+struct FileStatus
+{
+    uint64_t size { 0 };
+    int64_t modificationTime { 0 };
+};
+
+/**
+ * @brief Get the status of a file
+ *
+ * @param file
+ * @param status
+ * @return true if the file exists and could be read
+ */
+bool getFileStatus(const fs::path& file, FileStatus& status) noexcept;
+
+/**
+ * @brief Create the directory of a cache if needed
+ *
+ * @param directory
+ */
+void createCacheDirectory(const fs::path& directory) noexcept;
+
+/**
+ * @brief Get the base name of the entry of a file in a cache, without its
+ * extension
+ *
+ * @param file
+ * @return std::string
+ */
+std::string cacheEntryName(const fs::path& file);
+
+/**
+ * @brief Write a cache entry through a temporary file that is then renamed,
+ * so that a reader never maps a partial entry.
+ *
+ * @param target the path of the entry
+ * @param write writes the content of the entry in a stream
+ * @return true if the entry was written
+ */
+bool writeCacheEntry(const fs::path& target, absl::FunctionRef<void(std::ostream&)> write) noexcept;
+}
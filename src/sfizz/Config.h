@@ -21,6 +21,16 @@ enum class Oversampling: int {
     x8 = 8
 };
 
+/**
+ * @brief Interpolation used to read the samples at a pitch ratio. The values
+ * follow the sample_quality opcode.
+ */
+enum class InterpolationQuality: int {
+    Linear = 1,
+    Hermite = 2,
+    Sinc = 3
+};
+
 namespace config {
     constexpr float defaultSampleRate { 48000 };
     constexpr int defaultSamplesPerBlock { 1024 };
@@ -30,6 +40,8 @@ namespace config {
     constexpr bool loggingEnabled { false };
     constexpr size_t numChannels { 2 };
     constexpr int numBackgroundThreads { 4 };
+    constexpr int numRenderThreads { 0 };
+    constexpr InterpolationQuality defaultInterpolationQuality { InterpolationQuality::Linear };
     constexpr int numVoices { 64 };
     constexpr int maxVoices { 256 };
     constexpr int maxFilePromises { maxVoices * 2 };
@@ -50,6 +62,10 @@ namespace config {
     constexpr float voiceStealingThreshold { 0.00001f };
     constexpr uint8_t numCCs { 143 };
     constexpr int chunkSize { 1024 };
+    constexpr int numStreamingChunks { 32 };
+    constexpr int ioChunkSize { 16 * chunkSize };
+    constexpr int ioQueueDepth { 64 };
+    constexpr int maxPromisesPerBatch { 16 };
     constexpr float defaultAmpEGRelease { 0.02f };
 } // namespace config
 
@@ -71,9 +87,13 @@ namespace SIMDConfig {
     constexpr bool multiplyAdd { false };
     constexpr bool copy { false };
     constexpr bool pan { true };
+    constexpr bool panGains { true };
     constexpr bool cumsum { true };
     constexpr bool diff { false };
     constexpr bool sfzInterpolationCast { true };
+    constexpr bool interpolateLinear { true };
+    constexpr bool interpolateHermite { true };
+    constexpr bool interpolateSinc { true };
     constexpr bool mean { false };
     constexpr bool meanSquared { false };
     constexpr bool upsampling { true };
@@ -52,6 +52,7 @@ namespace Default
 	constexpr Range<uint32_t> sampleCountRange { 0, std::numeric_limits<uint32_t>::max() };
 	constexpr SfzLoopMode loopMode { SfzLoopMode::no_loop };
 	constexpr Range<uint32_t> loopRange { 0, std::numeric_limits<uint32_t>::max() };
+	constexpr Range<int> sampleQualityRange { 0, 10 };
 
     // Instrument setting: voice lifecycle
 	constexpr uint32_t group { 0 };
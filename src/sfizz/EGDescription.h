@@ -149,6 +149,18 @@ struct EGDescription
     {
         return Default::egPercentRange.clamp(ccSwitchedValue(ccValues, ccSustain, sustain) + normalizeVelocity(velocity)*vel2sustain);
     }
+    /**
+     * @brief Read or write the parameters through an archive of the instrument cache
+     *
+     * @param archive
+     */
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(attack, decay, delay, hold, release, start, sustain, depth);
+        archive(vel2attack, vel2decay, vel2delay, vel2hold, vel2release, vel2sustain, vel2depth);
+        archive(ccAttack, ccDecay, ccDelay, ccHold, ccRelease, ccStart, ccSustain);
+    }
     LEAK_DETECTOR(EGDescription);
 };
 
@@ -105,6 +105,27 @@ void EventEnvelope<Type>::getQuantizedBlock(absl::Span<Type> output, Type)
     prepareEvents(output.size());
 }
 
+template <class Type>
+absl::optional<Type> EventEnvelope<Type>::getBlockOrConstant(absl::Span<Type> output)
+{
+    if (resetEvents)
+        clear();
+
+    // Any event moving away from the current value makes the block vary,
+    // including the ones past the block which are brought back into it
+    const bool constant = absl::c_all_of(events, [this](const std::pair<int, Type>& event) {
+        return event.second == currentValue;
+    });
+
+    if (!constant) {
+        getBlock(output);
+        return {};
+    }
+
+    resetEvents = true;
+    return currentValue;
+}
+
 template <class Type>
 void LinearEnvelope<Type>::getBlock(absl::Span<Type> output)
 {
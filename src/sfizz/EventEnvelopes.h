@@ -7,6 +7,7 @@
 #pragma once
 #include "Config.h"
 #include "LeakDetector.h"
+#include <absl/types/optional.h>
 #include <absl/types/span.h>
 #include <functional>
 #include <type_traits>
@@ -89,6 +90,16 @@ public:
      * @param quantizationStep
      */
     virtual void getQuantizedBlock(absl::Span<Type> output, Type quantizationStep);
+    /**
+     * @brief Get a block of interpolated values like `getBlock`, unless the
+     * envelope stays at the same value over the whole block. In this case the
+     * output is left untouched and the value is returned instead, so that it
+     * can be applied as a scalar.
+     *
+     * @param output
+     * @return absl::optional<Type> the value if the envelope is constant
+     */
+    absl::optional<Type> getBlockOrConstant(absl::Span<Type> output);
 protected:
     std::vector<std::pair<int, Type>> events;
     Type currentValue { 0.0 };
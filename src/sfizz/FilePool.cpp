@@ -30,8 +30,14 @@
 #include "Debug.h"
 #include "Oversampler.h"
 #include "AtomicGuard.h"
+#include "IOBackend.h"
+#include "PCMFile.h"
+#include "PreloadCache.h"
 #include "absl/types/span.h"
 #include "absl/strings/match.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <memory>
 #include <sndfile.hh>
 #include <thread>
@@ -87,8 +93,112 @@ void streamFromFile(SndfileHandle& sndFile, uint32_t numFrames, sfz::Oversamplin
     oversampler.stream(*baseBuffer, output, filledFrames);
 }
 
-sfz::FilePool::FilePool(sfz::Logger& logger)
-: logger(logger)
+/**
+ * @brief Read the preloaded frames of a file. The 16-bit PCM files keep their
+ * width unless they are oversampled.
+ */
+sfz::SampleBufferPtr readPreloadFromFile(SndfileHandle& sndFile, uint32_t numFrames, sfz::Oversampling factor)
+{
+    if (factor == sfz::Oversampling::x1 && (sndFile.format() & SF_FORMAT_SUBMASK) == SF_FORMAT_PCM_16) {
+        sfz::AudioBuffer<int16_t> frames;
+        readBaseFile(sndFile, frames, numFrames);
+        return std::make_shared<sfz::SampleBuffer>(std::move(frames));
+    }
+
+    return std::make_shared<sfz::SampleBuffer>(std::move(*readFromFile<float>(sndFile, numFrames, factor)));
+}
+
+constexpr uint32_t sfz::FileStream::ringFrames;
+
+namespace {
+void prepareRing(sfz::FileStream& stream, size_t numChannels)
+{
+    if (stream.ring.getNumChannels() != numChannels || stream.ring.getNumFrames() != sfz::FileStream::ringFrames) {
+        stream.ring.reset();
+        stream.ring.addChannels(numChannels);
+        stream.ring.resize(sfz::FileStream::ringFrames);
+    }
+}
+
+/**
+ * @brief Walk the segments of the file to load in the free chunks of a stream.
+ * Each segment stops at the loop end and at the end of the ring. The callback
+ * receives the file position, ring position and size of each segment, along
+ * with the position to publish once the segment and all the previous ones are
+ * loaded (or 0 if the segment does not end a chunk).
+ */
+template <class Callback>
+void forEachStreamSegment(const sfz::FileStream& stream, Callback&& callback)
+{
+    auto end = stream.endPosition.load();
+    const auto limit = stream.readPosition.load() + sfz::FileStream::ringFrames;
+    while (end + sfz::config::chunkSize <= limit && (stream.looping || end < stream.numFrames)) {
+        const auto chunkFrames = stream.looping ? sfz::config::chunkSize : min<uint32_t>(sfz::config::chunkSize, stream.numFrames - end);
+        auto position = end;
+        auto remaining = chunkFrames;
+        while (remaining > 0) {
+            const auto filePosition = stream.filePosition(position);
+            const auto ringPosition = (position - stream.startPosition) % sfz::FileStream::ringFrames;
+            auto frames = min(remaining, sfz::FileStream::ringFrames - ringPosition);
+            if (stream.looping)
+                frames = min(frames, stream.loopEnd + 1 - filePosition);
+
+            remaining -= frames;
+            callback(filePosition, ringPosition, frames, remaining == 0 ? end + chunkFrames : 0);
+            position += frames;
+        }
+        end += chunkFrames;
+    }
+}
+
+absl::optional<sfz::FilePool::FileInformation> readFileInformation(SndfileHandle& sndFile, absl::string_view filename [[maybe_unused]]) noexcept
+{
+    if (sndFile.channels() != 1 && sndFile.channels() != 2) {
+        DBG("Missing logic for " << sndFile.channels() << " channels, discarding sample " << filename);
+        return {};
+    }
+
+    sfz::FilePool::FileInformation returnedValue;
+    returnedValue.end = static_cast<uint32_t>(sndFile.frames()) - 1;
+    returnedValue.sampleRate = static_cast<double>(sndFile.samplerate());
+    returnedValue.numChannels = sndFile.channels();
+
+    SF_INSTRUMENT instrumentInfo;
+    sndFile.command(SFC_GET_INSTRUMENT, &instrumentInfo, sizeof(instrumentInfo));
+    if (instrumentInfo.loop_count > 0) {
+        returnedValue.loopBegin = instrumentInfo.loops[0].start;
+        returnedValue.loopEnd = min(returnedValue.end, instrumentInfo.loops[0].end - 1);
+    }
+
+    return returnedValue;
+}
+
+struct BatchRead
+{
+    size_t job;
+    uint64_t offset;
+    uint32_t frame;
+    uint32_t numFrames;
+    uint32_t publishedPosition;
+    bool done;
+};
+
+struct BatchJob
+{
+    sfz::FilePromisePtr promise {};
+    sfz::ReadableFile file {};
+    int fileDescriptor { -1 };
+    sfz::AudioBuffer<float>* output { nullptr };
+    std::vector<size_t> reads {};
+    size_t nextToPublish { 0 };
+    size_t numDone { 0 };
+    bool finished { false };
+    std::chrono::time_point<std::chrono::high_resolution_clock> startTime {};
+};
+}
+
+sfz::FilePool::FilePool(sfz::Logger& logger, const SampleTable& sampleTable)
+: logger(logger), sampleTable(&sampleTable)
 {
     for (int i = 0; i < config::numBackgroundThreads; ++i)
         threadPool.emplace_back( &FilePool::loadingThread, this );
@@ -97,18 +207,26 @@ sfz::FilePool::FilePool(sfz::Logger& logger)
 
     for (int i = 0; i < config::maxFilePromises; ++i)
         emptyPromises.push_back(std::make_shared<FilePromise>());
+
+    promiseHeap.reserve(config::maxFilePromises);
+    temporaryFilePromises.reserve(config::maxFilePromises);
+    promisesToClear.reserve(config::maxFilePromises);
 }
 
 sfz::FilePool::~FilePool()
 {
     quitThread = true;
+    for (int i = 0; i < config::numBackgroundThreads; ++i)
+        loadingSemaphore.post();
+    clearingSemaphore.post();
+
     for (auto& thread: threadPool)
         thread.join();
 }
 
-bool sfz::FilePool::checkSample(std::string& filename) const noexcept
+bool sfz::FilePool::checkSample(std::string& filename, const fs::path& directory) const noexcept
 {
-    fs::path path { rootDirectory / filename };
+    fs::path path { directory / filename };
     std::error_code ec;
     if (fs::exists(path, ec))
         return true;
@@ -155,7 +273,7 @@ bool sfz::FilePool::checkSample(std::string& filename) const noexcept
         path /= it->path().filename();
     }
 
-    const auto newPath = fs::relative(path, rootDirectory, ec);
+    const auto newPath = fs::relative(path, directory, ec);
     if (ec) {
         DBG("Error extracting the new relative path for " << filename << " (Error code: " << ec.message() << ")");
         return false;
@@ -169,102 +287,449 @@ bool sfz::FilePool::checkSample(std::string& filename) const noexcept
 absl::optional<sfz::FilePool::FileInformation> sfz::FilePool::getFileInformation(const std::string& filename) noexcept
 {
     fs::path file { rootDirectory / filename };
-
     SndfileHandle sndFile(file.string().c_str());
-    if (sndFile.channels() != 1 && sndFile.channels() != 2) {
-        DBG("Missing logic for " << sndFile.channels() << " channels, discarding sample " << filename);
-        return {};
+    return readFileInformation(sndFile, filename);
+}
+
+bool sfz::FilePool::preloadFile(SampleId sample, uint32_t maxOffset) noexcept
+{
+    const PreloadRequest request { sample, maxOffset };
+    return preloadFiles({ &request, 1 }).front().has_value();
+}
+
+std::vector<absl::optional<sfz::FilePool::FileInformation>> sfz::FilePool::preloadFiles(absl::Span<const PreloadRequest> requests) noexcept
+{
+    return addPreloadedFiles(requests, readPreloadedFiles(requests));
+}
+
+std::vector<absl::optional<sfz::PreloadedFileHandle>> sfz::FilePool::readPreloadedFiles(absl::Span<const PreloadRequest> requests) const noexcept
+{
+    return readPreloadedFiles(requests, *sampleTable, rootDirectory);
+}
+
+std::vector<absl::optional<sfz::PreloadedFileHandle>> sfz::FilePool::readPreloadedFiles(absl::Span<const PreloadRequest> requests,
+    const SampleTable& table, const fs::path& directory) const noexcept
+{
+    std::vector<absl::optional<PreloadedFileHandle>> preloaded (requests.size());
+
+    std::atomic<size_t> nextRequest { 0 };
+    const auto preloadWorker = [&]() {
+        for (size_t index = nextRequest++; index < requests.size(); index = nextRequest++) {
+            const auto& filename = table.getPath(requests[index].sample);
+            fs::path file { directory / filename };
+            const auto maxFramesToLoad = [&]() {
+                if (preloadSize == 0)
+                    return std::numeric_limits<uint32_t>::max();
+                else
+                    return requests[index].maxOffset + preloadSize;
+            }();
+
+            if (preloadCache) {
+                if (auto entry = preloadCache->load(file, oversamplingFactor, maxFramesToLoad)) {
+                    preloaded[index] = std::move(entry);
+                    continue;
+                }
+            }
+
+            std::error_code ec;
+            const auto modificationTime = fs::last_write_time(file, ec);
+            ReadableFile readable { file };
+            if (ec || !readable)
+                continue;
+
+            // libsndfile reads from the same descriptor, which is left at the
+            // start of the file by the layout probe
+            const auto pcmLayout = readPCMLayout(readable);
+            SndfileHandle sndFile(readable.descriptor(), false);
+            const auto information = readFileInformation(sndFile, filename);
+            if (!information)
+                continue;
+
+            // FIXME: Large offsets will require large preloading; is this OK in practice? Apparently sforzando does the same
+            const auto frames = static_cast<uint32_t>(sndFile.frames());
+            const auto framesToLoad = min(frames, maxFramesToLoad);
+            preloaded[index] = PreloadedFileHandle {
+                readPreloadFromFile(sndFile, framesToLoad, oversamplingFactor),
+                static_cast<float>(oversamplingFactor) * sndFile.samplerate(),
+                std::make_shared<FileData>(oversamplingFactor),
+                frames * static_cast<uint32_t>(oversamplingFactor),
+                pcmLayout,
+                *information,
+                modificationTime
+            };
+
+            if (preloadCache)
+                preloadCache->store(file, oversamplingFactor, *preloaded[index]);
+        }
+    };
+
+    const auto numWorkers = min(requests.size(), static_cast<size_t>(max(1u, std::thread::hardware_concurrency())));
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < numWorkers; ++i)
+        workers.emplace_back(preloadWorker);
+    preloadWorker();
+    for (auto& worker : workers)
+        worker.join();
+
+    return preloaded;
+}
+
+std::vector<absl::optional<sfz::FilePool::FileInformation>> sfz::FilePool::addPreloadedFiles(absl::Span<const PreloadRequest> requests,
+    std::vector<absl::optional<PreloadedFileHandle>>&& preloaded) noexcept
+{
+    ASSERT(requests.size() == preloaded.size());
+    std::vector<absl::optional<FileInformation>> information (requests.size());
+    {
+        std::lock_guard<std::mutex> lock { preloadMutex };
+        for (size_t index = 0; index < requests.size(); ++index) {
+            if (!preloaded[index])
+                continue;
+
+            information[index] = preloaded[index]->information;
+            const auto existing = preloadedFiles.find(requests[index].sample);
+            if (existing == preloadedFiles.end()) {
+                preloaded[index]->filename = sampleTable->getPath(requests[index].sample);
+                preloadedFiles.insert_or_assign(requests[index].sample, std::move(*preloaded[index]));
+                continue;
+            }
+
+            // Promises may share the data of the existing entry, so only its preload is updated
+            auto& handle = existing->second;
+            if (preloaded[index]->preloadedData->getNumFrames() > handle.preloadedData->getNumFrames()) {
+                handle.preloadedData = std::move(preloaded[index]->preloadedData);
+                handle.evictedFrames = 0;
+            }
+        }
     }
 
-    FileInformation returnedValue;
-    returnedValue.end = static_cast<uint32_t>(sndFile.frames()) - 1;
-    returnedValue.sampleRate = static_cast<double>(sndFile.samplerate());
-    returnedValue.numChannels = sndFile.channels();
+    enforceMemoryBudget();
+    return information;
+}
 
-    SF_INSTRUMENT instrumentInfo;
-    sndFile.command(SFC_GET_INSTRUMENT, &instrumentInfo, sizeof(instrumentInfo));
-    if (instrumentInfo.loop_count > 0) {
-        returnedValue.loopBegin = instrumentInfo.loops[0].start;
-        returnedValue.loopEnd = min(returnedValue.end, instrumentInfo.loops[0].end - 1);
+bool sfz::FilePool::isRetainable(const PreloadedFileHandle& handle, const fs::path& file, uint32_t maxOffset, bool checkModificationTime) const noexcept
+{
+    if (handle.fileData->oversamplingFactor != oversamplingFactor)
+        return false;
+
+    if (checkModificationTime) {
+        std::error_code ec;
+        if (fs::last_write_time(file, ec) != handle.modificationTime || ec)
+            return false;
     }
 
-    return returnedValue;
+    const auto factor = static_cast<uint32_t>(oversamplingFactor);
+    const auto frames = handle.numFrames / factor;
+    const auto framesToLoad = preloadSize == 0 ? frames : min(frames, maxOffset + preloadSize);
+    return handle.preloadedData->getNumFrames() >= static_cast<size_t>(framesToLoad) * factor;
 }
 
-bool sfz::FilePool::preloadFile(const std::string& filename, uint32_t maxOffset) noexcept
+std::vector<absl::optional<sfz::FilePool::FileInformation>> sfz::FilePool::retainPreloadedFiles(absl::Span<const PreloadRequest> requests,
+    bool checkModificationTimes) noexcept
 {
-    fs::path file { rootDirectory / filename };
+    std::lock_guard<std::mutex> lock { preloadMutex };
+    std::vector<absl::optional<FileInformation>> information (requests.size());
+    absl::flat_hash_map<absl::string_view, PreloadedFileHandle*> filesByPath;
+    for (auto& preloadedFile : preloadedFiles)
+        filesByPath.emplace(preloadedFile.second.filename, &preloadedFile.second);
+
+    decltype(preloadedFiles) retainedFiles;
+    for (size_t index = 0; index < requests.size(); ++index) {
+        const auto& filename = sampleTable->getPath(requests[index].sample);
+        const auto preloaded = filesByPath.find(filename);
+        if (preloaded == filesByPath.end())
+            continue;
 
-    if (!fs::exists(file))
-        return false;
+        auto& handle = *preloaded->second;
+        if (!isRetainable(handle, rootDirectory / filename, requests[index].maxOffset, checkModificationTimes))
+            continue;
 
-    SndfileHandle sndFile(file.string().c_str());
-    if (sndFile.channels() != 1 && sndFile.channels() != 2)
-        return false;
+        information[index] = handle.information;
+        handle.filename = filename;
+        retainedFiles.insert_or_assign(requests[index].sample, std::move(handle));
+    }
 
-    // FIXME: Large offsets will require large preloading; is this OK in practice? Apparently sforzando does the same
-    const auto frames = static_cast<uint32_t>(sndFile.frames());
-    const auto framesToLoad = [&]() {
-        if (preloadSize == 0)
-            return frames;
-        else
-            return min(frames, maxOffset + preloadSize);
-    }();
+    DBG("[sfizz] Keeping " << retainedFiles.size() << " out of " << preloadedFiles.size() << " preloaded files");
+    preloadedFiles = std::move(retainedFiles);
+    return information;
+}
 
-    if (preloadedFiles.contains(filename)) {
-        if (framesToLoad > preloadedFiles[filename].preloadedData->getNumFrames()) {
-            preloadedFiles[filename].preloadedData = readFromFile<float>(sndFile, framesToLoad, oversamplingFactor);
-        }
-    } else {
-        preloadedFiles.insert_or_assign(filename, {
-            readFromFile<float>(sndFile, framesToLoad, oversamplingFactor),
-            static_cast<float>(oversamplingFactor) * sndFile.samplerate()
-        });
+std::vector<absl::optional<sfz::FilePool::FileInformation>> sfz::FilePool::findRetainablePreloads(absl::Span<const PreloadRequest> requests,
+    const SampleTable& table, const fs::path& directory) noexcept
+{
+    std::lock_guard<std::mutex> lock { preloadMutex };
+    std::vector<absl::optional<FileInformation>> information (requests.size());
+    absl::flat_hash_map<absl::string_view, const PreloadedFileHandle*> filesByPath;
+    for (const auto& preloadedFile : preloadedFiles)
+        filesByPath.emplace(preloadedFile.second.filename, &preloadedFile.second);
+
+    for (size_t index = 0; index < requests.size(); ++index) {
+        const auto& filename = table.getPath(requests[index].sample);
+        const auto preloaded = filesByPath.find(filename);
+        if (preloaded == filesByPath.end())
+            continue;
+
+        const auto& handle = *preloaded->second;
+        if (isRetainable(handle, directory / filename, requests[index].maxOffset, true))
+            information[index] = handle.information;
     }
 
-    return true;
+    return information;
 }
 
-sfz::FilePromisePtr sfz::FilePool::getFilePromise(const std::string& filename) noexcept
+sfz::FilePromisePtr sfz::FilePool::getFilePromise(SampleId sample, absl::optional<Range<uint32_t>> loop,
+    uint32_t offset, float pitchRatio) noexcept
 {
     if (emptyPromises.empty()) {
-        DBG("[sfizz] No empty promises left to honor the one for " << filename);
+        DBG("[sfizz] No empty promises left to honor the one for " << sampleTable->getPath(sample));
         return {};
     }
 
-    const auto preloaded = preloadedFiles.find(filename);
+    // Held so that the clearing thread knows when the preloads it replaced are out of reach
+    AtomicGuard guard { readingPreloads };
+    const auto preloaded = preloadedFiles.find(sample);
     if (preloaded == preloadedFiles.end()) {
-        DBG("[sfizz] File not found in the preloaded files: " << filename);
+        DBG("[sfizz] File not found in the preloaded files: " << sampleTable->getPath(sample));
         return {};
     }
+    preloaded->second.fileData->lastUse = ++useCounter;
 
     auto promise = emptyPromises.back();
-    promise->filename = preloaded->first;
-    promise->preloadedData = preloaded->second.preloadedData;
+    promise->filename = preloaded->second.filename;
+    promise->preloadedData = preloaded->second.preloadedData.get();
     promise->sampleRate = preloaded->second.sampleRate;
+    promise->pitchRatio = pitchRatio;
+    promise->pcmLayout = preloaded->second.pcmLayout;
     promise->oversamplingFactor = oversamplingFactor;
     promise->creationTime = std::chrono::high_resolution_clock::now();
 
-    if (!promiseQueue.try_push(promise)) {
-        DBG("[sfizz] Could not enqueue the promise for " << filename << " (queue size " << promiseQueue.size() << ")");
-        return {};
+    const auto numFrames = preloaded->second.numFrames;
+    const auto preloadedFrames = static_cast<uint32_t>(promise->preloadedData->getNumFrames());
+    // Evicted preloads are only empty buffers, and their sample is streamed from the start
+    const bool coldLoad = preloadedFrames == 0 && numFrames > 0;
+    if (coldLoad) {
+        ASSERT(oversamplingFactor == Oversampling::x1);
+        numColdLoads++;
+        preloaded->second.fileData->coldRequested = true;
+        readmissionPending = true;
+    }
+
+    if (coldLoad || (oversamplingFactor == Oversampling::x1 && preloadedFrames > 0
+        && numFrames > preloadedFrames + FileStream::ringFrames)) {
+        auto& stream = promise->stream;
+        stream.numFrames = numFrames;
+        if (loop && loop->getStart() <= loop->getEnd() && loop->getStart() < numFrames) {
+            stream.looping = true;
+            stream.loopStart = loop->getStart();
+            stream.loopEnd = min(loop->getEnd(), numFrames - 1);
+        }
+        // The last playback position for which both interpolated frames are preloaded
+        const auto preloadEnd = stream.looping ? min(preloadedFrames, stream.loopEnd + 1) : preloadedFrames;
+        stream.startPosition = preloadEnd > 0 ? preloadEnd - 1 : 0;
+        stream.readPosition = stream.startPosition;
+        stream.endPosition = stream.startPosition;
+        stream.refillPending = true;
+        promise->streaming = true;
+        setDeadline(*promise, stream.startPosition > offset ? stream.startPosition - offset : 0);
+        if (!promiseQueue.try_push(promise)) {
+            DBG("[sfizz] Could not enqueue the stream for " << promise->filename << " (queue size " << promiseQueue.size() << ")");
+            promise->reset();
+            return {};
+        }
+        loadingSemaphore.post();
+        promise->dataReady = true;
+        temporaryFilePromises.push_back(promise);
+        emptyPromises.pop_back();
+        return promise;
+    }
+
+    auto& fileData = preloaded->second.fileData;
+    switch (fileData->attach()) {
+    case FileData::Status::Unloaded:
+        promise->fileData = fileData;
+        setDeadline(*promise, preloadedFrames > offset ? preloadedFrames - offset : 0);
+        if (!promiseQueue.try_push(promise)) {
+            DBG("[sfizz] Could not enqueue the promise for " << promise->filename << " (queue size " << promiseQueue.size() << ")");
+            fileData->status = FileData::Status::Unloaded;
+            fileData->detach();
+            promise->reset();
+            return {};
+        }
+        loadingSemaphore.post();
+        break;
+    case FileData::Status::Clearing:
+        // The file data is being freed; this promise will only hold the preloaded data
+        DBG("[sfizz] File data being cleared for " << promise->filename << ", only using preloaded data");
+        promise->dataReady = true;
+        temporaryFilePromises.push_back(promise);
+        break;
+    default:
+        // Another promise already requested the file data
+        promise->fileData = fileData;
+        promise->dataReady = true;
+        temporaryFilePromises.push_back(promise);
+        break;
     }
 
     emptyPromises.pop_back();
     return promise;
 }
 
+void sfz::FilePool::setPreloadCacheDirectory(const fs::path& directory)
+{
+    if (directory.empty())
+        preloadCache.reset();
+    else
+        preloadCache = std::make_unique<PreloadCache>(directory);
+}
+
 void sfz::FilePool::setPreloadSize(uint32_t preloadSize) noexcept
 {
-    // Update all the preloaded sizes
+    {
+        std::lock_guard<std::mutex> lock { preloadMutex };
+        // Update all the preloaded sizes
+        for (auto& preloadedFile : preloadedFiles) {
+            auto& handle = preloadedFile.second;
+            const auto preloadedFrames = max(handle.preloadedData->getNumFrames(), static_cast<size_t>(handle.evictedFrames));
+            const auto numFrames = preloadedFrames / static_cast<int>(oversamplingFactor);
+            const auto maxOffset = numFrames > this->preloadSize ? static_cast<uint32_t>(numFrames) - this->preloadSize : 0;
+            fs::path file { rootDirectory / std::string(handle.filename) };
+            SndfileHandle sndFile(file.string().c_str());
+            handle.preloadedData = readPreloadFromFile(sndFile, preloadSize + maxOffset, oversamplingFactor);
+            handle.evictedFrames = 0;
+        }
+        this->preloadSize = preloadSize;
+    }
+
+    enforceMemoryBudget();
+}
+
+void sfz::FilePool::setMemoryBudget(size_t budget) noexcept
+{
+    memoryBudget = budget;
+    enforceMemoryBudget();
+}
+
+size_t sfz::FilePool::getPreloadedBytes() noexcept
+{
+    std::lock_guard<std::mutex> lock { preloadMutex };
+    size_t totalBytes { 0 };
+    for (const auto& preloadedFile : preloadedFiles)
+        totalBytes += preloadedFile.second.preloadedData->getNumBytes();
+
+    return totalBytes;
+}
+
+void sfz::FilePool::enforceMemoryBudget() noexcept
+{
+    struct Readmission {
+        SampleId sample;
+        fs::path file;
+        uint32_t numFrames;
+        SampleBufferPtr data;
+    };
+
+    // The evicted samples that were played since compete again for the budget;
+    // they are read outside of the lock so that the other changes can proceed
+    std::vector<Readmission> readmissions;
+    {
+        std::lock_guard<std::mutex> lock { preloadMutex };
+        if (memoryBudget == 0 || oversamplingFactor != Oversampling::x1)
+            return;
+
+        for (auto& preloadedFile : preloadedFiles) {
+            auto& handle = preloadedFile.second;
+            if (handle.evictedFrames > 0 && handle.fileData->coldRequested.exchange(false))
+                readmissions.push_back({ preloadedFile.first, rootDirectory / std::string(handle.filename), handle.evictedFrames, {} });
+        }
+    }
+
+    for (auto& readmission : readmissions) {
+        SndfileHandle sndFile(readmission.file.string().c_str());
+        if (sndFile.error() == 0)
+            readmission.data = readPreloadFromFile(sndFile, readmission.numFrames, Oversampling::x1);
+    }
+
+    std::lock_guard<std::mutex> lock { preloadMutex };
+    const size_t budget = memoryBudget;
+    if (budget == 0 || oversamplingFactor != Oversampling::x1)
+        return;
+
+    size_t totalBytes { 0 };
+    for (const auto& preloadedFile : preloadedFiles)
+        totalBytes += preloadedFile.second.preloadedData->getNumBytes();
+
+    if (totalBytes <= budget && readmissions.empty())
+        return;
+
+    struct Candidate {
+        PreloadedFileHandle* handle;
+        uint64_t lastUse;
+        size_t bytes;
+        SampleBufferPtr readmitted;
+    };
+
+    std::vector<Candidate> candidates;
+    candidates.reserve(preloadedFiles.size());
     for (auto& preloadedFile : preloadedFiles) {
-        const auto numFrames = preloadedFile.second.preloadedData->getNumFrames() / static_cast<int>(oversamplingFactor);
-        const auto maxOffset = numFrames > this->preloadSize ? static_cast<uint32_t>(numFrames) - this->preloadSize : 0;
-        fs::path file { rootDirectory / std::string(preloadedFile.first) };
-        SndfileHandle sndFile(file.string().c_str());
-        preloadedFile.second.preloadedData = readFromFile<float>(sndFile, preloadSize + maxOffset, oversamplingFactor);
+        auto& handle = preloadedFile.second;
+        const auto bytes = handle.preloadedData->getNumBytes();
+        if (bytes > 0)
+            candidates.push_back({ &handle, handle.fileData->lastUse, bytes, {} });
+    }
+
+    for (auto& readmission : readmissions) {
+        const auto preloaded = preloadedFiles.find(readmission.sample);
+        // The preload may have been reloaded while the lock was released
+        if (!readmission.data || preloaded == preloadedFiles.end() || preloaded->second.evictedFrames == 0)
+            continue;
+
+        auto& handle = preloaded->second;
+        const auto bytes = readmission.data->getNumBytes();
+        totalBytes += bytes;
+        candidates.push_back({ &handle, handle.fileData->lastUse, bytes, std::move(readmission.data) });
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+        return lhs.lastUse < rhs.lastUse;
+    });
+
+    auto firstKept = candidates.begin();
+    while (totalBytes > budget && firstKept < candidates.end()) {
+        totalBytes -= firstKept->bytes;
+        ++firstKept;
     }
-    this->preloadSize = preloadSize;
+
+    const auto isReadmitted = [](const Candidate& candidate) { return candidate.readmitted != nullptr; };
+    bool published { false };
+    for (auto candidate = candidates.begin(); candidate < candidates.end(); ++candidate) {
+        auto& handle = *candidate->handle;
+        if (candidate < firstKept && !isReadmitted(*candidate)) {
+            // The empty preloads keep the channel count for the voices
+            const auto& preloadedData = *handle.preloadedData;
+            handle.evictedFrames = static_cast<uint32_t>(preloadedData.getNumFrames());
+            handle.preloadedData.publish(std::make_shared<SampleBuffer>(preloadedData.getFormat(), preloadedData.getNumChannels(), 0));
+            published = true;
+        } else if (candidate >= firstKept && isReadmitted(*candidate)) {
+            handle.preloadedData.publish(std::move(candidate->readmitted));
+            handle.evictedFrames = 0;
+            published = true;
+        }
+    }
+
+    if (!published)
+        return;
+
+    // The evicted data is freed here, unless voices still hold it
+    waitForPreloadReaders();
+    for (auto& candidate : candidates)
+        candidate.handle->preloadedData.releasePrevious();
+}
+
+void sfz::FilePool::waitForPreloadReaders() const noexcept
+{
+    // The audio thread only holds the guard for the length of a lookup
+    while (readingPreloads)
+        std::this_thread::yield();
 }
 
 void sfz::FilePool::tryToClearPromises()
@@ -275,69 +740,385 @@ void sfz::FilePool::tryToClearPromises()
         std::this_thread::sleep_for(1ms);
 
     for (auto& promise: promisesToClear) {
-        if (promise->dataReady)
+        if (promise->dataReady) {
+            if (promise->fileData)
+                tryToClearFileData(*promise->fileData);
             promise->reset();
+        }
     }
 }
 
-void sfz::FilePool::clearingThread()
+void sfz::FilePool::tryToClearFileData(FileData& fileData)
 {
-    while (!quitThread) {
-        tryToClearPromises();
-        std::this_thread::sleep_for(50ms);
+    auto expected = FileData::Status::ToClear;
+    if (!fileData.status.compare_exchange_strong(expected, FileData::Status::Clearing))
+        return;
+
+    fileData.availableFrames = 0;
+    fileData.data.reset();
+    fileData.status = FileData::Status::Unloaded;
+}
+
+void sfz::FilePool::fillStream(FilePromise& promise) noexcept
+{
+    auto& stream = promise.stream;
+    if (!stream.handle) {
+        fs::path file { rootDirectory / std::string(promise.filename) };
+        stream.handle = SndfileHandle(file.string().c_str());
+    }
+
+    auto& sndFile = stream.handle;
+    if (sndFile.error() != 0) {
+        DBG("[sfizz] libsndfile errored for " << promise.filename << " with message " << sndFile.strError());
+        return;
+    }
+
+    const auto numChannels = static_cast<size_t>(sndFile.channels());
+    prepareRing(stream, numChannels);
+
+    sfz::Buffer<float> tempReadBuffer { numChannels * config::chunkSize };
+    forEachStreamSegment(stream, [&](uint32_t filePosition, uint32_t ringPosition, uint32_t frames, uint32_t publishedPosition) {
+        auto input = absl::MakeSpan(tempReadBuffer).first(frames * numChannels);
+        sndFile.seek(filePosition, SEEK_SET);
+        const auto read = static_cast<size_t>(max<sf_count_t>(0, sndFile.readf(input.data(), static_cast<sf_count_t>(frames))));
+        if (read < frames) {
+            DBG("[sfizz] Short read while streaming " << promise.filename << " at frame " << filePosition);
+            sfz::fill<float>(input.subspan(read * numChannels), 0.0f);
+        }
+
+        if (numChannels == 1) {
+            sfz::copy<float>(input, stream.ring.getSpan(0).subspan(ringPosition, frames));
+        } else {
+            sfz::readInterleaved<float>(input,
+                stream.ring.getSpan(0).subspan(ringPosition, frames),
+                stream.ring.getSpan(1).subspan(ringPosition, frames));
+        }
+
+        if (publishedPosition > 0)
+            stream.endPosition = publishedPosition;
+    });
+}
+
+void sfz::FilePool::loadFile(FilePromise& promise) noexcept
+{
+    const auto loadStartTime = std::chrono::high_resolution_clock::now();
+    const auto waitDuration = loadStartTime - promise.creationTime;
+
+    auto& fileData = *promise.fileData;
+    fs::path file { rootDirectory / std::string(promise.filename) };
+    SndfileHandle sndFile(file.string().c_str());
+    if (sndFile.error() != 0) {
+        DBG("[sfizz] libsndfile errored for " << promise.filename << " with message " << sndFile.strError());
+        return;
     }
+
+    const auto frames = static_cast<uint32_t>(sndFile.frames());
+    streamFromFile<float>(sndFile, frames, fileData.oversamplingFactor, fileData.data, &fileData.availableFrames);
+    const auto loadDuration = std::chrono::high_resolution_clock::now() - loadStartTime;
+    logger.logFileTime(waitDuration, loadDuration, frames, promise.filename);
 }
 
-void sfz::FilePool::loadingThread() noexcept
+void sfz::FilePool::loadBatch(IOBackend& backend, absl::Span<FilePromisePtr> promises) noexcept
 {
-    FilePromisePtr promise;
-    while (!quitThread) {
+    std::vector<BatchJob> jobs;
+    std::vector<BatchRead> reads;
+    jobs.reserve(promises.size());
+
+    for (auto& promise : promises) {
+        const auto& layout = promise->pcmLayout;
+        const bool canUseBackend = layout && (promise->streaming
+            || promise->fileData->oversamplingFactor == Oversampling::x1);
+
+        if (!canUseBackend) {
+            if (promise->streaming)
+                fillStream(*promise);
+            else
+                loadFile(*promise);
+            finishLoading(promise);
+            continue;
+        }
 
-        if (emptyQueue) {
-            while(promiseQueue.try_pop(promise)) {
-                // We're just dequeuing
+        BatchJob job;
+        job.promise = promise;
+        job.startTime = std::chrono::high_resolution_clock::now();
+        const auto addRead = [&](uint64_t offset, uint32_t frame, uint32_t numFrames, uint32_t publishedPosition) {
+            job.reads.push_back(reads.size());
+            reads.push_back({ jobs.size(), offset, frame, numFrames, publishedPosition, false });
+        };
+
+        const fs::path file { rootDirectory / std::string(promise->filename) };
+        if (promise->streaming) {
+            auto& stream = promise->stream;
+            if (!stream.file)
+                stream.file = ReadableFile(file);
+
+            if (!stream.file) {
+                DBG("[sfizz] Could not open " << promise->filename << " for streaming");
+                finishLoading(promise);
+                continue;
+            }
+
+            prepareRing(stream, layout->numChannels);
+            job.fileDescriptor = stream.file.descriptor();
+            job.output = &stream.ring;
+            forEachStreamSegment(stream, [&](uint32_t filePosition, uint32_t ringPosition, uint32_t frames, uint32_t publishedPosition) {
+                addRead(layout->byteOffset(filePosition), ringPosition, frames, publishedPosition);
+            });
+        } else {
+            job.file = ReadableFile(file);
+            if (!job.file) {
+                DBG("[sfizz] Could not open " << promise->filename);
+                finishLoading(promise);
+                continue;
+            }
+
+            auto& fileData = *promise->fileData;
+            fileData.data.reset();
+            fileData.data.addChannels(layout->numChannels);
+            fileData.data.resize(layout->numFrames);
+            job.fileDescriptor = job.file.descriptor();
+            job.output = &fileData.data;
+            for (uint32_t frame = 0; frame < layout->numFrames; frame += config::ioChunkSize) {
+                const auto numFrames = min<uint32_t>(config::ioChunkSize, layout->numFrames - frame);
+                addRead(layout->byteOffset(frame), frame, numFrames, frame + numFrames);
             }
-            emptyQueue = false;
-            continue;
         }
 
-        if (!promiseQueue.try_pop(promise)) {
-            std::this_thread::sleep_for(1ms);
+        if (job.reads.empty()) {
+            finishLoading(promise);
             continue;
         }
 
-        threadsLoading++;
-        const auto loadStartTime = std::chrono::high_resolution_clock::now();
-        const auto waitDuration = loadStartTime - promise->creationTime;
+        jobs.push_back(std::move(job));
+    }
 
-        fs::path file { rootDirectory / std::string(promise->filename) };
-        SndfileHandle sndFile(file.string().c_str());
-        if (sndFile.error() != 0) {
-            DBG("[sfizz] libsndfile errored for " << promise->filename << " with message " << sndFile.strError());
-            continue;
+    // Interleave the reads of all jobs so that each voice gets its next chunk
+    // before any voice gets the one after
+    std::vector<size_t> order;
+    order.reserve(reads.size());
+    for (size_t rank = 0; order.size() < reads.size(); ++rank) {
+        for (auto& job : jobs) {
+            if (rank < job.reads.size())
+                order.push_back(job.reads[rank]);
         }
-        const auto frames = static_cast<uint32_t>(sndFile.frames());
-        streamFromFile<float>(sndFile, frames, oversamplingFactor, promise->fileData, &promise->availableFrames);
-        promise->dataReady = true;
-        const auto loadDuration = std::chrono::high_resolution_clock::now() - loadStartTime;
-        logger.logFileTime(waitDuration, loadDuration, frames, promise->filename);
+    }
+
+    const auto publish = [&](BatchJob& job) {
+        while (job.nextToPublish < job.reads.size() && reads[job.reads[job.nextToPublish]].done) {
+            const auto position = reads[job.reads[job.nextToPublish]].publishedPosition;
+            if (position > 0) {
+                if (job.promise->streaming)
+                    job.promise->stream.endPosition = position;
+                else
+                    job.promise->fileData->availableFrames = position;
+            }
+            job.nextToPublish++;
+        }
+    };
 
+    const auto finishJob = [&](BatchJob& job) {
+        if (job.finished)
+            return;
+
+        if (!job.promise->streaming) {
+            const auto now = std::chrono::high_resolution_clock::now();
+            logger.logFileTime(job.startTime - job.promise->creationTime, now - job.startTime,
+                static_cast<uint32_t>(job.output->getNumFrames()), job.promise->filename);
+        }
+        job.finished = true;
+        finishLoading(job.promise);
+    };
+
+    // Submit the reads by windows of the queue depth, reusing the same raw buffers
+    constexpr size_t maxBytesPerFrame { 2 * sizeof(int32_t) };
+    constexpr size_t slotSize { config::ioChunkSize * maxBytesPerFrame };
+    std::vector<uint8_t> rawData (config::ioQueueDepth * slotSize);
+    std::vector<ReadRequest> requests;
+    requests.reserve(config::ioQueueDepth);
+    for (size_t windowStart = 0; windowStart < order.size(); windowStart += config::ioQueueDepth) {
+        const auto windowEnd = min(order.size(), windowStart + config::ioQueueDepth);
+        requests.clear();
+        for (size_t i = windowStart; i < windowEnd; ++i) {
+            const auto& read = reads[order[i]];
+            const auto& job = jobs[read.job];
+            const auto size = read.numFrames * job.promise->pcmLayout->bytesPerFrame;
+            requests.push_back({ job.fileDescriptor, read.offset, size, &rawData[(i - windowStart) * slotSize] });
+        }
+
+        backend.read(requests, [&](size_t index, int64_t result) {
+            auto& read = reads[order[windowStart + index]];
+            auto& job = jobs[read.job];
+            const auto& request = requests[index];
+            if (result < static_cast<int64_t>(request.size)) {
+                DBG("[sfizz] Error reading " << job.promise->filename << " at byte " << request.offset);
+                const auto validBytes = static_cast<size_t>(max(result, int64_t { 0 }));
+                std::fill(request.buffer + validBytes, request.buffer + request.size, 0);
+            }
+
+            decodePCM({ request.buffer, request.size }, *job.promise->pcmLayout, *job.output, read.frame);
+            read.done = true;
+            publish(job);
+            if (++job.numDone == job.reads.size())
+                finishJob(job);
+        });
+    }
+
+    // Reads lost by the backend leave their job unfinished
+    for (auto& job : jobs)
+        finishJob(job);
+}
+
+void sfz::FilePool::finishLoading(const FilePromisePtr& promise) noexcept
+{
+    if (promise->streaming) {
+        promise->stream.refillPending = false;
         threadsLoading--;
+        return;
+    }
 
+    promise->fileData->status = FileData::Status::Ready;
+    promise->dataReady = true;
+    // Handed back before the thread stops counting as loading, so that the
+    // promise is tracked when waitForBackgroundLoading() returns
+    pushFilledPromise(promise);
+    threadsLoading--;
+}
 
+void sfz::FilePool::dropPromise(const FilePromisePtr& promise) noexcept
+{
+    // Streams are tracked by the audio thread from the start, and are only
+    // refilled again if a voice still plays them
+    if (promise->streaming) {
+        promise->stream.refillPending = false;
+        return;
+    }
+
+    // The file data was marked as loading when the promise was queued; it is
+    // loaded by the next promise on the sample instead. The promise goes back
+    // to the pool like the loaded ones, with only its preloaded data.
+    promise->fileData->status = FileData::Status::Unloaded;
+    promise->dataReady = true;
+    pushFilledPromise(promise);
+}
 
-        while (!filledPromiseQueue.try_push(promise)) {
-            DBG("[sfizz] Error enqueuing the promise for " << promise->filename << " in the filledPromiseQueue");
-            std::this_thread::sleep_for(1ms);
+void sfz::FilePool::pushFilledPromise(const FilePromisePtr& promise) noexcept
+{
+    while (!filledPromiseQueue.try_push(promise)) {
+        DBG("[sfizz] Error enqueuing the promise for " << promise->filename << " in the filledPromiseQueue");
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+void sfz::FilePool::queueStreamRefills() noexcept
+{
+    for (auto& promise : temporaryFilePromises) {
+        // Promises with a single owner are not used by a voice anymore
+        if (!promise->streaming || promise.use_count() == 1)
+            continue;
+
+        auto& stream = promise->stream;
+        if (stream.refillPending || !stream.needsRefill())
+            continue;
+
+        const auto endPosition = stream.endPosition.load();
+        const auto readPosition = stream.readPosition.load();
+        setDeadline(*promise, endPosition > readPosition ? endPosition - readPosition : 0);
+        stream.refillPending = true;
+        if (promiseQueue.try_push(promise))
+            loadingSemaphore.post();
+        else
+            stream.refillPending = false;
+    }
+}
+
+void sfz::FilePool::setDeadline(FilePromise& promise, uint32_t availableFrames) noexcept
+{
+    const auto now = std::chrono::high_resolution_clock::now();
+    const auto framesPerSecond = static_cast<double>(promise.pitchRatio) * promise.sampleRate;
+    if (framesPerSecond <= 0.0) {
+        promise.deadline = now;
+        return;
+    }
+
+    const std::chrono::duration<double> timeLeft { availableFrames / framesPerSecond };
+    promise.deadline = now + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(timeLeft);
+}
+
+void sfz::FilePool::popEarliestPromises(std::vector<FilePromisePtr>& promises, size_t maxPromises) noexcept
+{
+    const auto laterDeadline = [](const FilePromisePtr& lhs, const FilePromisePtr& rhs) {
+        return lhs->deadline > rhs->deadline;
+    };
+
+    std::lock_guard<std::mutex> lock { promiseHeapMutex };
+    FilePromisePtr promise;
+    while (promiseQueue.try_pop(promise)) {
+        promiseHeap.push_back(std::move(promise));
+        std::push_heap(promiseHeap.begin(), promiseHeap.end(), laterDeadline);
+    }
+
+    while (!promiseHeap.empty() && promises.size() < maxPromises) {
+        std::pop_heap(promiseHeap.begin(), promiseHeap.end(), laterDeadline);
+        promises.push_back(std::move(promiseHeap.back()));
+        promiseHeap.pop_back();
+        // Counted while still under the lock so that waitForBackgroundLoading()
+        // never sees the promise in neither the heap nor a loading thread
+        threadsLoading++;
+    }
+}
+
+void sfz::FilePool::clearingThread()
+{
+    while (true) {
+        clearingSemaphore.wait();
+        if (quitThread)
+            return;
+
+        tryToClearPromises();
+        // Only the cold loads can change the eviction order enough to matter
+        if (readmissionPending.exchange(false))
+            enforceMemoryBudget();
+    }
+}
+
+void sfz::FilePool::loadingThread() noexcept
+{
+    auto ioBackend = createIOBackend();
+    std::vector<FilePromisePtr> promises;
+    promises.reserve(config::maxPromisesPerBatch);
+    FilePromisePtr promise;
+    while (true) {
+        loadingSemaphore.wait();
+        if (quitThread)
+            return;
+
+        if (emptyQueue) {
+            std::lock_guard<std::mutex> lock { promiseHeapMutex };
+            while (promiseQueue.try_pop(promise))
+                dropPromise(promise);
+            for (auto& queuedPromise : promiseHeap)
+                dropPromise(queuedPromise);
+            promiseHeap.clear();
+            promise.reset();
+            emptyQueue = false;
+            continue;
         }
 
-        promise.reset();
+        // The promises may have been taken by another thread, or dropped
+        // when emptying the queues
+        popEarliestPromises(promises, config::maxPromisesPerBatch);
+        if (promises.empty())
+            continue;
+
+        loadBatch(*ioBackend, absl::MakeSpan(promises));
+        promises.clear();
     }
 }
 
 void sfz::FilePool::clear()
 {
     emptyFileLoadingQueues();
+    std::lock_guard<std::mutex> lock { preloadMutex };
     preloadedFiles.clear();
     temporaryFilePromises.clear();
     promisesToClear.clear();
@@ -345,6 +1126,8 @@ void sfz::FilePool::clear()
 
 void sfz::FilePool::cleanupPromises() noexcept
 {
+    queueStreamRefills();
+
     AtomicGuard guard { addingPromisesToClear };
 
     if (!canAddPromisesToClear)
@@ -371,10 +1154,13 @@ void sfz::FilePool::cleanupPromises() noexcept
     while (filledPromiseQueue.try_pop(promise))
         temporaryFilePromises.push_back(promise);
 
+    const auto numPromisesToClear = promisesToClear.size();
     auto filledIterator = temporaryFilePromises.begin();
     auto filledSentinel = temporaryFilePromises.rbegin();
     while (filledIterator < filledSentinel.base()) {
         if (filledIterator->use_count() == 1) {
+            if (filledIterator->get()->fileData)
+                filledIterator->get()->fileData->detach();
             promisesToClear.push_back(*filledIterator);
             std::iter_swap(filledIterator, filledSentinel);
             ++filledSentinel;
@@ -383,21 +1169,34 @@ void sfz::FilePool::cleanupPromises() noexcept
         }
     }
     temporaryFilePromises.resize(std::distance(temporaryFilePromises.begin(), filledSentinel.base()));
+
+    if (promisesToClear.size() > numPromisesToClear)
+        clearingSemaphore.post();
 }
 
 void sfz::FilePool::setOversamplingFactor(sfz::Oversampling factor) noexcept
 {
-    float samplerateChange { static_cast<float>(factor) / static_cast<float>(this->oversamplingFactor) };
-    for (auto& preloadedFile : preloadedFiles) {
-        const auto numFrames = preloadedFile.second.preloadedData->getNumFrames() / static_cast<int>(this->oversamplingFactor);
-        const uint32_t maxOffset = numFrames > this->preloadSize ? static_cast<uint32_t>(numFrames) - this->preloadSize : 0;
-        fs::path file { rootDirectory / std::string(preloadedFile.first) };
-        SndfileHandle sndFile(file.string().c_str());
-        preloadedFile.second.preloadedData = readFromFile<float>(sndFile, preloadSize + maxOffset, factor);
-        preloadedFile.second.sampleRate *= samplerateChange;
+    {
+        std::lock_guard<std::mutex> lock { preloadMutex };
+        float samplerateChange { static_cast<float>(factor) / static_cast<float>(this->oversamplingFactor) };
+        for (auto& preloadedFile : preloadedFiles) {
+            auto& handle = preloadedFile.second;
+            const auto preloadedFrames = max(handle.preloadedData->getNumFrames(), static_cast<size_t>(handle.evictedFrames));
+            const auto numFrames = preloadedFrames / static_cast<int>(this->oversamplingFactor);
+            const uint32_t maxOffset = numFrames > this->preloadSize ? static_cast<uint32_t>(numFrames) - this->preloadSize : 0;
+            fs::path file { rootDirectory / std::string(handle.filename) };
+            SndfileHandle sndFile(file.string().c_str());
+            handle.preloadedData = readPreloadFromFile(sndFile, preloadSize + maxOffset, factor);
+            handle.evictedFrames = 0;
+            handle.sampleRate *= samplerateChange;
+            handle.fileData = std::make_shared<FileData>(factor);
+            handle.numFrames = handle.numFrames / static_cast<uint32_t>(this->oversamplingFactor) * static_cast<uint32_t>(factor);
+        }
+
+        this->oversamplingFactor = factor;
     }
 
-    this->oversamplingFactor = factor;
+    enforceMemoryBudget();
 }
 
 sfz::Oversampling sfz::FilePool::getOversamplingFactor() const noexcept
@@ -413,16 +1212,20 @@ uint32_t sfz::FilePool::getPreloadSize() const noexcept
 void sfz::FilePool::emptyFileLoadingQueues() noexcept
 {
     emptyQueue = true;
+    loadingSemaphore.post();
     while (emptyQueue)
         std::this_thread::sleep_for(1ms);
 }
 
 void sfz::FilePool::waitForBackgroundLoading() noexcept
 {
-    // TODO: validate that this is enough, otherwise we will need an atomic count
-    // of the files we need to load still.
-    // Spinlocking on the size of the background queue
-    while (!promiseQueue.was_empty()){
+    const auto hasPendingPromises = [this]() {
+        std::lock_guard<std::mutex> lock { promiseHeapMutex };
+        return !promiseQueue.was_empty() || !promiseHeap.empty();
+    };
+
+    // Spinlocking on the size of the background queue and heap
+    while (hasPendingPromises()) {
         std::this_thread::sleep_for(0.1ms);
     }
 
@@ -30,6 +30,12 @@
 #include "AudioBuffer.h"
 #include "AudioSpan.h"
 #include "SIMDHelpers.h"
+#include "Range.h"
+#include "RTSemaphore.h"
+#include "IOBackend.h"
+#include "PCMFile.h"
+#include "SampleBuffer.h"
+#include "SampleTable.h"
 #include "ghc/fs_std.hpp"
 #include <absl/container/flat_hash_map.h>
 #include <absl/types/optional.h>
@@ -37,50 +43,275 @@
 #include "atomic_queue/atomic_queue.h"
 #include "Logger.h"
 #include <chrono>
+#include <mutex>
 #include <thread>
 #include <sndfile.hh>
 
 namespace sfz {
+class PreloadCache;
 using AudioBufferPtr = std::shared_ptr<AudioBuffer<float>>;
 
 
+/**
+ * @brief Fully loaded sample data, shared between all the promises requesting
+ * the same sample at the same oversampling factor. The first promise triggers
+ * the background load and the following ones attach to the same buffer and
+ * frame counter.
+ *
+ * The reader count and status are only changed by the audio thread, except for
+ * the loading threads which mark the data as ready and the clearing thread
+ * which frees data that has no readers left.
+ */
+struct FileData
+{
+    enum class Status { Unloaded, Loading, Ready, ToClear, Clearing };
+
+    FileData(Oversampling factor = config::defaultOversamplingFactor)
+    : oversamplingFactor(factor) {}
+
+    /**
+     * @brief Attach a new reader to the data. This has to be called on the
+     * audio thread.
+     *
+     * @return Status the status before attaching. If Unloaded, the caller is
+     *                in charge of queuing the data for loading. If Clearing,
+     *                the data is being freed and the reader was not attached.
+     */
+    Status attach() noexcept
+    {
+        auto previous = status.load();
+        if (previous == Status::ToClear)
+            status.compare_exchange_strong(previous, Status::Ready);
+
+        if (previous == Status::Clearing)
+            return previous;
+
+        if (previous == Status::Unloaded)
+            status = Status::Loading;
+
+        readerCount++;
+        return previous;
+    }
+    /**
+     * @brief Detach a reader from the data. If it was the last one, the data
+     * will be freed by the clearing thread unless it is attached again in the
+     * meantime. This has to be called on the audio thread.
+     */
+    void detach() noexcept
+    {
+        if (--readerCount > 0)
+            return;
+
+        auto expected = Status::Ready;
+        status.compare_exchange_strong(expected, Status::ToClear);
+    }
+
+    AudioBuffer<float> data {};
+    const Oversampling oversamplingFactor;
+    std::atomic_size_t availableFrames { 0 };
+    std::atomic<Status> status { Status::Unloaded };
+    std::atomic<int> readerCount { 0 };
+    // Stamp of the last promise on the sample, to evict the least recently used preloads
+    std::atomic<uint64_t> lastUse { 0 };
+    // Set when the sample is played while its preload is evicted
+    std::atomic<bool> coldRequested { false };
+    LEAK_DETECTOR(FileData);
+};
+
+using FileDataPtr = std::shared_ptr<FileData>;
+
+/**
+ * @brief Metadata of a sample file
+ */
+struct FileInformation {
+    uint32_t end { Default::sampleEndRange.getEnd() };
+    uint32_t loopBegin { Default::loopRange.getStart() };
+    uint32_t loopEnd { Default::loopRange.getEnd() };
+    double sampleRate { config::defaultSampleRate };
+    int numChannels { 0 };
+};
+
+/**
+ * @brief Preloaded data that can be swapped while the audio thread reads it.
+ *
+ * The audio thread reads the current slot, while a writer fills the other one
+ * and flips the index. The previous data must only be released once the audio
+ * thread is known to be out of its read, and a single writer may publish at a
+ * time. Copying and assigning are only safe while the audio thread is held off.
+ */
+class PreloadSlot
+{
+public:
+    PreloadSlot() = default;
+    PreloadSlot(SampleBufferPtr data) noexcept
+    {
+        slots[0] = std::move(data);
+    }
+    PreloadSlot(PreloadSlot&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+    PreloadSlot& operator=(PreloadSlot&& other) noexcept
+    {
+        *this = std::move(other.slots[other.current]);
+        other.slots[0].reset();
+        other.slots[1].reset();
+        return *this;
+    }
+    PreloadSlot& operator=(SampleBufferPtr data) noexcept
+    {
+        slots[0] = std::move(data);
+        slots[1].reset();
+        current = 0;
+        return *this;
+    }
+
+    const SampleBufferPtr& get() const noexcept { return slots[current]; }
+    SampleBuffer* operator->() const noexcept { return get().get(); }
+    SampleBuffer& operator*() const noexcept { return *get(); }
+    explicit operator bool() const noexcept { return get() != nullptr; }
+
+    /**
+     * @brief Make some data current, keeping the previous one alive
+     *
+     * @param data
+     */
+    void publish(SampleBufferPtr data) noexcept
+    {
+        const unsigned next = 1 - current;
+        slots[next] = std::move(data);
+        current = next;
+    }
+    /**
+     * @brief Release the data replaced by the last publish()
+     */
+    void releasePrevious() noexcept { slots[1 - current].reset(); }
+private:
+    SampleBufferPtr slots[2] {};
+    std::atomic<unsigned> current { 0 };
+};
+
 struct PreloadedFileHandle
 {
-    std::shared_ptr<AudioBuffer<float>> preloadedData {};
+    PreloadSlot preloadedData {};
     float sampleRate { config::defaultSampleRate };
+    FileDataPtr fileData {};
+    uint32_t numFrames { 0 };
+    absl::optional<PCMLayout> pcmLayout {};
+    FileInformation information {};
+    fs::file_time_type modificationTime {};
+    // Size of the preload before it was evicted, which is 0 while it is in memory
+    uint32_t evictedFrames { 0 };
+    // Path of the sample, held by the sample table
+    absl::string_view filename {};
+};
+
+/**
+ * @brief Bounded streaming buffer for the samples that are too long to be
+ * loaded whole.
+ *
+ * Frames are addressed by playback position, that is the position in the
+ * sample with the loop unrolled, so the ring never holds a frame that will not
+ * be played. The loading threads write chunks of config::chunkSize frames ahead
+ * of the read position published by the voice, and never more than the ring
+ * size ahead of it. Playback positions up to the start position are read from
+ * the preloaded data.
+ */
+struct FileStream
+{
+    static constexpr uint32_t ringFrames { config::numStreamingChunks * config::chunkSize };
+
+    /**
+     * @brief Get the frame in the file for a playback position
+     *
+     * @param position
+     * @return uint32_t
+     */
+    uint32_t filePosition(uint32_t position) const noexcept
+    {
+        if (!looping || position <= loopEnd)
+            return position;
+
+        return loopStart + (position - loopStart) % (loopEnd - loopStart + 1);
+    }
+
+    /**
+     * @brief Check if the ring has room for at least one more chunk
+     */
+    bool needsRefill() const noexcept
+    {
+        const auto end = endPosition.load();
+        if (!looping && end >= numFrames)
+            return false;
+
+        return end + config::chunkSize <= readPosition.load() + ringFrames;
+    }
+
+    void reset()
+    {
+        ring.reset();
+        handle = SndfileHandle();
+        file = ReadableFile();
+        startPosition = 0;
+        numFrames = 0;
+        loopStart = 0;
+        loopEnd = 0;
+        looping = false;
+        readPosition = 0;
+        endPosition = 0;
+        refillPending = false;
+    }
+
+    AudioBuffer<float> ring {};
+    SndfileHandle handle {};
+    ReadableFile file {};
+    uint32_t startPosition { 0 };
+    uint32_t numFrames { 0 };
+    uint32_t loopStart { 0 };
+    uint32_t loopEnd { 0 };
+    bool looping { false };
+    std::atomic<uint32_t> readPosition { 0 };
+    std::atomic<uint32_t> endPosition { 0 };
+    std::atomic<bool> refillPending { false };
 };
 
 struct FilePromise
 {
-    auto getData()
+    SampleSpan getData()
     {
-        if (dataReady)
-            return AudioSpan<const float>(fileData);
-        else if (availableFrames > preloadedData->getNumFrames())
-            return AudioSpan<const float>(fileData).first(availableFrames);
+        const auto availableFrames = fileData != nullptr ? fileData->availableFrames.load() : 0;
+        if (availableFrames > preloadedData->getNumFrames())
+            return AudioSpan<const float>(fileData->data).first(availableFrames);
         else
-            return AudioSpan<const float>(*preloadedData);
+            return preloadedData->getSpan();
     }
 
     void reset()
     {
+        stream.reset();
+        streaming = false;
+        pcmLayout.reset();
         fileData.reset();
         preloadedData.reset();
         filename = "";
-        availableFrames = 0;
         dataReady = false;
         oversamplingFactor = config::defaultOversamplingFactor;
         sampleRate = config::defaultSampleRate;
+        pitchRatio = 1.0f;
     }
 
     absl::string_view filename {};
-    AudioBufferPtr preloadedData {};
-    AudioBuffer<float> fileData {};
+    SampleBufferPtr preloadedData {};
+    FileDataPtr fileData {};
+    bool streaming { false };
+    FileStream stream {};
+    absl::optional<PCMLayout> pcmLayout {};
     float sampleRate { config::defaultSampleRate };
+    float pitchRatio { 1.0f };
     Oversampling oversamplingFactor { config::defaultOversamplingFactor };
-    std::atomic_size_t availableFrames { 0 };
     std::atomic<bool> dataReady { false };
     std::chrono::time_point<std::chrono::high_resolution_clock> creationTime;
+    std::chrono::time_point<std::chrono::high_resolution_clock> deadline;
 
     LEAK_DETECTOR(FilePromise);
 };
@@ -98,11 +329,42 @@ using FilePromisePtr = std::shared_ptr<FilePromise>;
  * The file request is immediately served using the preloaded data. A promise is
  * then provided to the voice that requested the file, and the file loading
  * happens in the background. File reads happen on whole samples but
- * oversampling is done in chunks, and the promise contains a counter for the
- * frames that are loaded. When the voice dies it releases its handle on the
- * promise, which should decrease the  reference count to 1. A garbage
- * collection thread then runs regularly to clear the memory of all file handles
- * with a reference count of 1.
+ * oversampling is done in chunks, and the shared file data contains a counter
+ * for the frames that are loaded. Promises on the same sample share the same
+ * file data, so that only the first one triggers a load from the disk. When the
+ * voice dies it releases its handle on the promise, which should decrease the
+ * reference count to 1. A garbage collection thread then runs regularly to
+ * clear the memory of all file handles with a reference count of 1, as well as
+ * the file data that no promise uses anymore.
+ *
+ * Samples longer than the preloaded data plus a streaming ring are not loaded
+ * whole; each promise on them streams into its own bounded ring instead. The
+ * audio thread requeues these promises for a refill whenever the voice has
+ * consumed at least one chunk of the ring.
+ *
+ * Each queued promise carries a deadline, which is the time at which its voice
+ * will run out of loaded data. The loading threads move the queued promises to
+ * a heap and always serve the earliest deadline first.
+ *
+ * The background threads sleep on semaphores that the audio thread posts when
+ * it queues a promise for loading or hands over promises to clear.
+ *
+ * Each loading thread takes the promises by batches and reads the uncompressed
+ * WAV files through an IOBackend, which submits all the chunk reads of a batch
+ * at once through io_uring on Linux. The other files, and oversampled loads,
+ * are read through libsndfile.
+ *
+ * The files are identified by their sample identifier, and their paths are
+ * read from the sample table given on construction.
+ *
+ * The preloaded data can be held within a memory budget. When the preloads
+ * exceed it, the least recently used ones are evicted and their samples take a
+ * cold path: they are streamed from the start of the file, and thus play
+ * silence until the first chunk is loaded. After a cold load, the clearing
+ * thread loads the evicted samples that were played again and enforces the
+ * budget, keeping them if they are more recent than the preloads that remain.
+ * The preloads are swapped under the audio thread, which never misses a
+ * promise because of an eviction.
  */
 
 
@@ -113,8 +375,11 @@ public:
      *
      * This creates the background threads based on config::numBackgroundThreads
      * as well as the garbage collection thread.
+     *
+     * @param logger
+     * @param sampleTable the paths of the samples, which must outlive the pool
      */
-    FilePool(Logger& logger);
+    FilePool(Logger& logger, const SampleTable& sampleTable);
 
     ~FilePool();
     /**
@@ -123,6 +388,13 @@ public:
      * @param directory
      */
     void setRootDirectory(const fs::path& directory) noexcept { rootDirectory = directory; }
+    /**
+     * @brief Set the paths of the samples, which must outlive the pool or the
+     * next call. Don't call it on the audio thread.
+     *
+     * @param table
+     */
+    void setSampleTable(const SampleTable& table) noexcept { sampleTable = &table; }
     /**
      * @brief Get the number of preloaded sample files
      *
@@ -130,13 +402,7 @@ public:
      */
     size_t getNumPreloadedSamples() const noexcept { return preloadedFiles.size(); }
 
-    struct FileInformation {
-        uint32_t end { Default::sampleEndRange.getEnd() };
-        uint32_t loopBegin { Default::loopRange.getStart() };
-        uint32_t loopEnd { Default::loopRange.getEnd() };
-        double sampleRate { config::defaultSampleRate };
-        int numChannels { 0 };
-    };
+    using FileInformation = sfz::FileInformation;
 
     /**
      * @brief Get metadata information about a file.
@@ -149,13 +415,98 @@ public:
     /**
      * @brief Check that a file is preloaded with the proper offset bounds
      *
-     * @param filename
+     * @param sample
      * @param offset the maximum offset to consider for preloading. The total preloaded
      *                  size will be preloadSize + offset
      * @return true if the preloading went fine
      * @return false if something went wrong ()
      */
-    bool preloadFile(const std::string& filename, uint32_t maxOffset) noexcept;
+    bool preloadFile(SampleId sample, uint32_t maxOffset) noexcept;
+
+    struct PreloadRequest {
+        SampleId sample {};
+        uint32_t maxOffset { 0 };
+    };
+
+    /**
+     * @brief Probe and preload a set of distinct files in parallel. Each file
+     * is opened once, to both get its metadata and read its preloaded data.
+     *
+     * @param requests the files, with the maximum offset to consider for preloading
+     * @return std::vector<absl::optional<FileInformation>> the metadata of each
+     *                                          requested file, or nothing if
+     *                                          the file could not be preloaded
+     */
+    std::vector<absl::optional<FileInformation>> preloadFiles(absl::Span<const PreloadRequest> requests) noexcept;
+
+    /**
+     * @brief The first half of preloadFiles(), which probes and preloads the
+     * files without changing the pool. It can thus run while the audio thread
+     * requests promises, and the result is added with addPreloadedFiles().
+     *
+     * @param requests
+     * @return std::vector<absl::optional<PreloadedFileHandle>> the preloaded
+     *                                          data of each requested file, or
+     *                                          nothing if it could not be preloaded
+     */
+    std::vector<absl::optional<PreloadedFileHandle>> readPreloadedFiles(absl::Span<const PreloadRequest> requests) const noexcept;
+    /**
+     * @brief Probe and preload files of another sample table and root
+     * directory than the current ones, e.g. for an instrument that is
+     * prepared while the current one plays.
+     *
+     * @param requests
+     * @param table the sample table of the requests
+     * @param directory the root directory of the requested samples
+     * @return std::vector<absl::optional<PreloadedFileHandle>>
+     */
+    std::vector<absl::optional<PreloadedFileHandle>> readPreloadedFiles(absl::Span<const PreloadRequest> requests,
+        const SampleTable& table, const fs::path& directory) const noexcept;
+
+    /**
+     * @brief The second half of preloadFiles(), which adds the preloaded files
+     * to the pool. Don't call it on the audio thread.
+     *
+     * @param requests the requests given to readPreloadedFiles()
+     * @param preloaded the result of readPreloadedFiles()
+     * @return std::vector<absl::optional<FileInformation>>
+     */
+    std::vector<absl::optional<FileInformation>> addPreloadedFiles(absl::Span<const PreloadRequest> requests,
+        std::vector<absl::optional<PreloadedFileHandle>>&& preloaded) noexcept;
+
+    /**
+     * @brief Keep only the preloaded files that are still needed, e.g. when an
+     * instrument is reloaded. A file is kept if it is requested, did not
+     * change on disk, and has enough preloaded frames for the requested
+     * offset; all the other files are dropped. The files are matched by path,
+     * so the requests can come from a new sample table: the kept files are
+     * keyed by the requested identifiers from now on, but the paths of the
+     * previous table must stay valid until this returns. Don't call it on the
+     * audio thread.
+     *
+     * @param requests
+     * @param checkModificationTimes false if the files were found unchanged
+     *                               by findRetainablePreloads() already
+     * @return std::vector<absl::optional<FileInformation>> the information of
+     *                                          each kept file, or nothing if
+     *                                          the file has to be preloaded again
+     */
+    std::vector<absl::optional<FileInformation>> retainPreloadedFiles(absl::Span<const PreloadRequest> requests,
+        bool checkModificationTimes = true) noexcept;
+    /**
+     * @brief Find the preloaded files that retainPreloadedFiles() would keep
+     * for some requests, without changing the pool. The requests can come from
+     * another sample table and root directory than the current ones. Don't
+     * call it on the audio thread.
+     *
+     * @param requests
+     * @param table the sample table of the requests
+     * @param directory the root directory of the requested samples
+     * @return std::vector<absl::optional<FileInformation>> the information of
+     *                                          each file that would be kept
+     */
+    std::vector<absl::optional<FileInformation>> findRetainablePreloads(absl::Span<const PreloadRequest> requests,
+        const SampleTable& table, const fs::path& directory) noexcept;
 
     /**
      * @brief Check that the sample exists. If not, try to find it in a case insensitive way.
@@ -164,7 +515,17 @@ public:
      * @return true if the sample exists or was updated properly
      * @return false if no sample was found even with a case insensitive search
      */
-    bool checkSample(std::string& filename) const noexcept;
+    bool checkSample(std::string& filename) const noexcept { return checkSample(filename, rootDirectory); }
+    /**
+     * @brief Check that the sample exists in a directory other than the root
+     * directory. If not, try to find it in a case insensitive way.
+     *
+     * @param filename the sample filename; may be updated by the method
+     * @param directory
+     * @return true if the sample exists or was updated properly
+     * @return false if no sample was found even with a case insensitive search
+     */
+    bool checkSample(std::string& filename, const fs::path& directory) const noexcept;
 
     /**
      * @brief Clear all preloaded files.
@@ -181,10 +542,16 @@ public:
     /**
      * @brief Get a file promise
      *
-     * @param filename the file to preload
+     * @param sample the file to preload
+     * @param loop the loop points if the sample is played looping, which
+     *             are followed when streaming the file
+     * @param offset the position at which the voice starts reading the file
+     * @param pitchRatio the playback speed of the file; this is used along
+     *                   with the offset to schedule the background loading
      * @return FilePromisePtr a file promise
      */
-    FilePromisePtr getFilePromise(const std::string& filename) noexcept;
+    FilePromisePtr getFilePromise(SampleId sample, absl::optional<Range<uint32_t>> loop = {},
+        uint32_t offset = 0, float pitchRatio = 1.0f) noexcept;
     /**
      * @brief Change the preloading size. This will trigger a full
      * reload of all samples, so don't call it on the audio thread.
@@ -198,6 +565,44 @@ public:
      * @return uint32_t
      */
     uint32_t getPreloadSize() const noexcept;
+    /**
+     * @brief Keep the file information and preloaded data of the samples in
+     * an on-disk cache, so that they are not decoded again the next time the
+     * same samples are preloaded. An empty path disables the cache.
+     *
+     * @param directory
+     */
+    void setPreloadCacheDirectory(const fs::path& directory);
+    /**
+     * @brief Set the memory budget of the preloaded data, in bytes. The least
+     * recently used preloads are evicted to fit in the budget, and their
+     * samples are then streamed from disk. A budget of 0, which is the
+     * default, means that the preloads are never evicted. The budget only
+     * applies without oversampling, as the evicted samples are streamed.
+     * Don't call it on the audio thread.
+     *
+     * @param budget
+     */
+    void setMemoryBudget(size_t budget) noexcept;
+    /**
+     * @brief Get the memory budget of the preloaded data, in bytes
+     *
+     * @return size_t
+     */
+    size_t getMemoryBudget() const noexcept { return memoryBudget; }
+    /**
+     * @brief Get the size of the preloaded data currently held by the pool, in bytes
+     *
+     * @return size_t
+     */
+    size_t getPreloadedBytes() noexcept;
+    /**
+     * @brief Get the number of promises that were served by the cold path
+     * because the preload of their sample was evicted.
+     *
+     * @return size_t
+     */
+    size_t getNumColdLoads() const noexcept { return numColdLoads; }
     /**
      * @brief Set the oversampling factor. This will trigger a full
      * reload of all samples so don't call it on the audio thread.
@@ -213,8 +618,9 @@ public:
     Oversampling getOversamplingFactor() const noexcept;
     /**
      * @brief Empty the file loading queues without actually loading
-     * the files. All promises will be unfulfilled. Don't call this
-     * method on the audio thread as it will spinlock.
+     * the files. The promises only hold their preloaded data, and go
+     * back to the pool once released. Don't call this method on the
+     * audio thread as it will spinlock.
      *
      */
     void emptyFileLoadingQueues() noexcept;
@@ -225,18 +631,49 @@ public:
     void waitForBackgroundLoading() noexcept;
 private:
     Logger& logger;
+    const SampleTable* sampleTable;
     fs::path rootDirectory;
     void loadingThread() noexcept;
     void clearingThread();
     void tryToClearPromises();
+    void tryToClearFileData(FileData& fileData);
+    void enforceMemoryBudget() noexcept;
+    bool isRetainable(const PreloadedFileHandle& handle, const fs::path& file, uint32_t maxOffset, bool checkModificationTime) const noexcept;
+    void waitForPreloadReaders() const noexcept;
+    void fillStream(FilePromise& promise) noexcept;
+    void loadFile(FilePromise& promise) noexcept;
+    void loadBatch(IOBackend& backend, absl::Span<FilePromisePtr> promises) noexcept;
+    void finishLoading(const FilePromisePtr& promise) noexcept;
+    /**
+     * @brief Drop a queued promise without loading it, when emptying the queues
+     *
+     * @param promise
+     */
+    void dropPromise(const FilePromisePtr& promise) noexcept;
+    void pushFilledPromise(const FilePromisePtr& promise) noexcept;
+    void queueStreamRefills() noexcept;
+
+    void setDeadline(FilePromise& promise, uint32_t availableFrames) noexcept;
+    void popEarliestPromises(std::vector<FilePromisePtr>& promises, size_t maxPromises) noexcept;
 
     atomic_queue::AtomicQueue2<FilePromisePtr, config::maxVoices> promiseQueue;
     atomic_queue::AtomicQueue2<FilePromisePtr, config::maxVoices> filledPromiseQueue;
+    // Promises moved out of promiseQueue by the loading threads, ordered by deadline
+    std::vector<FilePromisePtr> promiseHeap;
+    std::mutex promiseHeapMutex;
+    // Posted once per queued promise, and to wake up the threads for other signals
+    RTSemaphore loadingSemaphore;
+    RTSemaphore clearingSemaphore;
     uint32_t preloadSize { config::preloadSize };
+    std::unique_ptr<PreloadCache> preloadCache;
+    std::atomic<size_t> memoryBudget { 0 };
+    std::atomic<size_t> numColdLoads { 0 };
+    std::atomic<bool> readmissionPending { false };
+    uint64_t useCounter { 0 };
     Oversampling oversamplingFactor { config::defaultOversamplingFactor };
     // Signals
-    bool quitThread { false };
-    bool emptyQueue { false };
+    std::atomic<bool> quitThread { false };
+    std::atomic<bool> emptyQueue { false };
     std::atomic<int> threadsLoading { 0 };
 
     // File promises data structures along with their guards.
@@ -246,7 +683,13 @@ private:
     std::atomic<bool> addingPromisesToClear { false };
     std::atomic<bool> canAddPromisesToClear { true };
 
-    absl::flat_hash_map<absl::string_view, PreloadedFileHandle> preloadedFiles;
+    absl::flat_hash_map<SampleId, PreloadedFileHandle> preloadedFiles;
+    // Serializes the changes to the preloaded files between the clearing
+    // thread and the other non-audio threads. The audio thread never waits:
+    // evictions publish new preloads, and the replaced ones are released once
+    // the audio thread is seen outside of its reads.
+    std::mutex preloadMutex;
+    std::atomic<bool> readingPreloads { false };
     std::vector<std::thread> threadPool { };
     LEAK_DETECTOR(FilePool);
 };
@@ -0,0 +1,369 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "IOBackend.h"
+#include "Config.h"
+#include "Debug.h"
+#include <cerrno>
+#include <utility>
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if SFIZZ_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#endif
+
+sfz::ReadableFile::ReadableFile(const fs::path& file) noexcept
+{
+#if defined(_WIN32)
+    fileDescriptor = _wopen(file.wstring().c_str(), _O_RDONLY | _O_BINARY);
+#else
+    fileDescriptor = ::open(file.string().c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+}
+
+sfz::ReadableFile::~ReadableFile()
+{
+    close();
+}
+
+sfz::ReadableFile::ReadableFile(ReadableFile&& other) noexcept
+: fileDescriptor(std::exchange(other.fileDescriptor, -1))
+{
+}
+
+sfz::ReadableFile& sfz::ReadableFile::operator=(ReadableFile&& other) noexcept
+{
+    if (this != &other) {
+        close();
+        fileDescriptor = std::exchange(other.fileDescriptor, -1);
+    }
+    return *this;
+}
+
+void sfz::ReadableFile::close() noexcept
+{
+    if (fileDescriptor < 0)
+        return;
+
+#if defined(_WIN32)
+    _close(fileDescriptor);
+#else
+    ::close(fileDescriptor);
+#endif
+    fileDescriptor = -1;
+}
+
+namespace {
+int64_t readAt(int fileDescriptor, uint64_t offset, uint8_t* buffer, uint32_t size) noexcept
+{
+#if defined(_WIN32)
+    // Each file descriptor is only used by one thread at a time; the file
+    // offset is restored so that it behaves like pread()
+    const auto position = _telli64(fileDescriptor);
+    if (position < 0 || _lseeki64(fileDescriptor, static_cast<__int64>(offset), SEEK_SET) < 0)
+        return -errno;
+    const auto result = _read(fileDescriptor, buffer, size);
+    const auto error = errno;
+    _lseeki64(fileDescriptor, position, SEEK_SET);
+    return result < 0 ? -error : result;
+#else
+    ssize_t result;
+    do {
+        result = ::pread(fileDescriptor, buffer, size, static_cast<off_t>(offset));
+    } while (result < 0 && errno == EINTR);
+    return result < 0 ? -errno : result;
+#endif
+}
+}
+
+int64_t sfz::ReadableFile::readAt(uint64_t offset, uint8_t* buffer, uint32_t size) const noexcept
+{
+    return ::readAt(fileDescriptor, offset, buffer, size);
+}
+
+uint64_t sfz::ReadableFile::size() const noexcept
+{
+#if defined(_WIN32)
+    struct _stat64 status;
+    if (_fstat64(fileDescriptor, &status) != 0)
+        return 0;
+#else
+    struct stat status;
+    if (::fstat(fileDescriptor, &status) != 0)
+        return 0;
+#endif
+    return static_cast<uint64_t>(status.st_size);
+}
+
+void sfz::BlockingIOBackend::read(absl::Span<const ReadRequest> requests, const CompletionCallback& onCompletion) noexcept
+{
+    for (size_t index = 0; index < requests.size(); ++index) {
+        const auto& request = requests[index];
+        uint32_t done { 0 };
+        int64_t result { 0 };
+        while (done < request.size) {
+            result = readAt(request.fileDescriptor, request.offset + done, request.buffer + done, request.size - done);
+            if (result <= 0)
+                break;
+            done += static_cast<uint32_t>(result);
+        }
+        onCompletion(index, result < 0 ? result : done);
+    }
+}
+
+#if SFIZZ_IO_URING
+namespace {
+int setupRing(unsigned entries, io_uring_params& params) noexcept
+{
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+}
+
+int enterRing(int ringDescriptor, unsigned toSubmit, unsigned minCompletions, unsigned flags) noexcept
+{
+    return static_cast<int>(syscall(__NR_io_uring_enter, ringDescriptor, toSubmit, minCompletions, flags, nullptr, 0));
+}
+
+void* mapRing(int ringDescriptor, size_t size, off_t offset) noexcept
+{
+    auto* pointer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringDescriptor, offset);
+    return pointer == MAP_FAILED ? nullptr : pointer;
+}
+
+template <class T>
+T* atOffset(void* base, uint32_t offset) noexcept
+{
+    return reinterpret_cast<T*>(static_cast<uint8_t*>(base) + offset);
+}
+}
+
+std::unique_ptr<sfz::IOUringBackend> sfz::IOUringBackend::create(unsigned queueDepth)
+{
+    std::unique_ptr<IOUringBackend> backend { new IOUringBackend };
+    if (!backend->setup(queueDepth))
+        return {};
+
+    return backend;
+}
+
+bool sfz::IOUringBackend::setup(unsigned queueDepth) noexcept
+{
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ringDescriptor = setupRing(queueDepth, params);
+    if (ringDescriptor < 0) {
+        DBG("[sfizz] io_uring is not available (error " << errno << "), using blocking reads");
+        return false;
+    }
+
+    // Kernels with fast poll also have the plain read operation
+    if ((params.features & IORING_FEAT_FAST_POLL) == 0) {
+        DBG("[sfizz] io_uring is too old, using blocking reads");
+        return false;
+    }
+
+    numEntries = params.sq_entries;
+    submissionRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap) {
+        submissionRingSize = std::max(submissionRingSize, completionRingSize);
+        completionRingSize = 0;
+    }
+
+    submissionRing = mapRing(ringDescriptor, submissionRingSize, IORING_OFF_SQ_RING);
+    if (submissionRing == nullptr)
+        return false;
+
+    if (singleMap) {
+        completionRing = submissionRing;
+    } else {
+        completionRing = mapRing(ringDescriptor, completionRingSize, IORING_OFF_CQ_RING);
+        if (completionRing == nullptr)
+            return false;
+    }
+
+    submissionEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+    submissionEntries = mapRing(ringDescriptor, submissionEntriesSize, IORING_OFF_SQES);
+    if (submissionEntries == nullptr)
+        return false;
+
+    submissionHead = atOffset<unsigned>(submissionRing, params.sq_off.head);
+    submissionTail = atOffset<unsigned>(submissionRing, params.sq_off.tail);
+    submissionMask = atOffset<unsigned>(submissionRing, params.sq_off.ring_mask);
+    submissionArray = atOffset<unsigned>(submissionRing, params.sq_off.array);
+    completionHead = atOffset<unsigned>(completionRing, params.cq_off.head);
+    completionTail = atOffset<unsigned>(completionRing, params.cq_off.tail);
+    completionMask = atOffset<unsigned>(completionRing, params.cq_off.ring_mask);
+    completionEntries = atOffset<void>(completionRing, params.cq_off.cqes);
+    return true;
+}
+
+sfz::IOUringBackend::~IOUringBackend()
+{
+    if (submissionEntries != nullptr)
+        munmap(submissionEntries, submissionEntriesSize);
+    if (completionRing != nullptr && completionRing != submissionRing)
+        munmap(completionRing, completionRingSize);
+    if (submissionRing != nullptr)
+        munmap(submissionRing, submissionRingSize);
+    if (ringDescriptor >= 0)
+        ::close(ringDescriptor);
+}
+
+void sfz::IOUringBackend::queueRead(size_t index, int fileDescriptor, uint64_t offset, uint32_t size, uint8_t* buffer) noexcept
+{
+    // Only this thread writes the tail; the kernel reads it
+    const auto tail = *submissionTail;
+    const auto slot = tail & *submissionMask;
+    auto& entry = static_cast<io_uring_sqe*>(submissionEntries)[slot];
+    std::memset(&entry, 0, sizeof(entry));
+    entry.opcode = IORING_OP_READ;
+    entry.fd = fileDescriptor;
+    entry.addr = reinterpret_cast<uint64_t>(buffer);
+    entry.len = size;
+    entry.off = offset;
+    entry.user_data = index;
+    submissionArray[slot] = slot;
+    __atomic_store_n(submissionTail, tail + 1, __ATOMIC_RELEASE);
+    numQueued++;
+}
+
+int sfz::IOUringBackend::enter(unsigned toSubmit, unsigned minCompletions, unsigned flags) noexcept
+{
+    return enterRing(ringDescriptor, toSubmit, minCompletions, flags);
+}
+
+bool sfz::IOUringBackend::submitAndWait(unsigned minCompletions) noexcept
+{
+    while (true) {
+        const auto result = enter(numQueued, minCompletions, IORING_ENTER_GETEVENTS);
+        if (result >= 0) {
+            numQueued -= std::min(numQueued, static_cast<unsigned>(result));
+            if (numQueued == 0)
+                return true;
+            continue;
+        }
+
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            DBG("[sfizz] io_uring_enter failed with error " << errno);
+            return false;
+        }
+    }
+}
+
+template <class Function>
+unsigned sfz::IOUringBackend::reapCompletions(Function&& function) noexcept
+{
+    auto head = *completionHead;
+    const auto tail = __atomic_load_n(completionTail, __ATOMIC_ACQUIRE);
+    const auto numCompletions = tail - head;
+    for (; head != tail; ++head) {
+        const auto& completion = static_cast<io_uring_cqe*>(completionEntries)[head & *completionMask];
+        function(static_cast<size_t>(completion.user_data), completion.res);
+    }
+    __atomic_store_n(completionHead, head, __ATOMIC_RELEASE);
+    return numCompletions;
+}
+
+unsigned sfz::IOUringBackend::unqueueReads(const CompletionCallback& onCompletion) noexcept
+{
+    // The kernel only consumes entries within io_uring_enter, so the ones
+    // past its head can be taken back by moving the tail
+    const auto head = __atomic_load_n(submissionHead, __ATOMIC_ACQUIRE);
+    const auto tail = *submissionTail;
+    for (auto position = head; position != tail; ++position) {
+        const auto slot = submissionArray[position & *submissionMask];
+        onCompletion(static_cast<size_t>(static_cast<io_uring_sqe*>(submissionEntries)[slot].user_data), -EIO);
+    }
+    __atomic_store_n(submissionTail, head, __ATOMIC_RELEASE);
+    numQueued = 0;
+    return tail - head;
+}
+
+void sfz::IOUringBackend::abandonReads(unsigned numInFlight, const CompletionCallback& onCompletion) noexcept
+{
+    while (numInFlight > 0) {
+        // The completions are posted to the ring even if waiting fails
+        if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        numInFlight -= reapCompletions([&](size_t index, int) {
+            onCompletion(index, -EIO);
+        });
+    }
+}
+
+void sfz::IOUringBackend::read(absl::Span<const ReadRequest> requests, const CompletionCallback& onCompletion) noexcept
+{
+    bytesDone.assign(requests.size(), 0);
+    size_t nextRequest { 0 };
+    size_t numCompleted { 0 };
+    unsigned numInFlight { 0 };
+
+    auto queueRequest = [&](size_t index) {
+        const auto& request = requests[index];
+        const auto done = bytesDone[index];
+        queueRead(index, request.fileDescriptor, request.offset + done, request.size - done, request.buffer + done);
+    };
+
+    while (numCompleted < requests.size()) {
+        while (nextRequest < requests.size() && numInFlight < numEntries) {
+            queueRequest(nextRequest++);
+            numInFlight++;
+        }
+
+        if (!submitAndWait(1)) {
+            // No read of the batch may remain in the ring once this returns,
+            // since the buffers and the indices are only valid for this call
+            numInFlight -= unqueueReads(onCompletion);
+            abandonReads(numInFlight, onCompletion);
+            for (; nextRequest < requests.size(); ++nextRequest)
+                onCompletion(nextRequest, -EIO);
+            return;
+        }
+
+        reapCompletions([&](size_t index, int result) {
+            ASSERT(index < requests.size());
+            const auto& request = requests[index];
+            if (result > 0 && bytesDone[index] + static_cast<uint32_t>(result) < request.size) {
+                // Short read, queue the rest of the request
+                bytesDone[index] += static_cast<uint32_t>(result);
+                queueRequest(index);
+                return;
+            }
+
+            if (result > 0)
+                bytesDone[index] += static_cast<uint32_t>(result);
+
+            onCompletion(index, result < 0 ? result : bytesDone[index]);
+            numCompleted++;
+            numInFlight--;
+        });
+    }
+}
+#endif
+
+std::unique_ptr<sfz::IOBackend> sfz::createIOBackend()
+{
+#if SFIZZ_IO_URING
+    if (auto backend = IOUringBackend::create(config::ioQueueDepth))
+        return backend;
+#endif
+    return std::make_unique<BlockingIOBackend>();
+}
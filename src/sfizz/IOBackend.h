@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "ghc/fs_std.hpp"
+#include <absl/types/span.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace sfz {
+/**
+ * @brief A file opened for reading through an IOBackend, closed on destruction.
+ */
+class ReadableFile {
+public:
+    ReadableFile() = default;
+    explicit ReadableFile(const fs::path& file) noexcept;
+    ~ReadableFile();
+    ReadableFile(ReadableFile&& other) noexcept;
+    ReadableFile& operator=(ReadableFile&& other) noexcept;
+    ReadableFile(const ReadableFile&) = delete;
+    ReadableFile& operator=(const ReadableFile&) = delete;
+
+    int descriptor() const noexcept { return fileDescriptor; }
+    explicit operator bool() const noexcept { return fileDescriptor >= 0; }
+    /**
+     * @brief Read from the file at a given position, without moving the file
+     * offset.
+     *
+     * @param offset
+     * @param buffer
+     * @param size
+     * @return int64_t the number of bytes read, or a negative error code
+     */
+    int64_t readAt(uint64_t offset, uint8_t* buffer, uint32_t size) const noexcept;
+    /**
+     * @brief Get the size of the file in bytes, or 0 on error
+     */
+    uint64_t size() const noexcept;
+private:
+    void close() noexcept;
+    int fileDescriptor { -1 };
+};
+
+struct ReadRequest
+{
+    int fileDescriptor { -1 };
+    uint64_t offset { 0 };
+    uint32_t size { 0 };
+    uint8_t* buffer { nullptr };
+};
+
+/**
+ * @brief Reads batches of file chunks for the loading threads.
+ *
+ * A backend instance is used by a single thread. All the requests of a batch
+ * are read before read() returns, but the completion callback is called as
+ * soon as each of them is done so that the data can be decoded while the other
+ * reads are in flight.
+ */
+class IOBackend {
+public:
+    /**
+     * @brief Completion callback, called with the index of the request in the
+     * batch and the number of bytes read, or a negative error code.
+     */
+    using CompletionCallback = std::function<void(size_t, int64_t)>;
+
+    virtual ~IOBackend() = default;
+    /**
+     * @brief Read a batch of requests.
+     *
+     * @param requests
+     * @param onCompletion
+     */
+    virtual void read(absl::Span<const ReadRequest> requests, const CompletionCallback& onCompletion) noexcept = 0;
+    /**
+     * @brief Get the name of the backend, for logging and benchmarking purposes
+     */
+    virtual const char* name() const noexcept = 0;
+};
+
+/**
+ * @brief Reads the requests one after the other with blocking calls.
+ * The parallelism comes from the number of loading threads.
+ */
+class BlockingIOBackend : public IOBackend {
+public:
+    void read(absl::Span<const ReadRequest> requests, const CompletionCallback& onCompletion) noexcept override;
+    const char* name() const noexcept override { return "blocking"; }
+};
+
+#if SFIZZ_IO_URING
+/**
+ * @brief Submits all the requests of a batch at once to an io_uring instance,
+ * keeping up to a fixed number of reads in flight.
+ */
+class IOUringBackend : public IOBackend {
+public:
+    /**
+     * @brief Create an io_uring backend
+     *
+     * @param queueDepth the maximum number of reads in flight
+     * @return std::unique_ptr<IOUringBackend> the backend, or null if io_uring
+     *                                         is not available on the system
+     */
+    static std::unique_ptr<IOUringBackend> create(unsigned queueDepth);
+    ~IOUringBackend();
+    void read(absl::Span<const ReadRequest> requests, const CompletionCallback& onCompletion) noexcept override;
+    const char* name() const noexcept override { return "io_uring"; }
+protected:
+    IOUringBackend() = default;
+    /**
+     * @brief Set up the ring
+     *
+     * @param queueDepth the maximum number of reads in flight
+     * @return true if io_uring is available on the system
+     */
+    bool setup(unsigned queueDepth) noexcept;
+    /**
+     * @brief Submit the queued entries and wait for completions, as the
+     * io_uring_enter system call does.
+     *
+     * @param toSubmit
+     * @param minCompletions
+     * @param flags
+     * @return int the number of entries submitted, or -1 with errno set
+     */
+    virtual int enter(unsigned toSubmit, unsigned minCompletions, unsigned flags) noexcept;
+private:
+    void queueRead(size_t index, int fileDescriptor, uint64_t offset, uint32_t size, uint8_t* buffer) noexcept;
+    bool submitAndWait(unsigned minCompletions) noexcept;
+    /**
+     * @brief Take back the entries that the kernel did not consume yet,
+     * completing their requests with an error.
+     *
+     * @param onCompletion
+     * @return unsigned the number of entries taken back
+     */
+    unsigned unqueueReads(const CompletionCallback& onCompletion) noexcept;
+    /**
+     * @brief Wait for the reads in flight and complete them with an error, so
+     * that the kernel does not write into the buffers of the batch anymore.
+     *
+     * @param numInFlight
+     * @param onCompletion
+     */
+    void abandonReads(unsigned numInFlight, const CompletionCallback& onCompletion) noexcept;
+    template <class Function>
+    unsigned reapCompletions(Function&& function) noexcept;
+
+    int ringDescriptor { -1 };
+    unsigned numEntries { 0 };
+    unsigned numQueued { 0 };
+    void* submissionRing { nullptr };
+    size_t submissionRingSize { 0 };
+    void* completionRing { nullptr };
+    size_t completionRingSize { 0 };
+    void* submissionEntries { nullptr };
+    size_t submissionEntriesSize { 0 };
+    unsigned* submissionHead { nullptr };
+    unsigned* submissionTail { nullptr };
+    unsigned* submissionMask { nullptr };
+    unsigned* submissionArray { nullptr };
+    unsigned* completionHead { nullptr };
+    unsigned* completionTail { nullptr };
+    unsigned* completionMask { nullptr };
+    void* completionEntries { nullptr };
+    std::vector<uint32_t> bytesDone;
+};
+#endif
+
+/**
+ * @brief Create the best backend available on the system: io_uring if the
+ * kernel supports it, and blocking reads otherwise.
+ *
+ * @return std::unique_ptr<IOBackend>
+ */
+std::unique_ptr<IOBackend> createIOBackend();
+}
@@ -0,0 +1,406 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "InstrumentCache.h"
+#include "CacheFile.h"
+#include "Debug.h"
+#include "MappedFile.h"
+#include "absl/strings/str_cat.h"
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <initializer_list>
+#include <random>
+#include <type_traits>
+
+namespace {
+constexpr char entryMagic[8] { 'S', 'F', 'Z', 'I', 'N', 'S', 'T', 'R' };
+constexpr uint32_t entryVersion { 2 };
+
+/**
+ * @brief Writes values in an entry. Trivially copyable values are written as
+ * they are in memory.
+ */
+class EntryWriter {
+public:
+    template <class... Values>
+    void operator()(Values&&... values)
+    {
+        (void)std::initializer_list<int> { (write(values), 0)... };
+    }
+    const std::string& data() const noexcept { return buffer; }
+private:
+    template <class T>
+    std::enable_if_t<std::is_trivially_copyable<T>::value> write(const T& value)
+    {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    template <class T, class U>
+    void write(const std::pair<T, U>& pair) { (*this)(pair.first, pair.second); }
+    template <class T>
+    void write(const absl::optional<T>& optional)
+    {
+        write(optional.has_value());
+        if (optional)
+            write(*optional);
+    }
+    template <class T>
+    void write(const std::vector<T>& vector)
+    {
+        write(static_cast<uint64_t>(vector.size()));
+        for (const auto& value : vector)
+            write(value);
+    }
+    template <class T, size_t N>
+    void write(const std::array<T, N>& array)
+    {
+        for (const auto& value : array)
+            write(value);
+    }
+    template <class Key, class T>
+    void write(const absl::flat_hash_map<Key, T>& map)
+    {
+        write(static_cast<uint64_t>(map.size()));
+        for (const auto& element : map)
+            (*this)(element.first, element.second);
+    }
+    void write(const std::string& string)
+    {
+        write(static_cast<uint64_t>(string.size()));
+        buffer.append(string);
+    }
+    template <size_t N>
+    void write(const std::bitset<N>& bits)
+    {
+        for (size_t i = 0; i < N; ++i)
+            write(bits.test(i));
+    }
+    template <class T>
+    void write(const std::uniform_real_distribution<T>& distribution) { (*this)(distribution.a(), distribution.b()); }
+    template <class T>
+    void write(const std::uniform_int_distribution<T>& distribution) { (*this)(distribution.a(), distribution.b()); }
+    template <class T>
+    void write(sfz::CCMap<T>& map) { map.serialize(*this); }
+    void write(sfz::EGDescription& description) { description.serialize(*this); }
+
+    std::string buffer;
+};
+
+/**
+ * @brief Reads values from an entry. Reading past the end of the entry, or
+ * reading a container larger than what remains, fails the reader; the values
+ * read afterwards are left as they are.
+ */
+class EntryReader {
+public:
+    EntryReader(const uint8_t* data, size_t size)
+    : position(data), end(data + size) {}
+
+    template <class... Values>
+    void operator()(Values&&... values)
+    {
+        (void)std::initializer_list<int> { (read(values), 0)... };
+    }
+    bool failed() const noexcept { return hasFailed; }
+    bool atEnd() const noexcept { return position == end; }
+private:
+    bool canRead(uint64_t size) noexcept
+    {
+        if (hasFailed || size > static_cast<uint64_t>(end - position))
+            hasFailed = true;
+        return !hasFailed;
+    }
+    template <class T>
+    std::enable_if_t<std::is_trivially_copyable<T>::value> read(T& value)
+    {
+        if (!canRead(sizeof(T)))
+            return;
+
+        std::memcpy(&value, position, sizeof(T));
+        position += sizeof(T);
+    }
+    template <class T, class U>
+    void read(std::pair<T, U>& pair) { (*this)(pair.first, pair.second); }
+    template <class T>
+    void read(absl::optional<T>& optional)
+    {
+        bool hasValue { false };
+        read(hasValue);
+        if (!hasValue) {
+            optional.reset();
+            return;
+        }
+
+        T value {};
+        read(value);
+        optional = value;
+    }
+    template <class T>
+    void read(std::vector<T>& vector)
+    {
+        uint64_t size { 0 };
+        read(size);
+        // Every element takes at least a byte
+        if (!canRead(size))
+            return;
+
+        vector.resize(static_cast<size_t>(size));
+        for (auto& value : vector)
+            read(value);
+    }
+    template <class T, size_t N>
+    void read(std::array<T, N>& array)
+    {
+        for (auto& value : array)
+            read(value);
+    }
+    template <class Key, class T>
+    void read(absl::flat_hash_map<Key, T>& map)
+    {
+        uint64_t size { 0 };
+        read(size);
+        for (uint64_t index = 0; index < size && !hasFailed; ++index) {
+            std::pair<Key, T> element;
+            read(element);
+            map.insert_or_assign(std::move(element.first), std::move(element.second));
+        }
+    }
+    void read(std::string& string)
+    {
+        uint64_t size { 0 };
+        read(size);
+        if (!canRead(size))
+            return;
+
+        string.assign(reinterpret_cast<const char*>(position), static_cast<size_t>(size));
+        position += size;
+    }
+    template <size_t N>
+    void read(std::bitset<N>& bits)
+    {
+        for (size_t i = 0; i < N; ++i) {
+            bool bit { false };
+            read(bit);
+            bits.set(i, bit);
+        }
+    }
+    template <class T>
+    void read(std::uniform_real_distribution<T>& distribution)
+    {
+        T a { distribution.a() };
+        T b { distribution.b() };
+        (*this)(a, b);
+        distribution.param(typename std::uniform_real_distribution<T>::param_type(a, b));
+    }
+    template <class T>
+    void read(std::uniform_int_distribution<T>& distribution)
+    {
+        T a { distribution.a() };
+        T b { distribution.b() };
+        (*this)(a, b);
+        distribution.param(typename std::uniform_int_distribution<T>::param_type(a, b));
+    }
+    template <class T>
+    void read(sfz::CCMap<T>& map) { map.serialize(*this); }
+    void read(sfz::EGDescription& description) { description.serialize(*this); }
+
+    const uint8_t* position;
+    const uint8_t* end;
+    bool hasFailed { false };
+};
+
+/**
+ * @brief Counts the members a region serializes, without reading them
+ */
+struct MemberCounter {
+    template <class... Values>
+    void operator()(Values&&...) noexcept { numMembers += sizeof...(Values); }
+    uint32_t numMembers { 0 };
+};
+
+/**
+ * @brief The layout of the regions in this build. The regions are written
+ * member by member, with the trivially copyable members as they are in memory,
+ * so an entry is only read if it was written with the same layout; this
+ * catches the changes to the members that did not bump the entry version.
+ */
+struct RegionLayout
+{
+    uint64_t regionSize { sizeof(sfz::Region) };
+    uint64_t egDescriptionSize { sizeof(sfz::EGDescription) };
+    uint32_t numMembers { 0 };
+};
+
+const RegionLayout& regionLayout()
+{
+    static const RegionLayout layout = []() {
+        sfz::MidiState midiState;
+        sfz::SampleTable sampleTable;
+        sfz::Region region { midiState, sampleTable };
+        MemberCounter counter;
+        region.serialize(counter);
+        RegionLayout layout;
+        layout.numMembers = counter.numMembers;
+        return layout;
+    }();
+    return layout;
+}
+
+bool validIndices(const std::vector<uint32_t>& indices, size_t numRegions) noexcept
+{
+    return std::all_of(indices.begin(), indices.end(), [numRegions](uint32_t index) { return index < numRegions; });
+}
+}
+
+void sfz::ActivationLists::build(const std::vector<std::unique_ptr<Region>>& regions)
+{
+    clear();
+    for (size_t index = 0; index < regions.size(); ++index) {
+        const auto& region = *regions[index];
+        const auto regionIndex = static_cast<uint32_t>(index);
+        for (int note = 0; note < 128; note++) {
+            if (region.keyRange.containsWithEnd(note) ||
+                (region.hasKeyswitches() && region.keyswitchRange.containsWithEnd(note)))
+                notes[note].push_back(regionIndex);
+        }
+
+        for (int cc = 0; cc < config::numCCs; cc++) {
+            if (region.ccTriggers.contains(cc) || region.ccConditions.contains(cc))
+                ccTriggers[cc].push_back(regionIndex);
+            if (region.isModulatedByCC(cc))
+                ccModulations[cc].push_back(regionIndex);
+        }
+    }
+}
+
+void sfz::ActivationLists::clear() noexcept
+{
+    for (auto& list : notes)
+        list.clear();
+    for (auto& list : ccTriggers)
+        list.clear();
+    for (auto& list : ccModulations)
+        list.clear();
+}
+
+sfz::InstrumentCache::InstrumentCache(const fs::path& directory)
+: directory(directory)
+{
+    createCacheDirectory(directory);
+}
+
+fs::path sfz::InstrumentCache::entryPath(const fs::path& file) const
+{
+    return directory / absl::StrCat(cacheEntryName(file), ".instrument");
+}
+
+bool sfz::InstrumentCache::load(const fs::path& file, CompiledInstrument& instrument, const MidiState& midiState, SampleTable& sampleTable) const noexcept
+{
+    MappedFile mapped { entryPath(file) };
+    EntryReader reader { mapped.data(), mapped.size() };
+    char magic[sizeof(entryMagic)] {};
+    uint32_t version { 0 };
+    RegionLayout layout;
+    std::string filename;
+    reader(magic, version, layout.regionSize, layout.egDescriptionSize, layout.numMembers, filename);
+    const auto& expectedLayout = regionLayout();
+    if (reader.failed() || std::memcmp(magic, entryMagic, sizeof(entryMagic)) != 0 || version != entryVersion
+        || layout.regionSize != expectedLayout.regionSize || layout.egDescriptionSize != expectedLayout.egDescriptionSize
+        || layout.numMembers != expectedLayout.numMembers || filename != file.string())
+        return false;
+
+    uint64_t numIncludedFiles { 0 };
+    reader(numIncludedFiles);
+    for (uint64_t index = 0; index < numIncludedFiles && !reader.failed(); ++index) {
+        std::string includedFile;
+        FileStatus cachedStatus;
+        FileStatus status;
+        reader(includedFile, cachedStatus.size, cachedStatus.modificationTime);
+        if (reader.failed() || !getFileStatus(includedFile, status)
+            || status.size != cachedStatus.size || status.modificationTime != cachedStatus.modificationTime) {
+            DBG("[sfizz] The instrument cache entry of " << filename << " is out of date");
+            return false;
+        }
+        instrument.includedFiles.emplace_back(includedFile);
+    }
+
+    const auto failed = [&]() {
+        instrument = CompiledInstrument {};
+        sampleTable.clear();
+        return false;
+    };
+
+    std::vector<std::string> samplePaths;
+    uint64_t numRegions { 0 };
+    reader(instrument.defines, samplePaths, numRegions);
+    if (reader.failed())
+        return failed();
+
+    // The sample identifiers of the regions are their index in the table
+    for (size_t index = 0; index < samplePaths.size(); ++index) {
+        if (sampleTable.intern(samplePaths[index]) != index)
+            return failed();
+    }
+
+    for (uint64_t index = 0; index < numRegions && !reader.failed(); ++index) {
+        auto region = std::make_unique<Region>(midiState, sampleTable);
+        region->serialize(reader);
+        if (region->sampleId >= sampleTable.size())
+            return failed();
+        instrument.regions.push_back(std::move(region));
+    }
+
+    auto& lists = instrument.activationLists;
+    reader(lists.notes, lists.ccTriggers, lists.ccModulations);
+    reader(instrument.ccNames, instrument.defaultSwitch, instrument.unknownOpcodes, instrument.ccValues);
+    reader(instrument.numGroups, instrument.numMasters, instrument.numCurves);
+    reader(instrument.noteOffset, instrument.octaveOffset);
+    if (reader.failed() || !reader.atEnd())
+        return failed();
+
+    const auto validLists = [numRegions](const auto& regionLists) {
+        return std::all_of(regionLists.begin(), regionLists.end(), [numRegions](const auto& list) {
+            return validIndices(list, static_cast<size_t>(numRegions));
+        });
+    };
+    if (!validLists(lists.notes) || !validLists(lists.ccTriggers) || !validLists(lists.ccModulations))
+        return failed();
+
+    return true;
+}
+
+bool sfz::InstrumentCache::store(const fs::path& file, const CompiledInstrument& instrument, const SampleTable& sampleTable) const noexcept
+{
+    EntryWriter writer;
+    const auto& layout = regionLayout();
+    writer(entryMagic, entryVersion, layout.regionSize, layout.egDescriptionSize, layout.numMembers, file.string());
+    writer(static_cast<uint64_t>(instrument.includedFiles.size()));
+    for (const auto& includedFile : instrument.includedFiles) {
+        FileStatus status;
+        if (!getFileStatus(includedFile, status))
+            return false;
+        writer(includedFile.string(), status.size, status.modificationTime);
+    }
+
+    std::vector<std::string> samplePaths;
+    samplePaths.reserve(sampleTable.size());
+    for (SampleId id = 0; id < sampleTable.size(); ++id)
+        samplePaths.push_back(sampleTable.getPath(id));
+
+    writer(instrument.defines, samplePaths, static_cast<uint64_t>(instrument.regions.size()));
+    for (const auto& region : instrument.regions)
+        region->serialize(writer);
+
+    const auto& lists = instrument.activationLists;
+    writer(lists.notes, lists.ccTriggers, lists.ccModulations);
+    writer(instrument.ccNames, instrument.defaultSwitch, instrument.unknownOpcodes, instrument.ccValues);
+    writer(instrument.numGroups, instrument.numMasters, instrument.numCurves);
+    writer(instrument.noteOffset, instrument.octaveOffset);
+
+    return writeCacheEntry(entryPath(file), [&](std::ostream& output) {
+        output.write(writer.data().data(), static_cast<std::streamsize>(writer.data().size()));
+    });
+}
@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "Config.h"
+#include "MidiState.h"
+#include "Region.h"
+#include "SampleTable.h"
+#include "SfzHelpers.h"
+#include "ghc/fs_std.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <absl/types/optional.h>
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sfz {
+/**
+ * @brief The regions that each note and each CC concern, by their index in the
+ * regions of an instrument. They only depend on the opcodes of the regions.
+ */
+struct ActivationLists
+{
+    /**
+     * @brief Build the lists of some regions
+     *
+     * @param regions
+     */
+    void build(const std::vector<std::unique_ptr<Region>>& regions);
+    void clear() noexcept;
+
+    // Regions triggered or switched by each note
+    std::array<std::vector<uint32_t>, 128> notes;
+    // Regions triggered or conditioned by each CC
+    std::array<std::vector<uint32_t>, config::numCCs> ccTriggers;
+    // Regions whose voices are modulated by each CC
+    std::array<std::vector<uint32_t>, config::numCCs> ccModulations;
+};
+
+/**
+ * @brief An instrument as built from its SFZ files, before the samples of its
+ * regions are resolved and preloaded.
+ */
+struct CompiledInstrument
+{
+    std::vector<fs::path> includedFiles;
+    absl::flat_hash_map<std::string, std::string> defines;
+    std::vector<std::unique_ptr<Region>> regions;
+    ActivationLists activationLists;
+    std::vector<CCNamePair> ccNames;
+    absl::optional<uint8_t> defaultSwitch;
+    std::vector<std::string> unknownOpcodes;
+    // CC values set by the control headers
+    SfzCCArray ccValues {};
+    int numGroups { 0 };
+    int numMasters { 0 };
+    int numCurves { 0 };
+    int noteOffset { 0 };
+    int octaveOffset { 0 };
+};
+
+/**
+ * @brief On-disk cache of the built instruments, so that loading an instrument
+ * again does not need to parse its files and build its regions.
+ *
+ * Each entry holds the regions of one SFZ file along with their sample paths
+ * and activation lists. Entries are keyed by the path of the file, and are
+ * only used if the size and modification time of every included file did not
+ * change since they were written. They are read back through a memory mapping.
+ */
+class InstrumentCache {
+public:
+    /**
+     * @brief Construct a new cache in a directory, which is created if needed.
+     *
+     * @param directory
+     */
+    InstrumentCache(const fs::path& directory);
+
+    /**
+     * @brief Read the entry of an instrument if it is valid.
+     *
+     * @param file the absolute path of the root SFZ file
+     * @param instrument receives the entry
+     * @param midiState the MIDI state of the read regions
+     * @param sampleTable the empty sample table of the read regions, which
+     *                    receives their sample paths
+     * @return true if there was a valid entry; otherwise the instrument and
+     *              the sample table are left empty
+     */
+    bool load(const fs::path& file, CompiledInstrument& instrument, const MidiState& midiState, SampleTable& sampleTable) const noexcept;
+
+    /**
+     * @brief Write the entry of an instrument, replacing any previous one.
+     *
+     * @param file the absolute path of the root SFZ file
+     * @param instrument
+     * @param sampleTable the sample table of the regions
+     * @return true if the entry was written
+     */
+    bool store(const fs::path& file, const CompiledInstrument& instrument, const SampleTable& sampleTable) const noexcept;
+
+    const fs::path& getDirectory() const noexcept { return directory; }
+private:
+    fs::path entryPath(const fs::path& file) const;
+    fs::path directory;
+};
+}
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "Debug.h"
+#include <iterator>
+
+namespace sfz {
+/**
+ * @brief A doubly linked list whose links are stored in the items, through
+ * IntrusiveList::Node members. Adding and removing an item takes a constant
+ * time and never allocates, which makes it usable on the audio thread.
+ *
+ * An item can be part of as many lists as it has nodes, and each node can be
+ * in at most one list at a time. A node knows its list, so it can unlink
+ * itself; it also unlinks itself when destroyed, and a list unlinks all its
+ * nodes when destroyed.
+ *
+ * The list must not be modified while iterating over it, except for removing
+ * an item once the iterator moved past it.
+ *
+ * @tparam T the type of the items
+ */
+template <class T>
+class IntrusiveList {
+public:
+    class Node {
+    public:
+        explicit Node(T& item) noexcept : item(&item) {}
+        ~Node() { unlink(); }
+        bool isLinked() const noexcept { return list != nullptr; }
+        /**
+         * @brief Remove the node from its list, if any
+         */
+        void unlink() noexcept
+        {
+            if (list != nullptr)
+                list->remove(*this);
+        }
+
+        Node(const Node&) = delete;
+        Node& operator=(const Node&) = delete;
+    private:
+        friend class IntrusiveList;
+        T* item;
+        Node* previous { nullptr };
+        Node* next { nullptr };
+        IntrusiveList* list { nullptr };
+    };
+
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        explicit Iterator(Node* node) noexcept : node(node) {}
+        T& operator*() const noexcept { return *node->item; }
+        T* operator->() const noexcept { return node->item; }
+        Iterator& operator++() noexcept
+        {
+            node = node->next;
+            return *this;
+        }
+        bool operator==(const Iterator& other) const noexcept { return node == other.node; }
+        bool operator!=(const Iterator& other) const noexcept { return node != other.node; }
+    private:
+        Node* node;
+    };
+
+    IntrusiveList() = default;
+    ~IntrusiveList() { clear(); }
+    IntrusiveList(IntrusiveList&& other) noexcept { *this = std::move(other); }
+    IntrusiveList& operator=(IntrusiveList&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        clear();
+        first = other.first;
+        last = other.last;
+        numItems = other.numItems;
+        for (auto node = first; node != nullptr; node = node->next)
+            node->list = this;
+
+        other.first = nullptr;
+        other.last = nullptr;
+        other.numItems = 0;
+        return *this;
+    }
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+    /**
+     * @brief Add a node at the end of the list. The node must not be part
+     * of a list already.
+     *
+     * @param node
+     */
+    void pushBack(Node& node) noexcept
+    {
+        ASSERT(!node.isLinked());
+        node.list = this;
+        node.previous = last;
+        node.next = nullptr;
+        if (last != nullptr)
+            last->next = &node;
+        else
+            first = &node;
+        last = &node;
+        ++numItems;
+    }
+
+    /**
+     * @brief Remove a node of the list
+     *
+     * @param node
+     */
+    void remove(Node& node) noexcept
+    {
+        ASSERT(node.list == this);
+        if (node.previous != nullptr)
+            node.previous->next = node.next;
+        else
+            first = node.next;
+
+        if (node.next != nullptr)
+            node.next->previous = node.previous;
+        else
+            last = node.previous;
+
+        node.list = nullptr;
+        node.previous = nullptr;
+        node.next = nullptr;
+        --numItems;
+    }
+
+    /**
+     * @brief Remove all the nodes of the list
+     */
+    void clear() noexcept
+    {
+        while (first != nullptr)
+            remove(*first);
+    }
+
+    bool empty() const noexcept { return first == nullptr; }
+    size_t size() const noexcept { return numItems; }
+    Iterator begin() const noexcept { return Iterator { first }; }
+    Iterator end() const noexcept { return Iterator { nullptr }; }
+private:
+    Node* first { nullptr };
+    Node* last { nullptr };
+    size_t numItems { 0 };
+};
+}
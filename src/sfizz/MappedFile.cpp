@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "MappedFile.h"
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+sfz::MappedFile::MappedFile(const fs::path& path) noexcept
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return;
+
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            auto* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (view != nullptr) {
+                address = static_cast<const uint8_t*>(view);
+                mappedSize = static_cast<size_t>(fileSize.QuadPart);
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    const int file = ::open(path.string().c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+        return;
+
+    struct stat status;
+    if (::fstat(file, &status) == 0 && status.st_size > 0) {
+        auto* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        if (view != MAP_FAILED) {
+            address = static_cast<const uint8_t*>(view);
+            mappedSize = static_cast<size_t>(status.st_size);
+        }
+    }
+    ::close(file);
+#endif
+}
+
+sfz::MappedFile::~MappedFile()
+{
+    if (address == nullptr)
+        return;
+#if defined(_WIN32)
+    UnmapViewOfFile(address);
+#else
+    munmap(const_cast<uint8_t*>(address), mappedSize);
+#endif
+}
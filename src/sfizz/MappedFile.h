@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "ghc/fs_std.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace sfz {
+/**
+ * @brief A read-only memory mapping of a whole file. The mapping is empty if
+ * the file could not be opened, or if the file is empty.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const fs::path& path) noexcept;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const noexcept { return address; }
+    size_t size() const noexcept { return mappedSize; }
+private:
+    const uint8_t* address { nullptr };
+    size_t mappedSize { 0 };
+};
+}
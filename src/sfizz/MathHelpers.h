@@ -151,6 +151,28 @@ constexpr ValueType linearInterpolation(ValueType left, ValueType right, ValueTy
     return left * leftCoeff + right * rightCoeff;
 }
 
+/**
+ * @brief Cubic Hermite (Catmull-Rom) interpolation between x1 and x2, using
+ * their neighbours x0 and x3.
+ *
+ * @param position the fractional position between x1 and x2
+ */
+template<class ValueType>
+constexpr ValueType hermiteInterpolation(ValueType x0, ValueType x1, ValueType x2, ValueType x3, ValueType position)
+{
+    const auto c1 = static_cast<ValueType>(0.5) * (x2 - x0);
+    const auto c2 = x0 - static_cast<ValueType>(2.5) * x1 + static_cast<ValueType>(2) * x2 - static_cast<ValueType>(0.5) * x3;
+    const auto c3 = static_cast<ValueType>(0.5) * (x3 - x0) + static_cast<ValueType>(1.5) * (x1 - x2);
+    return ((c3 * position + c2) * position + c1) * position + x1;
+}
+
+/**
+ * @brief Convert a stored sample value to float. 16-bit integer samples are
+ * scaled to [-1, 1) as libsndfile does when it reads them as float.
+ */
+constexpr float sampleToFloat(float value) { return value; }
+constexpr float sampleToFloat(int16_t value) { return static_cast<float>(value) * (1.0f / 32768.0f); }
+
 template <class Type>
 constexpr Type pi { static_cast<Type>(3.141592653589793238462643383279502884) };
 template <class Type>
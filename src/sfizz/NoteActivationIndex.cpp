@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "NoteActivationIndex.h"
+#include "absl/algorithm/container.h"
+
+void sfz::NoteActivationIndex::build(absl::Span<Region* const> sourceRegions)
+{
+    // Release regions and regions triggered by a CC only need the note-on to
+    // follow their sequence
+    const auto alwaysCandidate = [](const Region& region) {
+        return region.hasKeyswitches() || region.triggersOnCC()
+            || (region.isRelease() && region.sequenceLength > 1);
+    };
+    const auto neverCandidate = [](const Region& region) { return region.isRelease(); };
+
+    // The buckets start where a velocity range starts or ends
+    std::vector<int> bucketStarts { 0 };
+    for (auto region : sourceRegions) {
+        if (alwaysCandidate(*region) || neverCandidate(*region))
+            continue;
+
+        bucketStarts.push_back(region->velocityRange.getStart());
+        bucketStarts.push_back(region->velocityRange.getEnd() + 1);
+    }
+    absl::c_sort(bucketStarts);
+    bucketStarts.erase(std::unique(bucketStarts.begin(), bucketStarts.end()), bucketStarts.end());
+    while (bucketStarts.back() > 127)
+        bucketStarts.pop_back();
+
+    clear();
+    bucketOffsets.pop_back();
+    for (size_t bucket = 0; bucket < bucketStarts.size(); ++bucket) {
+        const auto velocity = static_cast<uint8_t>(bucketStarts[bucket]);
+        const auto end = bucket + 1 < bucketStarts.size() ? bucketStarts[bucket + 1] : 128;
+        for (auto v = bucketStarts[bucket]; v < end; ++v)
+            velocityBuckets[v] = static_cast<uint8_t>(bucket);
+
+        for (auto region : sourceRegions) {
+            if (alwaysCandidate(*region))
+                addCandidate(region, true);
+            else if (!neverCandidate(*region) && region->velocityRange.containsWithEnd(velocity))
+                addCandidate(region, false);
+        }
+        bucketOffsets.push_back(static_cast<uint32_t>(regions.size()));
+    }
+}
+
+void sfz::NoteActivationIndex::addCandidate(Region* region, bool always)
+{
+    regions.push_back(region);
+    // The regions always registered with check their own random range
+    randRanges.push_back(always ? Range<float> { 0.0f, 1.0f } : region->randRange);
+    keyRanges.push_back(region->keyRange);
+    sequenceLengths.push_back(region->sequenceLength);
+    sequencePositions.push_back(region->sequencePosition);
+    alwaysRegistered.push_back(always);
+}
+
+void sfz::NoteActivationIndex::clear() noexcept
+{
+    velocityBuckets.fill(0);
+    bucketOffsets = { 0, 0 };
+    regions.clear();
+    randRanges.clear();
+    keyRanges.clear();
+    sequenceLengths.clear();
+    sequencePositions.clear();
+    alwaysRegistered.clear();
+}
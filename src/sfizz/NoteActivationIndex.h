@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "Range.h"
+#include "Region.h"
+#include "absl/types/span.h"
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace sfz {
+/**
+ * @brief Compiled note-on activation of the regions of a single note.
+ *
+ * The velocity range of the regions is known when the instrument is loaded,
+ * so the velocities are split in buckets where the same regions match, and
+ * each bucket lists its candidate regions. A note-on then only registers with
+ * the candidates that match its velocity and random value, whatever the number
+ * of layers on the note.
+ *
+ * The data that decides whether a candidate is registered with (its random
+ * range, key range and sequence position) is held in contiguous arrays beside
+ * the region pointers, so that the candidates which do not play are rejected
+ * without reading their region. Their sequence counter is derived from the
+ * note-ons on their keys, so it does not need to be tracked in the region
+ * either until it plays.
+ *
+ * Keyswitched regions hold a state that changes with every note on their
+ * keys, so they are candidates in every bucket and always registered with,
+ * as are the release regions that play in a sequence and the regions that
+ * trigger on a CC, whose sequence state is read by other events whatever the
+ * velocity of the note-on. The other regions that can only trigger on a
+ * note-off are not candidates.
+ */
+class NoteActivationIndex {
+public:
+    /**
+     * @brief Build the index from the regions that can activate on the note,
+     * in the order they should be registered with.
+     *
+     * @param sourceRegions
+     */
+    void build(absl::Span<Region* const> sourceRegions);
+    void clear() noexcept;
+    /**
+     * @brief Get the candidates for a velocity, as the range of their indices
+     * in the index, in their original order
+     *
+     * @param velocity
+     * @return std::pair<uint32_t, uint32_t> the first and past-the-end candidates
+     */
+    std::pair<uint32_t, uint32_t> getCandidates(uint8_t velocity) const noexcept
+    {
+        const auto bucket = velocityBuckets[velocity & 127];
+        return { bucketOffsets[bucket], bucketOffsets[bucket + 1] };
+    }
+    /**
+     * @brief Check if a candidate should be registered with for a random value
+     *
+     * @param candidate
+     * @param randValue
+     * @return true
+     * @return false
+     */
+    bool matchesRandom(uint32_t candidate, float randValue) const noexcept
+    {
+        const auto& randRange = randRanges[candidate];
+        return randRange.contains(randValue) || (randValue == 1.0f && randRange.getEnd() == 1.0f);
+    }
+    /**
+     * @brief Count the note-ons received on the keys of a candidate
+     *
+     * @param candidate
+     * @param noteOnCounts the note-ons received on each key
+     * @return int
+     */
+    int countNoteOns(uint32_t candidate, const std::array<int, 128>& noteOnCounts) const noexcept
+    {
+        int numNoteOns { 0 };
+        for (int key = keyRanges[candidate].getStart(); key <= keyRanges[candidate].getEnd(); ++key)
+            numNoteOns += noteOnCounts[key];
+        return numNoteOns;
+    }
+    /**
+     * @brief Check if a candidate plays in a sequence, in which case its
+     * sequence counter follows the note-ons on its keys
+     *
+     * @param candidate
+     * @return true
+     * @return false
+     */
+    bool isSequenced(uint32_t candidate) const noexcept { return sequenceLengths[candidate] > 1; }
+    /**
+     * @brief Check if a sequenced candidate should be registered with after
+     * some note-ons on its keys
+     *
+     * @param candidate
+     * @param numNoteOns the note-ons on its keys, including the current one
+     * @return true
+     * @return false
+     */
+    bool matchesSequence(uint32_t candidate, int numNoteOns) const noexcept
+    {
+        return alwaysRegistered[candidate] || numNoteOns % sequenceLengths[candidate] == sequencePositions[candidate] - 1;
+    }
+    Region* getRegion(uint32_t candidate) const noexcept { return regions[candidate]; }
+private:
+    void addCandidate(Region* region, bool always);
+    std::array<uint8_t, 128> velocityBuckets {};
+    std::vector<uint32_t> bucketOffsets { 0, 0 };
+    // One entry per candidate in each of the following
+    std::vector<Region*> regions;
+    std::vector<Range<float>> randRanges;
+    std::vector<Range<uint8_t>> keyRanges;
+    std::vector<uint8_t> sequenceLengths;
+    std::vector<uint8_t> sequencePositions;
+    std::vector<uint8_t> alwaysRegistered;
+};
+}
@@ -11,14 +11,17 @@ sfz::Opcode::Opcode(absl::string_view inputOpcode, absl::string_view inputValue)
     : opcode(inputOpcode)
     , value(inputValue)
 {
-    const auto lastCharIndex = inputOpcode.find_last_not_of("1234567890");
-    if (lastCharIndex != inputOpcode.npos) {
+    auto parameterStart = inputOpcode.size();
+    while (parameterStart > 0 && absl::ascii_isdigit(inputOpcode[parameterStart - 1]))
+        parameterStart--;
+
+    if (parameterStart > 0) {
         int returnedValue;
         absl::string_view parameterView = inputOpcode;
-        parameterView.remove_prefix(lastCharIndex + 1);
+        parameterView.remove_prefix(parameterStart);
         if (absl::SimpleAtoi(parameterView, &returnedValue)) {
             parameter = returnedValue;
-            opcode.remove_suffix(opcode.size() - lastCharIndex - 1);
+            opcode.remove_suffix(opcode.size() - parameterStart);
         }
     }
     trimInPlace(value);
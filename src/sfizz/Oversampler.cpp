@@ -54,6 +54,12 @@ using Upsampler4x = hiir::Upsampler2xFpu<coeffsStage4x.size()>;
 using Upsampler8x = hiir::Upsampler2xFpu<coeffsStage8x.size()>;
 #endif
 
+// There is only a scalar version of the decimating filters
+#include "hiir/Downsampler2xFpu.h"
+using Downsampler2x = hiir::Downsampler2xFpu<coeffsStage2x.size()>;
+using Downsampler4x = hiir::Downsampler2xFpu<coeffsStage4x.size()>;
+using Downsampler8x = hiir::Downsampler2xFpu<coeffsStage8x.size()>;
+
 sfz::Oversampler::Oversampler(sfz::Oversampling factor, size_t chunkSize)
 : factor(factor), chunkSize(chunkSize)
 {
@@ -132,3 +138,86 @@ void sfz::Oversampler::stream(const sfz::AudioBuffer<float>& input, sfz::AudioBu
     }
 
 }
+
+struct sfz::Downsampler::Stages
+{
+    Stages()
+    {
+        downsampler2x.set_coefs(coeffsStage2x.data());
+        downsampler4x.set_coefs(coeffsStage4x.data());
+        downsampler8x.set_coefs(coeffsStage8x.data());
+    }
+    Downsampler2x downsampler2x;
+    Downsampler4x downsampler4x;
+    Downsampler8x downsampler8x;
+};
+
+sfz::Downsampler::Downsampler(sfz::Oversampling factor, int samplesPerBlock)
+: factor(factor)
+{
+    for (auto& channelStages: stages)
+        channelStages = std::make_unique<Stages>();
+    setSamplesPerBlock(samplesPerBlock);
+}
+
+sfz::Downsampler::~Downsampler()
+{
+
+}
+
+void sfz::Downsampler::setFactor(sfz::Oversampling factor) noexcept
+{
+    this->factor = factor;
+    reset();
+}
+
+void sfz::Downsampler::setSamplesPerBlock(int samplesPerBlock)
+{
+    buffer2x.resize(static_cast<size_t>(samplesPerBlock) * 2);
+    buffer4x.resize(static_cast<size_t>(samplesPerBlock) * 4);
+}
+
+void sfz::Downsampler::reset() noexcept
+{
+    for (auto& channelStages: stages) {
+        channelStages->downsampler2x.clear_buffers();
+        channelStages->downsampler4x.clear_buffers();
+        channelStages->downsampler8x.clear_buffers();
+    }
+}
+
+void sfz::Downsampler::process(sfz::AudioSpan<const float> input, sfz::AudioSpan<float> output) noexcept
+{
+    const auto numFrames = output.getNumFrames();
+    const auto numChannels = std::min(output.getNumChannels(), stages.size());
+    ASSERT(input.getNumFrames() >= numFrames * static_cast<int>(factor));
+    ASSERT(input.getNumChannels() >= numChannels);
+    ASSERT(buffer2x.size() >= numFrames * 2);
+
+    if (numFrames == 0)
+        return;
+
+    const auto numSamples = static_cast<long>(numFrames);
+    for (size_t chanIdx = 0; chanIdx < numChannels; chanIdx++) {
+        auto& channelStages = *stages[chanIdx];
+        const auto inputChannel = input.getConstSpan(chanIdx);
+        const auto outputChannel = output.getSpan(chanIdx);
+        switch (factor) {
+        case Oversampling::x1:
+            copy<float>(inputChannel.first(numFrames), outputChannel);
+            break;
+        case Oversampling::x2:
+            channelStages.downsampler2x.process_block(outputChannel.data(), inputChannel.data(), numSamples);
+            break;
+        case Oversampling::x4:
+            channelStages.downsampler4x.process_block(buffer2x.data(), inputChannel.data(), numSamples * 2);
+            channelStages.downsampler2x.process_block(outputChannel.data(), buffer2x.data(), numSamples);
+            break;
+        case Oversampling::x8:
+            channelStages.downsampler8x.process_block(buffer4x.data(), inputChannel.data(), numSamples * 4);
+            channelStages.downsampler4x.process_block(buffer2x.data(), buffer4x.data(), numSamples * 2);
+            channelStages.downsampler2x.process_block(outputChannel.data(), buffer2x.data(), numSamples);
+            break;
+        }
+    }
+}
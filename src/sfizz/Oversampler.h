@@ -11,6 +11,7 @@
 #include "Debug.h"
 #include "Buffer.h"
 #include "AudioBuffer.h"
+#include "AudioSpan.h"
 #include "Config.h"
 
 namespace sfz {
@@ -51,4 +52,60 @@ private:
     LEAK_DETECTOR(Oversampler);
 };
 
+/**
+ * @brief Brings blocks of audio rendered at an oversampled rate back to the
+ *        output rate, through a cascade of half-band filters. The filters
+ *        keep their state from one block to the next, so that a stream can
+ *        be processed block by block.
+ */
+class Downsampler
+{
+public:
+    /**
+     * @brief Construct a new Downsampler object
+     *
+     * @param factor
+     * @param samplesPerBlock the maximum number of output frames per block
+     */
+    Downsampler(Oversampling factor = Oversampling::x1, int samplesPerBlock = config::defaultSamplesPerBlock);
+    ~Downsampler();
+    /**
+     * @brief Change the oversampling factor. This clears the filters.
+     *
+     * @param factor
+     */
+    void setFactor(Oversampling factor) noexcept;
+    Oversampling getFactor() const noexcept { return factor; }
+    /**
+     * @brief Set the maximum number of output frames per block. This allocates
+     *        the intermediate buffers.
+     *
+     * @param samplesPerBlock
+     */
+    void setSamplesPerBlock(int samplesPerBlock);
+    /**
+     * @brief Clear the filters, as if they processed silence forever.
+     */
+    void reset() noexcept;
+    /**
+     * @brief Downsample a block. The input must hold factor times as many
+     *        frames as the output, and as many channels.
+     *
+     * @param input
+     * @param output
+     */
+    void process(AudioSpan<const float> input, AudioSpan<float> output) noexcept;
+
+    Downsampler(const Downsampler&) = delete;
+    Downsampler(Downsampler&&) = delete;
+private:
+    struct Stages;
+    Oversampling factor;
+    std::array<std::unique_ptr<Stages>, config::numChannels> stages;
+    Buffer<float> buffer2x;
+    Buffer<float> buffer4x;
+
+    LEAK_DETECTOR(Downsampler);
+};
+
 }
@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "PCMFile.h"
+#include "Debug.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+uint16_t readLE16(const uint8_t* bytes) noexcept
+{
+    return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+uint32_t readLE32(const uint8_t* bytes) noexcept
+{
+    return static_cast<uint32_t>(bytes[0])
+        | (static_cast<uint32_t>(bytes[1]) << 8)
+        | (static_cast<uint32_t>(bytes[2]) << 16)
+        | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+bool matchesTag(const uint8_t* bytes, const char* tag) noexcept
+{
+    return bytes[0] == tag[0] && bytes[1] == tag[1] && bytes[2] == tag[2] && bytes[3] == tag[3];
+}
+
+constexpr uint16_t formatPCM { 1 };
+constexpr uint16_t formatFloat { 3 };
+constexpr uint16_t formatExtensible { 0xFFFE };
+
+template <class Decode>
+void deinterleave(const uint8_t* input, size_t numFrames, uint32_t numChannels, uint32_t bytesPerSample,
+    sfz::AudioBuffer<float>& output, size_t outputFrame, Decode&& decode) noexcept
+{
+    if (numChannels == 1) {
+        auto left = output.getSpan(0).subspan(outputFrame, numFrames);
+        for (auto& sample : left) {
+            sample = decode(input);
+            input += bytesPerSample;
+        }
+    } else {
+        auto left = output.getSpan(0).subspan(outputFrame, numFrames);
+        auto right = output.getSpan(1).subspan(outputFrame, numFrames);
+        for (size_t i = 0; i < numFrames; ++i) {
+            left[i] = decode(input);
+            right[i] = decode(input + bytesPerSample);
+            input += 2 * bytesPerSample;
+        }
+    }
+}
+}
+
+absl::optional<sfz::PCMLayout> sfz::readPCMLayout(const fs::path& file) noexcept
+{
+    return readPCMLayout(ReadableFile(file));
+}
+
+absl::optional<sfz::PCMLayout> sfz::readPCMLayout(const ReadableFile& file) noexcept
+{
+    if (!file)
+        return {};
+
+    const auto readFully = [&file](uint64_t offset, uint8_t* buffer, uint32_t size) {
+        return file.readAt(offset, buffer, size) == static_cast<int64_t>(size);
+    };
+
+    uint8_t header[12];
+    if (!readFully(0, header, sizeof(header)))
+        return {};
+
+    if (!matchesTag(header, "RIFF") || !matchesTag(header + 8, "WAVE"))
+        return {};
+
+    PCMLayout layout;
+    uint16_t format { 0 };
+    uint16_t bitsPerSample { 0 };
+    bool foundFormat { false };
+    uint64_t position { sizeof(header) };
+
+    uint8_t chunkHeader[8];
+    while (readFully(position, chunkHeader, sizeof(chunkHeader))) {
+        const auto chunkSize = readLE32(chunkHeader + 4);
+        position += sizeof(chunkHeader);
+
+        if (matchesTag(chunkHeader, "fmt ")) {
+            uint8_t fmt[40] {};
+            if (chunkSize < 16 || !readFully(position, fmt, std::min<uint32_t>(chunkSize, sizeof(fmt))))
+                return {};
+
+            format = readLE16(fmt);
+            layout.numChannels = readLE16(fmt + 2);
+            layout.bytesPerFrame = readLE16(fmt + 12);
+            bitsPerSample = readLE16(fmt + 14);
+            // The actual format of extensible files is at the start of the subformat GUID
+            if (format == formatExtensible && chunkSize >= 26)
+                format = readLE16(fmt + 24);
+            foundFormat = true;
+        } else if (matchesTag(chunkHeader, "data")) {
+            if (!foundFormat)
+                return {};
+
+            layout.dataOffset = position;
+            if (layout.bytesPerFrame > 0)
+                layout.numFrames = chunkSize / layout.bytesPerFrame;
+            break;
+        }
+
+        // Chunks are padded to an even size
+        position += chunkSize + (chunkSize & 1);
+    }
+
+    if (layout.dataOffset == 0 || layout.numFrames == 0)
+        return {};
+
+    if (layout.numChannels != 1 && layout.numChannels != 2)
+        return {};
+
+    if (format == formatPCM && bitsPerSample == 16)
+        layout.encoding = PCMLayout::Encoding::Int16;
+    else if (format == formatPCM && bitsPerSample == 24)
+        layout.encoding = PCMLayout::Encoding::Int24;
+    else if (format == formatPCM && bitsPerSample == 32)
+        layout.encoding = PCMLayout::Encoding::Int32;
+    else if (format == formatFloat && bitsPerSample == 32)
+        layout.encoding = PCMLayout::Encoding::Float32;
+    else
+        return {};
+
+    if (layout.bytesPerFrame != layout.numChannels * bitsPerSample / 8)
+        return {};
+
+    // Discard truncated files, libsndfile knows better how to handle them
+    if (layout.byteOffset(layout.numFrames) > file.size())
+        return {};
+
+    return layout;
+}
+
+void sfz::decodePCM(absl::Span<const uint8_t> input, const PCMLayout& layout, AudioBuffer<float>& output, size_t outputFrame) noexcept
+{
+    ASSERT(output.getNumChannels() == layout.numChannels);
+    const size_t numFrames = input.size() / layout.bytesPerFrame;
+    ASSERT(outputFrame + numFrames <= output.getNumFrames());
+    const uint32_t bytesPerSample = layout.bytesPerFrame / layout.numChannels;
+
+    switch (layout.encoding) {
+    case PCMLayout::Encoding::Int16:
+        deinterleave(input.data(), numFrames, layout.numChannels, bytesPerSample, output, outputFrame, [](const uint8_t* bytes) {
+            return static_cast<int16_t>(readLE16(bytes)) / 32768.0f;
+        });
+        break;
+    case PCMLayout::Encoding::Int24:
+        deinterleave(input.data(), numFrames, layout.numChannels, bytesPerSample, output, outputFrame, [](const uint8_t* bytes) {
+            const auto value = static_cast<int32_t>((bytes[0] << 8) | (bytes[1] << 16) | (static_cast<uint32_t>(bytes[2]) << 24));
+            return (value >> 8) / 8388608.0f;
+        });
+        break;
+    case PCMLayout::Encoding::Int32:
+        deinterleave(input.data(), numFrames, layout.numChannels, bytesPerSample, output, outputFrame, [](const uint8_t* bytes) {
+            return static_cast<int32_t>(readLE32(bytes)) / 2147483648.0f;
+        });
+        break;
+    case PCMLayout::Encoding::Float32:
+        deinterleave(input.data(), numFrames, layout.numChannels, bytesPerSample, output, outputFrame, [](const uint8_t* bytes) {
+            const auto bits = readLE32(bytes);
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        });
+        break;
+    }
+}
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "AudioBuffer.h"
+#include "IOBackend.h"
+#include "ghc/fs_std.hpp"
+#include <absl/types/optional.h>
+#include <absl/types/span.h>
+#include <cstdint>
+
+namespace sfz {
+/**
+ * @brief Location and encoding of the frames in an uncompressed WAV file.
+ *
+ * This allows reading frames straight from the file at computed byte offsets,
+ * and decoding them separately from the read itself.
+ */
+struct PCMLayout
+{
+    enum class Encoding { Int16, Int24, Int32, Float32 };
+
+    uint64_t dataOffset { 0 };
+    uint32_t numFrames { 0 };
+    uint32_t numChannels { 0 };
+    uint32_t bytesPerFrame { 0 };
+    Encoding encoding { Encoding::Int16 };
+
+    /**
+     * @brief Get the position in the file of a given frame
+     *
+     * @param frame
+     * @return uint64_t
+     */
+    uint64_t byteOffset(uint32_t frame) const noexcept
+    {
+        return dataOffset + static_cast<uint64_t>(frame) * bytesPerFrame;
+    }
+};
+
+/**
+ * @brief Read the layout of a WAV file. Only mono and stereo files with 16,
+ * 24 or 32 bits integer or 32 bits float samples are handled; other files
+ * have to be read through libsndfile.
+ *
+ * @param file
+ * @return absl::optional<PCMLayout> the layout, or nothing if the file is not
+ *                                   an uncompressed WAV file we can decode
+ */
+absl::optional<PCMLayout> readPCMLayout(const fs::path& file) noexcept;
+
+/**
+ * @brief Read the layout of an opened WAV file. The file offset is left
+ * untouched, so the file can be handed to another reader afterwards.
+ *
+ * @param file
+ * @return absl::optional<PCMLayout>
+ */
+absl::optional<PCMLayout> readPCMLayout(const ReadableFile& file) noexcept;
+
+/**
+ * @brief Decode interleaved frames read from a file described by a layout.
+ * Integer samples are normalized the same way as libsndfile does.
+ *
+ * @param input the raw bytes, containing a whole number of frames
+ * @param layout
+ * @param output
+ * @param outputFrame the frame of the output at which to write the first
+ *                    decoded frame
+ */
+void decodePCM(absl::Span<const uint8_t> input, const PCMLayout& layout, AudioBuffer<float>& output, size_t outputFrame) noexcept;
+}
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "MathHelpers.h"
+#include <array>
+#include <cmath>
+
+namespace sfz {
+/**
+ * @brief Table of the constant-power pan law, which replaces the sine and
+ * cosine computations of the pan, width and position stages.
+ *
+ * The table holds cos(pi/2 * x) for x between 0 and 1, which is read with a
+ * linear interpolation between its entries. The left gain of a pan value p
+ * between -1 and 1 is the entry at (1 + p) / 2, and the right gain the entry
+ * at (1 - p) / 2, which are cos(pi/4 * (1 + p)) and sin(pi/4 * (1 + p)).
+ *
+ * The table is built on the first call to get(), which should not happen on
+ * the audio thread.
+ */
+class PanTable {
+public:
+    static constexpr int size { 1024 };
+
+    static const PanTable& get() noexcept
+    {
+        static const PanTable table;
+        return table;
+    }
+
+    /**
+     * @brief Get the table entries. There are size + 2 of them, the last one
+     * repeating the one before so that x = 1 can be interpolated.
+     */
+    const float* data() const noexcept { return entries.data(); }
+
+    /**
+     * @brief Get cos(pi/2 * x), with x clamped between 0 and 1
+     */
+    float gain(float x) const noexcept
+    {
+        const float position = clamp(x, 0.0f, 1.0f) * static_cast<float>(size);
+        const auto index = static_cast<int>(position);
+        const float fraction = position - static_cast<float>(index);
+        return entries[index] + fraction * (entries[index + 1] - entries[index]);
+    }
+
+    /**
+     * @brief Get the left and right gains of a pan value between -1 and 1
+     *
+     * @param pan
+     * @param left
+     * @param right
+     */
+    void gains(float pan, float& left, float& right) const noexcept
+    {
+        left = gain(0.5f * (1.0f + pan));
+        right = gain(0.5f * (1.0f - pan));
+    }
+
+private:
+    PanTable() noexcept
+    {
+        for (int i = 0; i <= size; ++i)
+            entries[i] = static_cast<float>(std::cos(piTwo<double> * static_cast<double>(i) / size));
+        entries[size] = 0.0f;
+        entries[size + 1] = 0.0f;
+    }
+
+    std::array<float, size + 2> entries;
+};
+}
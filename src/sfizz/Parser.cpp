@@ -7,10 +7,9 @@
 #include "Parser.h"
 #include "StringViewHelpers.h"
 #include "SfzHelpers.h"
-#include "absl/strings/str_join.h"
+#include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include <algorithm>
-#include <fstream>
 
 void removeCommentOnLine(absl::string_view& line)
 {
@@ -22,6 +21,10 @@ void removeCommentOnLine(absl::string_view& line)
 bool sfz::Parser::loadSfzFile(const fs::path& file)
 {
     includedFiles.clear();
+    mappedFiles.clear();
+    expandedLines.clear();
+    currentHeader.reset();
+    currentMembers.clear();
 
     const auto sfzFile = file.is_absolute() ? file : originalDirectory / file;
     if (!fs::exists(sfzFile))
@@ -29,103 +32,142 @@ bool sfz::Parser::loadSfzFile(const fs::path& file)
 
     originalDirectory = file.parent_path();
     includedFiles.push_back(file);
-    std::vector<std::string> lines;
-    readSfzFile(file, lines);
-
-    aggregatedContent = absl::StrJoin(lines, " ");
-    absl::string_view aggregatedView { aggregatedContent };
-
-    absl::string_view header;
-    absl::string_view members;
-
-    std::vector<Opcode> currentMembers;
-
-    while (findHeader(aggregatedView, header, members)) {
-        absl::string_view opcode;
-        absl::string_view value;
-
-        // Store or handle members
-        while(findOpcode(members, opcode, value))
-            currentMembers.emplace_back(opcode, value);
+    readSfzFile(file);
+    finishHeader();
+    return true;
+}
 
-        callback(header, currentMembers);
-        currentMembers.clear();
-    }
+void sfz::Parser::restoreSfzFile(const fs::path& file, std::vector<fs::path> includedFiles,
+    const absl::flat_hash_map<std::string, std::string>& fileDefines)
+{
+    mappedFiles.clear();
+    expandedLines.clear();
+    currentHeader.reset();
+    currentMembers.clear();
 
-    return true;
+    originalDirectory = file.parent_path();
+    this->includedFiles = std::move(includedFiles);
+    for (const auto& define : fileDefines)
+        defines.insert_or_assign(define.first, define.second);
 }
 
-void sfz::Parser::readSfzFile(const fs::path& fileName, std::vector<std::string>& lines) noexcept
+void sfz::Parser::readSfzFile(const fs::path& fileName) noexcept
 {
-    std::ifstream fileStream(fileName.c_str());
-    if (!fileStream)
-        return;
+    mappedFiles.push_back(absl::make_unique<MappedFile>(fileName));
+    const auto& mappedFile = *mappedFiles.back();
+    absl::string_view content { reinterpret_cast<const char*>(mappedFile.data()), mappedFile.size() };
 
-    std::string tmpString;
     std::string includePath;
     absl::string_view variable;
     absl::string_view value;
-    while (std::getline(fileStream, tmpString)) {
-        absl::string_view tmpView { tmpString };
+    while (!content.empty()) {
+        const auto lineEnd = content.find('\n');
+        absl::string_view line = content.substr(0, lineEnd);
+        content.remove_prefix(lineEnd != content.npos ? lineEnd + 1 : content.size());
 
-        removeCommentOnLine(tmpView);
-        trimInPlace(tmpView);
+        removeCommentOnLine(line);
+        trimInPlace(line);
 
-        if (tmpView.empty())
+        if (line.empty())
             continue;
 
         // New #include
-        if (findInclude(tmpView, includePath)) {
+        if (findInclude(line, includePath)) {
             std::replace(includePath.begin(), includePath.end(), '\\', '/');
             const auto newFile = originalDirectory / includePath;
             auto alreadyIncluded = std::find(includedFiles.begin(), includedFiles.end(), newFile);
             if (fs::exists(newFile)) {
                 if (alreadyIncluded == includedFiles.end()) {
                     includedFiles.push_back(newFile);
-                    readSfzFile(newFile, lines);
+                    readSfzFile(newFile);
                 } else if (!recursiveIncludeGuard) {
-                    readSfzFile(newFile, lines);
+                    readSfzFile(newFile);
                 }
             }
             continue;
         }
 
         // New #define
-        if (findDefine(tmpView, variable, value)) {
-
-            defines[std::string(variable)] = std::string(value);
+        if (findDefine(line, variable, value)) {
+            defines.insert_or_assign(std::string(variable), std::string(value));
             continue;
         }
 
-        // Replace defined variables starting with $
-        std::string newString;
-        newString.reserve(tmpView.length());
-        std::string::size_type lastPos = 0;
-        std::string::size_type findPos = tmpView.find(sfz::config::defineCharacter, lastPos);
-
-        while (findPos < tmpView.npos) {
-            absl::StrAppend(&newString, tmpView.substr(lastPos, findPos - lastPos));
-
-            const auto defineEnd = tmpView.find_first_of("= \r\t\n\f\v", findPos);
-            const auto candidate = tmpView.substr(findPos, defineEnd - findPos);
-            for (auto& definePair : defines) {
-                if (candidate == definePair.first) {
-                    absl::StrAppend(&newString, definePair.second);
-                    lastPos = findPos + definePair.first.length();
-                    break;
-                }
-            }
+        readLine(expandDefines(line));
+    }
+}
 
-            if (lastPos <= findPos) {
-                newString += sfz::config::defineCharacter;
-                lastPos = findPos + 1;
-            }
+absl::string_view sfz::Parser::expandDefines(absl::string_view line)
+{
+    auto position = line.find(config::defineCharacter);
+    if (position == line.npos || defines.empty())
+        return line;
+
+    // Only the lines where a variable is replaced are copied
+    std::string expanded;
+    size_t lastPosition = 0;
+    while (position != line.npos) {
+        const auto defineEnd = line.find_first_of("= \r\t\n\f\v", position);
+        const auto candidate = line.substr(position, defineEnd - position);
+        const auto define = defines.find(candidate);
+        if (define != defines.end()) {
+            absl::StrAppend(&expanded, line.substr(lastPosition, position - lastPosition), define->second);
+            lastPosition = position + candidate.size();
+        }
+
+        position = line.find(config::defineCharacter, std::max(position + 1, lastPosition));
+    }
+
+    if (lastPosition == 0)
+        return line;
 
-            findPos = tmpView.find(sfz::config::defineCharacter, lastPos);
+    absl::StrAppend(&expanded, line.substr(lastPosition));
+    expandedLines.push_back(std::move(expanded));
+    return expandedLines.back();
+}
+
+void sfz::Parser::readLine(absl::string_view line)
+{
+    while (!line.empty()) {
+        const auto headerStart = line.find('<');
+        if (currentHeader)
+            readMembers(line.substr(0, headerStart));
+
+        if (headerStart == line.npos)
+            return;
+
+        finishHeader();
+        const auto headerEnd = line.find('>', headerStart);
+        if (headerEnd == line.npos) {
+            currentHeader = line.substr(headerStart + 1);
+            return;
         }
 
-        // Copy the rest of the string
-        absl::StrAppend(&newString, tmpView.substr(lastPos));
-        lines.push_back(std::move(newString));
+        currentHeader = line.substr(headerStart + 1, headerEnd - headerStart - 1);
+        line.remove_prefix(headerEnd + 1);
     }
 }
+
+void sfz::Parser::readMembers(absl::string_view members)
+{
+    absl::string_view opcode;
+    absl::string_view value;
+    while (findOpcode(members, opcode, value)) {
+        // Words before the first opcode of a line are not part of its name
+        trimInPlace(opcode);
+        const auto nameStart = opcode.find_last_of(' ');
+        if (nameStart != opcode.npos)
+            opcode.remove_prefix(nameStart + 1);
+
+        currentMembers.emplace_back(opcode, value);
+    }
+}
+
+void sfz::Parser::finishHeader()
+{
+    if (currentHeader)
+        callback(*currentHeader, currentMembers);
+
+    currentHeader.reset();
+    currentMembers.clear();
+}
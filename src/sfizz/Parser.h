@@ -6,31 +6,65 @@
 
 #pragma once
 #include "Config.h"
+#include "MappedFile.h"
 #include "Opcode.h"
 #include "ghc/fs_std.hpp"
-#include <map>
-#include <string>
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include <deque>
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace sfz {
+/**
+ * @brief Reads SFZ files and hands each header with its opcodes to callback().
+ *
+ * The files are memory-mapped and tokenized line by line in a single pass,
+ * the included files being read where they are included. The header and opcode
+ * views point into the mapped files, except on the lines where a defined
+ * variable is replaced, which are expanded in strings of their own. All of
+ * them stay valid until the next call to loadSfzFile().
+ *
+ * A header and its opcodes can span several lines, but an opcode value ends
+ * with its line at the latest.
+ */
 class Parser {
 public:
     virtual ~Parser() = default;
     virtual bool loadSfzFile(const fs::path& file);
-    const std::map<std::string, std::string>& getDefines() const noexcept { return defines; }
+    const absl::flat_hash_map<std::string, std::string>& getDefines() const noexcept { return defines; }
     const std::vector<fs::path>& getIncludedFiles() const noexcept { return includedFiles; }
     void disableRecursiveIncludeGuard() { recursiveIncludeGuard = false; }
     void enableRecursiveIncludeGuard() { recursiveIncludeGuard = true; }
 protected:
     virtual void callback(absl::string_view header, const std::vector<Opcode>& members) = 0;
+    /**
+     * @brief Take the state of a file that is not parsed again because what
+     * it builds was restored otherwise, as from a cache.
+     *
+     * @param file the root file
+     * @param includedFiles the files read when the root file was parsed
+     * @param fileDefines the variables defined by these files
+     */
+    void restoreSfzFile(const fs::path& file, std::vector<fs::path> includedFiles,
+        const absl::flat_hash_map<std::string, std::string>& fileDefines);
     fs::path originalDirectory { fs::current_path() };
 private:
     bool recursiveIncludeGuard { false };
-    std::map<std::string, std::string> defines;
+    absl::flat_hash_map<std::string, std::string> defines;
     std::vector<fs::path> includedFiles;
-    std::string aggregatedContent {};
-    void readSfzFile(const fs::path& fileName, std::vector<std::string>& lines) noexcept;
+    // Storage for the views handed to the callback
+    std::vector<std::unique_ptr<MappedFile>> mappedFiles;
+    std::deque<std::string> expandedLines;
+    absl::optional<absl::string_view> currentHeader;
+    std::vector<Opcode> currentMembers;
+    void readSfzFile(const fs::path& fileName) noexcept;
+    absl::string_view expandDefines(absl::string_view line);
+    void readLine(absl::string_view line);
+    void readMembers(absl::string_view members);
+    void finishHeader();
 };
 
 } // namespace sfz
@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "PreloadCache.h"
+#include "CacheFile.h"
+#include "MappedFile.h"
+#include "MathHelpers.h"
+#include "absl/strings/str_cat.h"
+#include <cstring>
+
+namespace {
+constexpr char entryMagic[8] { 'S', 'F', 'Z', 'C', 'A', 'C', 'H', 'E' };
+constexpr uint32_t entryVersion { 2 };
+constexpr size_t dataAlignment { 16 };
+
+/**
+ * @brief Header of a cache entry. It is followed by the path of the sample,
+ * then by the preloaded frames of each channel in their storage format,
+ * starting at an aligned offset. The header is written as it is in memory.
+ */
+struct EntryHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t oversamplingFactor;
+    uint64_t fileSize;
+    int64_t modificationTime;
+    uint32_t pathSize;
+    uint32_t numChannels;
+    uint32_t sampleFormat;
+    uint32_t numPreloadedFrames;
+    uint32_t numFrames;
+    float sampleRate;
+    uint32_t end;
+    uint32_t loopBegin;
+    uint32_t loopEnd;
+    double fileSampleRate;
+    int32_t fileNumChannels;
+    uint32_t hasPCMLayout;
+    uint64_t dataOffset;
+    uint32_t pcmNumFrames;
+    uint32_t pcmNumChannels;
+    uint32_t pcmBytesPerFrame;
+    uint32_t pcmEncoding;
+};
+
+size_t dataStart(uint32_t pathSize) noexcept
+{
+    const size_t unaligned = sizeof(EntryHeader) + pathSize;
+    return (unaligned + dataAlignment - 1) / dataAlignment * dataAlignment;
+}
+}
+
+sfz::PreloadCache::PreloadCache(const fs::path& directory)
+: directory(directory)
+{
+    createCacheDirectory(directory);
+}
+
+fs::path sfz::PreloadCache::entryPath(const fs::path& file, Oversampling factor) const
+{
+    return directory / absl::StrCat(cacheEntryName(file), "_x", static_cast<int>(factor), ".preload");
+}
+
+absl::optional<sfz::PreloadedFileHandle> sfz::PreloadCache::load(const fs::path& file, Oversampling factor, uint32_t maxFramesToLoad) const noexcept
+{
+    FileStatus status;
+    if (!getFileStatus(file, status))
+        return {};
+
+    MappedFile mapped { entryPath(file, factor) };
+    if (mapped.size() < sizeof(EntryHeader))
+        return {};
+
+    EntryHeader header;
+    std::memcpy(&header, mapped.data(), sizeof(header));
+    if (std::memcmp(header.magic, entryMagic, sizeof(entryMagic)) != 0
+        || header.version != entryVersion
+        || header.oversamplingFactor != static_cast<uint32_t>(factor)
+        || header.fileSize != status.size
+        || header.modificationTime != status.modificationTime
+        || (header.numChannels != 1 && header.numChannels != 2)
+        || header.sampleFormat > static_cast<uint32_t>(SampleFormat::Int16))
+        return {};
+
+    const auto filename = file.string();
+    if (header.pathSize != filename.size() || mapped.size() < sizeof(EntryHeader) + header.pathSize
+        || std::memcmp(mapped.data() + sizeof(EntryHeader), filename.data(), filename.size()) != 0)
+        return {};
+
+    const auto framesToLoad = min(maxFramesToLoad, header.numFrames / static_cast<uint32_t>(factor));
+    const auto numFrames = static_cast<size_t>(framesToLoad) * static_cast<size_t>(factor);
+    if (numFrames > header.numPreloadedFrames)
+        return {};
+
+    const auto sampleFormat = static_cast<SampleFormat>(header.sampleFormat);
+    const auto sampleSize = sampleFormat == SampleFormat::Int16 ? sizeof(int16_t) : sizeof(float);
+    const auto start = dataStart(header.pathSize);
+    const auto channelSize = static_cast<size_t>(header.numPreloadedFrames) * sampleSize;
+    if (mapped.size() < start + header.numChannels * channelSize)
+        return {};
+
+    PreloadedFileHandle entry;
+    entry.information.end = header.end;
+    entry.information.loopBegin = header.loopBegin;
+    entry.information.loopEnd = header.loopEnd;
+    entry.information.sampleRate = header.fileSampleRate;
+    entry.information.numChannels = header.fileNumChannels;
+    entry.modificationTime = fs::file_time_type(fs::file_time_type::duration(header.modificationTime));
+
+    auto preloadedData = std::make_shared<SampleBuffer>(sampleFormat, header.numChannels, numFrames);
+    for (uint32_t channel = 0; channel < header.numChannels; ++channel) {
+        const auto* channelData = mapped.data() + start + channel * channelSize;
+        std::memcpy(preloadedData->channelBytes(channel), channelData, numFrames * sampleSize);
+    }
+
+    entry.preloadedData = std::move(preloadedData);
+    entry.sampleRate = header.sampleRate;
+    entry.fileData = std::make_shared<FileData>(factor);
+    entry.numFrames = header.numFrames;
+    if (header.hasPCMLayout != 0) {
+        PCMLayout layout;
+        layout.dataOffset = header.dataOffset;
+        layout.numFrames = header.pcmNumFrames;
+        layout.numChannels = header.pcmNumChannels;
+        layout.bytesPerFrame = header.pcmBytesPerFrame;
+        layout.encoding = static_cast<PCMLayout::Encoding>(header.pcmEncoding);
+        entry.pcmLayout = layout;
+    }
+
+    return entry;
+}
+
+bool sfz::PreloadCache::store(const fs::path& file, Oversampling factor, const PreloadedFileHandle& preloaded) const noexcept
+{
+    if (!preloaded.preloadedData)
+        return false;
+
+    EntryHeader header {};
+    std::memcpy(header.magic, entryMagic, sizeof(entryMagic));
+    header.version = entryVersion;
+    header.oversamplingFactor = static_cast<uint32_t>(factor);
+    FileStatus status;
+    if (!getFileStatus(file, status))
+        return false;
+
+    header.fileSize = status.size;
+    header.modificationTime = status.modificationTime;
+
+    const auto filename = file.string();
+    const auto& data = *preloaded.preloadedData;
+    header.pathSize = static_cast<uint32_t>(filename.size());
+    header.numChannels = static_cast<uint32_t>(data.getNumChannels());
+    header.sampleFormat = static_cast<uint32_t>(data.getFormat());
+    header.numPreloadedFrames = static_cast<uint32_t>(data.getNumFrames());
+    header.numFrames = preloaded.numFrames;
+    header.sampleRate = preloaded.sampleRate;
+    const auto& information = preloaded.information;
+    header.end = information.end;
+    header.loopBegin = information.loopBegin;
+    header.loopEnd = information.loopEnd;
+    header.fileSampleRate = information.sampleRate;
+    header.fileNumChannels = information.numChannels;
+    if (preloaded.pcmLayout) {
+        header.hasPCMLayout = 1;
+        header.dataOffset = preloaded.pcmLayout->dataOffset;
+        header.pcmNumFrames = preloaded.pcmLayout->numFrames;
+        header.pcmNumChannels = preloaded.pcmLayout->numChannels;
+        header.pcmBytesPerFrame = preloaded.pcmLayout->bytesPerFrame;
+        header.pcmEncoding = static_cast<uint32_t>(preloaded.pcmLayout->encoding);
+    }
+
+    return writeCacheEntry(entryPath(file, factor), [&](std::ostream& output) {
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.write(filename.data(), static_cast<std::streamsize>(filename.size()));
+        const char padding[dataAlignment] {};
+        output.write(padding, static_cast<std::streamsize>(dataStart(header.pathSize) - sizeof(header) - filename.size()));
+        for (size_t channel = 0; channel < data.getNumChannels(); ++channel) {
+            output.write(reinterpret_cast<const char*>(data.channelBytes(channel)),
+                static_cast<std::streamsize>(data.getNumFrames() * data.getSampleSize()));
+        }
+    });
+}
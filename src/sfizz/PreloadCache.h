@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "FilePool.h"
+#include "ghc/fs_std.hpp"
+#include <absl/types/optional.h>
+
+namespace sfz {
+/**
+ * @brief On-disk cache of the file information and preloaded data of the
+ * samples, so that reopening an instrument does not need to decode the
+ * beginning of each sample again.
+ *
+ * Each entry holds the preloaded frames of one sample in their storage format,
+ * already oversampled. Entries are keyed by the path of the sample and the
+ * oversampling factor, and are only used if the size and modification time
+ * of the sample did not change since they were written. They are read back
+ * through a memory mapping.
+ */
+class PreloadCache {
+public:
+    /**
+     * @brief Construct a new cache in a directory, which is created if needed.
+     *
+     * @param directory
+     */
+    PreloadCache(const fs::path& directory);
+
+    /**
+     * @brief Look for a valid entry for a file.
+     *
+     * @param file the absolute path of the sample
+     * @param factor the oversampling factor of the preloaded data
+     * @param maxFramesToLoad the number of frames to preload before
+     *                        oversampling, if the file is long enough
+     * @return absl::optional<PreloadedFileHandle> the entry, or nothing if
+     *                              there is no valid entry with enough
+     *                              preloaded frames
+     */
+    absl::optional<PreloadedFileHandle> load(const fs::path& file, Oversampling factor, uint32_t maxFramesToLoad) const noexcept;
+
+    /**
+     * @brief Write the entry for a file, replacing any previous one.
+     *
+     * @param file the absolute path of the sample
+     * @param factor the oversampling factor of the preloaded data
+     * @param preloaded
+     * @return true if the entry was written
+     */
+    bool store(const fs::path& file, Oversampling factor, const PreloadedFileHandle& preloaded) const noexcept;
+
+    const fs::path& getDirectory() const noexcept { return directory; }
+private:
+    fs::path entryPath(const fs::path& file, Oversampling factor) const;
+    fs::path directory;
+};
+}
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "RTSemaphore.h"
+#include "Debug.h"
+#if defined(_WIN32)
+#include <windows.h>
+#include <climits>
+#elif !defined(__APPLE__)
+#include <cerrno>
+#endif
+
+#if defined(__APPLE__)
+
+sfz::RTSemaphore::RTSemaphore(unsigned initialCount)
+: semaphore(dispatch_semaphore_create(initialCount))
+{
+    ASSERT(semaphore != nullptr);
+}
+
+sfz::RTSemaphore::~RTSemaphore()
+{
+    dispatch_release(semaphore);
+}
+
+void sfz::RTSemaphore::post() noexcept
+{
+    dispatch_semaphore_signal(semaphore);
+}
+
+void sfz::RTSemaphore::wait() noexcept
+{
+    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+}
+
+bool sfz::RTSemaphore::tryWait() noexcept
+{
+    return dispatch_semaphore_wait(semaphore, DISPATCH_TIME_NOW) == 0;
+}
+
+#elif defined(_WIN32)
+
+sfz::RTSemaphore::RTSemaphore(unsigned initialCount)
+: semaphore(CreateSemaphoreW(nullptr, static_cast<LONG>(initialCount), LONG_MAX, nullptr))
+{
+    ASSERT(semaphore != nullptr);
+}
+
+sfz::RTSemaphore::~RTSemaphore()
+{
+    CloseHandle(static_cast<HANDLE>(semaphore));
+}
+
+void sfz::RTSemaphore::post() noexcept
+{
+    ReleaseSemaphore(static_cast<HANDLE>(semaphore), 1, nullptr);
+}
+
+void sfz::RTSemaphore::wait() noexcept
+{
+    WaitForSingleObject(static_cast<HANDLE>(semaphore), INFINITE);
+}
+
+bool sfz::RTSemaphore::tryWait() noexcept
+{
+    return WaitForSingleObject(static_cast<HANDLE>(semaphore), 0) == WAIT_OBJECT_0;
+}
+
+#else
+
+sfz::RTSemaphore::RTSemaphore(unsigned initialCount)
+{
+    const auto result = sem_init(&semaphore, 0, initialCount);
+    ASSERT(result == 0);
+    (void)result;
+}
+
+sfz::RTSemaphore::~RTSemaphore()
+{
+    sem_destroy(&semaphore);
+}
+
+void sfz::RTSemaphore::post() noexcept
+{
+    sem_post(&semaphore);
+}
+
+void sfz::RTSemaphore::wait() noexcept
+{
+    while (sem_wait(&semaphore) == -1 && errno == EINTR) {
+        // Interrupted by a signal, wait again
+    }
+}
+
+bool sfz::RTSemaphore::tryWait() noexcept
+{
+    int result;
+    while ((result = sem_trywait(&semaphore)) == -1 && errno == EINTR) {
+        // Interrupted by a signal, try again
+    }
+    return result == 0;
+}
+
+#endif
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#elif !defined(_WIN32)
+#include <semaphore.h>
+#endif
+
+namespace sfz {
+/**
+ * @brief A counting semaphore that can be posted from the audio thread.
+ *
+ * Posting does not take a lock nor allocate; this is what the background
+ * threads block on until the audio thread gives them work. Whether it enters
+ * the kernel depends on the platform: POSIX semaphores on glibc and dispatch
+ * semaphores usually only do so when a thread is waiting, while Win32
+ * semaphores always do. Waiting blocks, so it has to happen on another thread.
+ */
+class RTSemaphore {
+public:
+    explicit RTSemaphore(unsigned initialCount = 0);
+    ~RTSemaphore();
+    RTSemaphore(const RTSemaphore&) = delete;
+    RTSemaphore& operator=(const RTSemaphore&) = delete;
+    /**
+     * @brief Increment the count, waking up a waiting thread if any.
+     * This can be called from the audio thread.
+     */
+    void post() noexcept;
+    /**
+     * @brief Block until the count is positive, then decrement it.
+     */
+    void wait() noexcept;
+    /**
+     * @brief Decrement the count if it is positive, without blocking
+     *
+     * @return true if the count was decremented
+     */
+    bool tryWait() noexcept;
+
+private:
+#if defined(__APPLE__)
+    dispatch_semaphore_t semaphore;
+#elif defined(_WIN32)
+    void* semaphore;
+#else
+    sem_t semaphore;
+#endif
+};
+}
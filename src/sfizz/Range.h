@@ -53,6 +53,8 @@ public:
     std::pair<Type, Type> getPair() const noexcept { return std::make_pair<Type, Type>(_start, _end); }
     Range(const Range<Type>& range) = default;
     Range(Range<Type>&& range) = default;
+    Range<Type>& operator=(const Range<Type>& range) = default;
+    Range<Type>& operator=(Range<Type>&& range) = default;
     constexpr Type length() const { return _end - _start; }
     void setStart(Type start) noexcept
     {
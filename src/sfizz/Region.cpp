@@ -32,9 +32,9 @@ bool sfz::Region::parseOpcode(const Opcode& opcode)
                 break;
 
             if (trimmedSample[0] == '*')
-                sample = std::string(trimmedSample);
+                sampleId = sampleTable.intern(trimmedSample);
             else
-                sample = absl::StrCat(defaultPath, absl::StrReplaceAll(trimmedSample, { { "\\", "/" } }));
+                sampleId = sampleTable.intern(absl::StrCat(defaultPath, absl::StrReplaceAll(trimmedSample, { { "\\", "/" } })));
         }
         break;
     case hash("delay"):
@@ -84,6 +84,17 @@ bool sfz::Region::parseOpcode(const Opcode& opcode)
     case hash("loop_start"):
         setRangeStartFromOpcode(opcode, loopRange, Default::loopRange);
         break;
+    case hash("sample_quality"):
+        if (auto value = readOpcode(opcode.value, Default::sampleQualityRange)) {
+            // Only 3 qualities are implemented, the higher ones use the best
+            if (*value <= static_cast<int>(InterpolationQuality::Linear))
+                sampleQuality = InterpolationQuality::Linear;
+            else if (*value == static_cast<int>(InterpolationQuality::Hermite))
+                sampleQuality = InterpolationQuality::Hermite;
+            else
+                sampleQuality = InterpolationQuality::Sinc;
+        }
+        break;
 
     // Instrument settings: voice lifecycle
     case hash("group"):
@@ -719,6 +730,22 @@ float sfz::Region::getNoteGain(int noteNumber, uint8_t velocity) noexcept
     return baseGain;
 }
 
+bool sfz::Region::isModulatedByCC(int ccNumber) const noexcept
+{
+    const auto modulates = [ccNumber](const absl::optional<CCValuePair>& modifier) {
+        return modifier && modifier->first == ccNumber;
+    };
+
+    if (checkSustain && ccNumber == config::sustainCC)
+        return true;
+
+    if (modulates(amplitudeCC) || modulates(volumeCC) || modulates(panCC)
+        || modulates(positionCC) || modulates(widthCC))
+        return true;
+
+    return crossfadeCCInRange.contains(ccNumber) || crossfadeCCOutRange.contains(ccNumber);
+}
+
 float sfz::Region::getCrossfadeGain(const sfz::SfzCCArray& ccState) noexcept
 {
     float gain { 1.0f };
@@ -820,3 +847,13 @@ void sfz::Region::offsetAllKeys(int offset) noexcept
         crossfadeKeyOutRange.setEnd(offsetAndClamp(end, offset, Default::keyRange));
     }
 }
+
+size_t sfz::Region::getMemoryUsage() const noexcept
+{
+    return sizeof(*this)
+        + ccConditions.getAllocatedBytes()
+        + ccTriggers.getAllocatedBytes()
+        + crossfadeCCInRange.getAllocatedBytes()
+        + crossfadeCCOutRange.getAllocatedBytes()
+        + velocityPoints.capacity() * sizeof(decltype(velocityPoints)::value_type);
+}
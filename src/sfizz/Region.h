@@ -12,6 +12,7 @@
 #include "Opcode.h"
 #include "AudioBuffer.h"
 #include "MidiState.h"
+#include "SampleTable.h"
 #include "absl/strings/str_cat.h"
 #include <bitset>
 #include <absl/types/optional.h>
@@ -33,10 +34,11 @@ namespace sfz {
  *
  */
 struct Region {
-    Region(const MidiState& midiState, absl::string_view defaultPath = "")
-    : midiState(midiState), defaultPath(std::move(defaultPath))
+    Region(const MidiState& midiState, SampleTable& sampleTable, absl::string_view defaultPath = "")
+    : midiState(midiState), sampleTable(sampleTable), defaultPath(std::move(defaultPath))
     {
         ccSwitched.set();
+        sampleId = sampleTable.intern("");
     }
     Region(const Region&) = default;
     ~Region() = default;
@@ -54,7 +56,17 @@ struct Region {
      * @return true
      * @return false
      */
-    bool isGenerator() const noexcept { return sample.size() > 0 ? sample[0] == '*' : false; }
+    bool isGenerator() const noexcept
+    {
+        const auto& sample = getSample();
+        return sample.size() > 0 ? sample[0] == '*' : false;
+    }
+    /**
+     * @brief Get the path of the sample, or the name of the generator
+     *
+     * @return const std::string&
+     */
+    const std::string& getSample() const noexcept { return sampleTable.getPath(sampleId); }
     /**
      * @brief Is a looping region (at least potentially)?
      *
@@ -156,6 +168,16 @@ struct Region {
      * @return float
      */
     float getBaseVolumedB(int noteNumber) noexcept;
+    /**
+     * @brief Check if the voices playing the region react to a CC, through
+     * their amplitude, volume, pan, position, width, crossfades or the
+     * sustain pedal.
+     *
+     * @param ccNumber
+     * @return true
+     * @return false
+     */
+    bool isModulatedByCC(int ccNumber) const noexcept;
     /**
      * @brief Get the base gain of the region.
      *
@@ -202,10 +224,53 @@ struct Region {
     uint32_t loopStart(Oversampling factor = Oversampling::x1) const noexcept;
     uint32_t loopEnd(Oversampling factor = Oversampling::x1) const noexcept;
 
+    /**
+     * @brief Set the number of note-ons received before the next one on the
+     * keys of the region, which gives its position in the sequence for the
+     * next call to registerNoteOn. This is for callers that do not register
+     * every note-on with the region.
+     *
+     * @param counter
+     */
+    void setSequenceCounter(int counter) noexcept { sequenceCounter = counter; }
     bool hasKeyswitches() const noexcept { return keyswitchDown || keyswitchUp || keyswitch || previousNote; }
+    bool triggersOnCC() const noexcept { return triggerOnCC; }
+    /**
+     * @brief Get the memory held by the region, in bytes. The sample path is
+     * held by the sample table, which the regions share.
+     *
+     * @return size_t
+     */
+    size_t getMemoryUsage() const noexcept;
+    /**
+     * @brief Read or write the members set by the opcodes, along with the
+     * trigger state, through an archive of the instrument cache. A new member
+     * has to be added here, and the version of the cache entries bumped when
+     * members are reordered or change type without changing the region size.
+     *
+     * @param archive
+     */
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(keyRange, velocityRange, bendRange, ccConditions, keyswitchRange);
+        archive(keyswitch, keyswitchUp, keyswitchDown, previousNote, velocityOverride, checkSustain, checkSostenuto);
+        archive(aftertouchRange, bpmRange, randRange, sequenceLength, sequencePosition, trigger, ccTriggers);
+        archive(keySwitched, previousKeySwitched, sequenceSwitched, pitchSwitched, bpmSwitched, aftertouchSwitched);
+        archive(ccSwitched, triggerOnCC, sequenceCounter);
+        archive(sampleId, delay, delayRandom, offset, offsetRandom, sampleEnd, sampleCount, loopMode, loopRange, sampleQuality);
+        archive(group, offBy, offMode);
+        archive(volume, amplitude, pan, width, position, volumeCC, amplitudeCC, panCC, widthCC, positionCC);
+        archive(ampKeycenter, ampKeytrack, ampVeltrack, velocityPoints, ampRandom);
+        archive(crossfadeKeyInRange, crossfadeKeyOutRange, crossfadeVelInRange, crossfadeVelOutRange);
+        archive(crossfadeKeyCurve, crossfadeVelCurve, crossfadeCCCurve, crossfadeCCInRange, crossfadeCCOutRange, rtDecay);
+        archive(pitchKeycenter, pitchKeytrack, pitchRandom, pitchVeltrack, transpose, tune, bendUp, bendDown, bendStep);
+        archive(amplitudeEG, pitchEG, filterEG, isStereo);
+        archive(volumeDistribution, delayDistribution, offsetDistribution, pitchDistribution);
+    }
 
     // Sound source: sample playback
-    std::string sample {}; // Sample
+    SampleId sampleId {}; // sample, interned in the sample table
     float delay { Default::delay }; // delay
     float delayRandom { Default::delayRandom }; // delay_random
     uint32_t offset { Default::offset }; // offset
@@ -214,6 +279,7 @@ struct Region {
     absl::optional<uint32_t> sampleCount {}; // count
     absl::optional<SfzLoopMode> loopMode {}; // loopmode
     Range<uint32_t> loopRange { Default::loopRange }; //loopstart and loopend
+    absl::optional<InterpolationQuality> sampleQuality {}; // sample_quality
 
     // Instrument settings: voice lifecycle
     uint32_t group { Default::group }; // group
@@ -294,6 +360,7 @@ struct Region {
     bool isStereo { false };
 private:
     const MidiState& midiState;
+    SampleTable& sampleTable;
     bool keySwitched { true };
     bool previousKeySwitched { true };
     bool sequenceSwitched { true };
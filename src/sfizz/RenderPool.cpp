@@ -0,0 +1,202 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "RenderPool.h"
+#include "Debug.h"
+#include "MathHelpers.h"
+#include "ScopedFTZ.h"
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+/**
+ * @brief Give the calling worker thread a real-time priority and pin it to a
+ * core. This is best effort: without the privileges the thread keeps its
+ * normal priority.
+ *
+ * @param index the index of the worker
+ */
+void promoteWorkerThread([[maybe_unused]] int index) noexcept
+{
+#if defined(_WIN32)
+    if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL)) {
+        DBG("[sfizz] Could not raise the priority of render worker " << index);
+    }
+#else
+    sched_param parameters {};
+    parameters.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters) != 0) {
+        DBG("[sfizz] Could not raise the priority of render worker " << index);
+    }
+#if defined(__linux__)
+    // Leave the first core to the audio thread
+    const auto numCores = std::thread::hardware_concurrency();
+    if (numCores > 1) {
+        cpu_set_t cores;
+        CPU_ZERO(&cores);
+        CPU_SET(1 + static_cast<unsigned>(index) % (numCores - 1), &cores);
+        pthread_setaffinity_np(pthread_self(), sizeof(cores), &cores);
+    }
+#endif
+#endif
+}
+}
+
+sfz::RenderPool::RenderPool(int numThreads)
+{
+    setNumThreads(numThreads);
+}
+
+sfz::RenderPool::~RenderPool()
+{
+    stopThreads();
+}
+
+void sfz::RenderPool::setNumThreads(int numThreads)
+{
+    ASSERT(numThreads >= 0);
+    stopThreads();
+
+    quitThreads = false;
+    for (int i = 0; i < numThreads; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->mixBuffer.resize(samplesPerBlock);
+        worker->tempBuffer.resize(samplesPerBlock);
+        workers.push_back(std::move(worker));
+    }
+
+    for (int i = 0; i < numThreads; ++i) {
+        auto& worker = *workers[i];
+        worker.thread = std::thread(&RenderPool::workerThread, this, std::ref(worker), i);
+    }
+}
+
+void sfz::RenderPool::setSamplesPerBlock(int samplesPerBlock)
+{
+    this->samplesPerBlock = samplesPerBlock;
+    for (auto& worker : workers) {
+        worker->mixBuffer.resize(samplesPerBlock);
+        worker->tempBuffer.resize(samplesPerBlock);
+    }
+}
+
+void sfz::RenderPool::stopThreads()
+{
+    quitThreads = true;
+    for (auto& worker : workers)
+        worker->semaphore.post();
+
+    for (auto& worker : workers)
+        worker->thread.join();
+
+    workers.clear();
+}
+
+namespace {
+constexpr uint64_t makeVoiceRange(uint32_t begin, uint32_t end) noexcept
+{
+    return (static_cast<uint64_t>(end) << 32) | begin;
+}
+}
+
+void sfz::RenderPool::render(absl::Span<Voice* const> voices, AudioSpan<float> output, AudioSpan<float> tempSpan) noexcept
+{
+    ASSERT(output.getNumFrames() <= static_cast<size_t>(samplesPerBlock));
+    const auto numFrames = output.getNumFrames();
+    tempSpan = tempSpan.first(numFrames);
+
+    blockVoices = voices;
+    blockFrames = numFrames;
+
+    // Only wake up workers if there is something left to share
+    const auto numWorkers = voices.size() > 1 ? min(voices.size() - 1, workers.size()) : size_t { 0 };
+    const auto rangeStart = [&](size_t participant) {
+        return static_cast<uint32_t>(participant * voices.size() / (numWorkers + 1));
+    };
+
+    for (size_t i = 0; i < numWorkers; ++i) {
+        auto& worker = *workers[i];
+        worker.numMixed.store(0, std::memory_order_relaxed);
+        worker.voiceRange.store(makeVoiceRange(rangeStart(i + 1), rangeStart(i + 2)), std::memory_order_release);
+        worker.semaphore.post();
+    }
+
+    const auto renderInline = [&](uint32_t index) {
+        voices[index]->renderBlock(tempSpan);
+        output.add(tempSpan);
+    };
+
+    for (uint32_t index = 0, end = rangeStart(1); index < end; ++index)
+        renderInline(index);
+
+    for (size_t i = 0; i < numWorkers; ++i) {
+        auto& worker = *workers[i];
+        uint32_t numTakenBack { 0 };
+        uint32_t index;
+        while (takeVoice(worker.voiceRange, index)) {
+            renderInline(index);
+            numTakenBack++;
+        }
+
+        // Wait for the voices the worker took, which it is rendering
+        const auto numTaken = rangeStart(i + 2) - rangeStart(i + 1) - numTakenBack;
+        while (worker.numMixed.load(std::memory_order_acquire) < numTaken) {
+            std::this_thread::yield();
+        }
+
+        if (numTaken > 0) {
+            auto mixSpan = AudioSpan<float>(worker.mixBuffer).first(numFrames);
+            output.add(mixSpan);
+        }
+    }
+}
+
+bool sfz::RenderPool::takeVoice(std::atomic<uint64_t>& voiceRange, uint32_t& index) noexcept
+{
+    // The next index may go past the end, by one for each thread that finds
+    // the range exhausted, until the range of the next block is set
+    const auto range = voiceRange.fetch_add(1, std::memory_order_acq_rel);
+    index = static_cast<uint32_t>(range);
+    return index < static_cast<uint32_t>(range >> 32);
+}
+
+void sfz::RenderPool::renderWorkerVoices(Worker& worker) noexcept
+{
+    uint32_t index;
+    while (takeVoice(worker.voiceRange, index)) {
+        // Having taken a voice, the block stays the same until it is mixed
+        auto mixSpan = AudioSpan<float>(worker.mixBuffer).first(blockFrames);
+        auto tempSpan = AudioSpan<float>(worker.tempBuffer).first(blockFrames);
+        const auto numMixed = worker.numMixed.load(std::memory_order_relaxed);
+        if (numMixed == 0)
+            mixSpan.fill(0.0f);
+
+        blockVoices[index]->renderBlock(tempSpan);
+        mixSpan.add(tempSpan);
+        worker.numMixed.store(numMixed + 1, std::memory_order_release);
+    }
+}
+
+void sfz::RenderPool::workerThread(Worker& worker, int index) noexcept
+{
+    promoteWorkerThread(index);
+    ScopedFTZ ftz;
+
+    while (true) {
+        worker.semaphore.wait();
+        if (quitThreads)
+            return;
+
+        renderWorkerVoices(worker);
+    }
+}
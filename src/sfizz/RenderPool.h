@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "AudioBuffer.h"
+#include "AudioSpan.h"
+#include "Config.h"
+#include "LeakDetector.h"
+#include "RTSemaphore.h"
+#include "Voice.h"
+#include "absl/types/span.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace sfz {
+/**
+ * @brief A pool of real-time worker threads that render the active voices
+ * of a block in parallel with the audio thread.
+ *
+ * For each block the active voices are split in contiguous ranges, one for
+ * the audio thread and one for each worker that is woken. The workers take
+ * the voices of their range one at a time and mix them in a private buffer,
+ * which the audio thread adds to the output. Once done with its own range,
+ * the audio thread takes back the voices that the workers did not take yet
+ * and renders them inline, so a worker that wakes up late simply finds
+ * fewer voices left or none at all. Taking a voice is a single atomic
+ * increment on the range, for the workers and the audio thread alike.
+ *
+ * The audio thread only waits on the voices that a worker already took and
+ * is still rendering, never on a worker that did not start. A worker woken
+ * for a block it missed finds its range exhausted and goes back to sleep.
+ * The workers are given a real-time priority and pinned to a core where the
+ * platform allows it.
+ */
+class RenderPool {
+public:
+    /**
+     * @brief Construct a new render pool
+     *
+     * @param numThreads the number of worker threads; with no worker the
+     *                   voices are all rendered on the audio thread.
+     */
+    RenderPool(int numThreads = config::numRenderThreads);
+    ~RenderPool();
+    /**
+     * @brief Change the number of worker threads. This stops and starts
+     * threads, so it must not be called while rendering.
+     *
+     * @param numThreads
+     */
+    void setNumThreads(int numThreads);
+    int getNumThreads() const noexcept { return static_cast<int>(workers.size()); }
+    /**
+     * @brief Set the maximum number of frames per block. This allocates the
+     * mix buffers of the workers, so it must not be called while rendering.
+     *
+     * @param samplesPerBlock
+     */
+    void setSamplesPerBlock(int samplesPerBlock);
+    /**
+     * @brief Render a set of voices and add them to an output. This has to be
+     * called on the audio thread.
+     *
+     * @param voices the voices to render
+     * @param output the output, which the voices are added to
+     * @param tempSpan a temporary buffer of the audio thread, at least as
+     *                 large as the output
+     */
+    void render(absl::Span<Voice* const> voices, AudioSpan<float> output, AudioSpan<float> tempSpan) noexcept;
+
+    RenderPool(const RenderPool&) = delete;
+    RenderPool& operator=(const RenderPool&) = delete;
+private:
+    struct Worker {
+        std::thread thread;
+        RTSemaphore semaphore;
+        // Voice range of the worker in the current block, with the index of
+        // the next voice to take in the low 32 bits and the end of the range
+        // in the high 32 bits
+        std::atomic<uint64_t> voiceRange { 0 };
+        // Number of voices the worker mixed in the current block, reset by
+        // the audio thread before giving it a new range
+        std::atomic<uint32_t> numMixed { 0 };
+        AudioBuffer<float> mixBuffer { config::numChannels, config::defaultSamplesPerBlock };
+        AudioBuffer<float> tempBuffer { config::numChannels, config::defaultSamplesPerBlock };
+    };
+    void workerThread(Worker& worker, int index) noexcept;
+    /**
+     * @brief Take the next voice of a range
+     *
+     * @param voiceRange
+     * @param index the index of the voice taken
+     * @return true if a voice was taken, false if the range is exhausted
+     */
+    static bool takeVoice(std::atomic<uint64_t>& voiceRange, uint32_t& index) noexcept;
+    /**
+     * @brief Take the voices of the worker range until there is none left,
+     * and mix them in the worker buffer.
+     *
+     * @param worker
+     */
+    void renderWorkerVoices(Worker& worker) noexcept;
+    void stopThreads();
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    int samplesPerBlock { config::defaultSamplesPerBlock };
+    std::atomic<bool> quitThreads { false };
+
+    // The current block, written by the audio thread before giving the
+    // workers their ranges. It does not change while a worker renders a
+    // voice that it took.
+    absl::Span<Voice* const> blockVoices;
+    size_t blockFrames { 0 };
+
+    LEAK_DETECTOR(RenderPool);
+};
+}
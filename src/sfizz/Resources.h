@@ -7,12 +7,17 @@
 #pragma once
 #include "FilePool.h"
 #include "Logger.h"
+#include "SampleTable.h"
+#include <memory>
 
 namespace sfz
 {
 struct Resources
 {
     Logger logger;
-    FilePool filePool { logger };
+    // Held by pointer so that the regions keep referring to the same table
+    // when the table of a new instrument is swapped in
+    std::unique_ptr<SampleTable> sampleTable { std::make_unique<SampleTable>() };
+    FilePool filePool { logger, *sampleTable };
 };
 }
@@ -134,6 +134,12 @@ void sfz::pan<float, true>(absl::Span<const float> panEnvelope, absl::Span<float
     pan<float, false>(panEnvelope, leftBuffer, rightBuffer);
 }
 
+template <>
+void sfz::panGains<float, true>(absl::Span<const float> panEnvelope, absl::Span<float> leftGain, absl::Span<float> rightGain) noexcept
+{
+    panGains<float, false>(panEnvelope, leftGain, rightGain);
+}
+
 template <>
 float sfz::mean<float, true>(absl::Span<const float> vector) noexcept
 {
@@ -163,3 +169,39 @@ void sfz::diff<float, true>(absl::Span<const float> input, absl::Span<float> out
 {
     diff<float, false>(input, output);
 }
+
+template <>
+void sfz::interpolateLinear<float, true>(absl::Span<const float> input, absl::Span<const int> indices, absl::Span<const float> leftCoeffs, absl::Span<const float> rightCoeffs, absl::Span<float> output) noexcept
+{
+    interpolateLinear<float, false>(input, indices, leftCoeffs, rightCoeffs, output);
+}
+
+template <>
+void sfz::interpolateLinear<int16_t, true>(absl::Span<const int16_t> input, absl::Span<const int> indices, absl::Span<const float> leftCoeffs, absl::Span<const float> rightCoeffs, absl::Span<float> output) noexcept
+{
+    interpolateLinear<int16_t, false>(input, indices, leftCoeffs, rightCoeffs, output);
+}
+
+template <>
+void sfz::interpolateHermite<float, true>(absl::Span<const float> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept
+{
+    interpolateHermite<float, false>(input, indices, positions, output);
+}
+
+template <>
+void sfz::interpolateHermite<int16_t, true>(absl::Span<const int16_t> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept
+{
+    interpolateHermite<int16_t, false>(input, indices, positions, output);
+}
+
+template <>
+void sfz::interpolateSinc<float, true>(absl::Span<const float> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept
+{
+    interpolateSinc<float, false>(input, indices, positions, output);
+}
+
+template <>
+void sfz::interpolateSinc<int16_t, true>(absl::Span<const int16_t> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept
+{
+    interpolateSinc<int16_t, false>(input, indices, positions, output);
+}
@@ -41,6 +41,8 @@
 #include "Config.h"
 #include "Debug.h"
 #include "MathHelpers.h"
+#include "PanTable.h"
+#include "SincTable.h"
 #include <absl/algorithm/container.h>
 #include <absl/types/span.h>
 #include <cmath>
@@ -722,16 +724,57 @@ void copy<float, true>(absl::Span<const float> input, absl::Span<float> output)
 
 namespace _internals {
     template <class T>
-    inline void snippetPan(const T*& pan, T*& left, T*& right)
+    inline void snippetPanGains(const PanTable& table, const T*& pan, T*& leftGain, T*& rightGain)
     {
-        const auto circlePan = piFour<float> * (static_cast<T>(1.0) + *pan++);
-        *left++ *= std::cos(circlePan);
-        *right++ *= std::sin(circlePan);
+        // Read the pan before writing, as the pan span may be a gain span
+        const auto value = static_cast<float>(*pan++);
+        *leftGain++ = static_cast<T>(table.gain(0.5f * (1.0f + value)));
+        *rightGain++ = static_cast<T>(table.gain(0.5f * (1.0f - value)));
+    }
+
+    template <class T>
+    inline void snippetPan(const PanTable& table, const T*& pan, T*& left, T*& right)
+    {
+        const auto value = static_cast<float>(*pan++);
+        *left++ *= static_cast<T>(table.gain(0.5f * (1.0f + value)));
+        *right++ *= static_cast<T>(table.gain(0.5f * (1.0f - value)));
     }
 }
 
 /**
- * @brief Pans a mono signal left or right
+ * @brief Computes the left and right gains of the constant-power pan law
+ * for pan values between -1 (left) and 1 (right), that is cos(pi/4 * (1 + pan))
+ * and sin(pi/4 * (1 + pan)). The gains are read from the PanTable. The pan
+ * span can be one of the gain spans.
+ *
+ * The output size will be the minimum of the pan span and gain span sizes.
+ *
+ * @tparam T the underlying type
+ * @tparam SIMD use the SIMD version or the scalar version
+ * @param panEnvelope
+ * @param leftGain
+ * @param rightGain
+ */
+template <class T, bool SIMD = SIMDConfig::panGains>
+void panGains(absl::Span<const T> panEnvelope, absl::Span<T> leftGain, absl::Span<T> rightGain) noexcept
+{
+    ASSERT(leftGain.size() >= panEnvelope.size());
+    ASSERT(rightGain.size() >= panEnvelope.size());
+    const auto& table = PanTable::get();
+    auto* pan = panEnvelope.begin();
+    auto* left = leftGain.begin();
+    auto* right = rightGain.begin();
+    auto* sentinel = pan + min(panEnvelope.size(), leftGain.size(), rightGain.size());
+    while (pan < sentinel)
+        _internals::snippetPanGains(table, pan, left, right);
+}
+
+template <>
+void panGains<float, true>(absl::Span<const float> panEnvelope, absl::Span<float> leftGain, absl::Span<float> rightGain) noexcept;
+
+/**
+ * @brief Pans a mono signal left or right with the constant-power pan law
+ * of panGains
  *
  * The output size will be the minimum of the pan envelope span and left and right buffer span sizes.
  *
@@ -750,8 +793,9 @@ void pan(absl::Span<const T> panEnvelope, absl::Span<T> leftBuffer, absl::Span<T
     auto* left = leftBuffer.begin();
     auto* right = rightBuffer.begin();
     auto* sentinel = pan + min(panEnvelope.size(), leftBuffer.size(), rightBuffer.size());
+    const auto& table = PanTable::get();
     while (pan < sentinel)
-        _internals::snippetPan(pan, left, right);
+        _internals::snippetPan(table, pan, left, right);
 }
 
 template <>
@@ -890,6 +934,166 @@ void sfzInterpolationCast(absl::Span<const T> floatJumps, absl::Span<int> jumps,
 template <>
 void sfzInterpolationCast<float, true>(absl::Span<const float> floatJumps, absl::Span<int> jumps, absl::Span<float> leftCoeffs, absl::Span<float> rightCoeffs) noexcept;
 
+namespace _internals {
+    template <class T>
+    inline void snippetInterpolateLinear(const T* input, const int*& index, const float*& leftCoeff, const float*& rightCoeff, float*& output)
+    {
+        *output = linearInterpolation(sampleToFloat(input[*index]), sampleToFloat(input[*index + 1]), *leftCoeff, *rightCoeff);
+        incrementAll(index, leftCoeff, rightCoeff, output);
+    }
+}
+
+/**
+ * @brief Interpolates linearly between the elements of an input at integer
+ * indices and the ones following them, as computed by sfzInterpolationCast.
+ * The input elements are converted to float on the fly, so that samples
+ * stored as 16-bit integers are read in their own width.
+ *
+ * The output size will be the minimum of the indices, coefficients and output span sizes.
+ * All the indices plus one have to be valid positions in the input.
+ *
+ * @tparam T the underlying type of the input
+ * @tparam SIMD use the SIMD version or the scalar version
+ * @param input
+ * @param indices
+ * @param leftCoeffs
+ * @param rightCoeffs
+ * @param output
+ */
+template <class T, bool SIMD = SIMDConfig::interpolateLinear>
+void interpolateLinear(absl::Span<const T> input, absl::Span<const int> indices, absl::Span<const float> leftCoeffs, absl::Span<const float> rightCoeffs, absl::Span<float> output) noexcept
+{
+    ASSERT(indices.size() == leftCoeffs.size());
+    ASSERT(indices.size() == rightCoeffs.size());
+    ASSERT(output.size() >= indices.size());
+
+    auto in = input.data();
+    auto index = indices.data();
+    auto leftCoeff = leftCoeffs.data();
+    auto rightCoeff = rightCoeffs.data();
+    auto out = output.data();
+    const auto sentinel = index + min(indices.size(), leftCoeffs.size(), rightCoeffs.size(), output.size());
+
+    while (index < sentinel)
+        _internals::snippetInterpolateLinear(in, index, leftCoeff, rightCoeff, out);
+}
+
+template <>
+void interpolateLinear<float, true>(absl::Span<const float> input, absl::Span<const int> indices, absl::Span<const float> leftCoeffs, absl::Span<const float> rightCoeffs, absl::Span<float> output) noexcept;
+
+template <>
+void interpolateLinear<int16_t, true>(absl::Span<const int16_t> input, absl::Span<const int> indices, absl::Span<const float> leftCoeffs, absl::Span<const float> rightCoeffs, absl::Span<float> output) noexcept;
+
+namespace _internals {
+    template <class T>
+    inline float clampedSample(absl::Span<const T> input, int index)
+    {
+        return sampleToFloat(input[static_cast<size_t>(clamp(index, 0, static_cast<int>(input.size()) - 1))]);
+    }
+
+    template <class T>
+    inline void snippetInterpolateHermite(absl::Span<const T> input, const int*& index, const float*& position, float*& output)
+    {
+        const auto i = *index;
+        if (i >= 1 && i + 2 < static_cast<int>(input.size())) {
+            const T* in = input.data() + i;
+            *output = hermiteInterpolation(sampleToFloat(in[-1]), sampleToFloat(in[0]), sampleToFloat(in[1]), sampleToFloat(in[2]), *position);
+        } else {
+            *output = hermiteInterpolation(clampedSample(input, i - 1), clampedSample(input, i),
+                clampedSample(input, i + 1), clampedSample(input, i + 2), *position);
+        }
+        incrementAll(index, position, output);
+    }
+
+    template <class T>
+    inline void snippetInterpolateSinc(const SincTable& table, absl::Span<const T> input, const int*& index, const float*& position, float*& output)
+    {
+        const auto i = *index;
+        if (i >= SincTable::tapsBefore && i + SincTable::tapsAfter < static_cast<int>(input.size())) {
+            const T* in = input.data() + i;
+            *output = table.interpolate(*position, [in](int offset) { return sampleToFloat(in[offset]); });
+        } else {
+            *output = table.interpolate(*position, [input, i](int offset) { return clampedSample(input, i + offset); });
+        }
+        incrementAll(index, position, output);
+    }
+}
+
+/**
+ * @brief Interpolates between the elements of an input at integer indices
+ * and the ones following them with a cubic Hermite polynomial, which uses
+ * one more element on each side. The elements out of the input are replaced
+ * by the nearest one.
+ *
+ * The output size will be the minimum of the indices, positions and output span sizes.
+ *
+ * @tparam T the underlying type of the input
+ * @tparam SIMD use the SIMD version or the scalar version
+ * @param input
+ * @param indices
+ * @param positions the fractional positions after the indices, which are
+ *                  the right coefficients computed by sfzInterpolationCast
+ * @param output
+ */
+template <class T, bool SIMD = SIMDConfig::interpolateHermite>
+void interpolateHermite(absl::Span<const T> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept
+{
+    ASSERT(indices.size() == positions.size());
+    ASSERT(output.size() >= indices.size());
+
+    auto index = indices.data();
+    auto position = positions.data();
+    auto out = output.data();
+    const auto sentinel = index + min(indices.size(), positions.size(), output.size());
+
+    while (index < sentinel)
+        _internals::snippetInterpolateHermite(input, index, position, out);
+}
+
+template <>
+void interpolateHermite<float, true>(absl::Span<const float> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept;
+
+template <>
+void interpolateHermite<int16_t, true>(absl::Span<const int16_t> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept;
+
+/**
+ * @brief Interpolates between the elements of an input at integer indices
+ * and the ones following them with the windowed sinc of SincTable, which
+ * uses 8 elements around each position. The elements out of the input are
+ * replaced by the nearest one.
+ *
+ * The output size will be the minimum of the indices, positions and output span sizes.
+ *
+ * @tparam T the underlying type of the input
+ * @tparam SIMD use the SIMD version or the scalar version
+ * @param input
+ * @param indices
+ * @param positions the fractional positions after the indices, which are
+ *                  the right coefficients computed by sfzInterpolationCast
+ * @param output
+ */
+template <class T, bool SIMD = SIMDConfig::interpolateSinc>
+void interpolateSinc(absl::Span<const T> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept
+{
+    ASSERT(indices.size() == positions.size());
+    ASSERT(output.size() >= indices.size());
+
+    const auto& table = SincTable::get();
+    auto index = indices.data();
+    auto position = positions.data();
+    auto out = output.data();
+    const auto sentinel = index + min(indices.size(), positions.size(), output.size());
+
+    while (index < sentinel)
+        _internals::snippetInterpolateSinc(table, input, index, position, out);
+}
+
+template <>
+void interpolateSinc<float, true>(absl::Span<const float> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept;
+
+template <>
+void interpolateSinc<int16_t, true>(absl::Span<const int16_t> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept;
+
 namespace _internals {
     template <class T>
     inline void snippetDiff(const T*& input, T*& output)
@@ -205,6 +205,55 @@ void sfz::pan<float, true>(absl::Span<const float> panEnvelope, absl::Span<float
     pan<float, false>(panEnvelope, leftBuffer, rightBuffer);
 }
 
+namespace {
+/**
+ * @brief Read 4 gains of the pan law from the pan table, at positions
+ * between 0 and 1
+ */
+inline float32x4_t panTableGains(const float* table, float32x4_t position) noexcept
+{
+    position = vminq_f32(vmaxq_f32(position, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f));
+    position = vmulq_n_f32(position, static_cast<float>(sfz::PanTable::size));
+    const auto indices = vcvtq_s32_f32(position);
+    const auto fraction = vsubq_f32(position, vcvtq_f32_s32(indices));
+    int32_t index[4];
+    vst1q_s32(index, indices);
+
+    // NEON has no gather, so the loads are scalar but the interpolation is not
+    const float lowValues[4] { table[index[0]], table[index[1]], table[index[2]], table[index[3]] };
+    const float highValues[4] { table[index[0] + 1], table[index[1] + 1], table[index[2] + 1], table[index[3] + 1] };
+    const auto low = vld1q_f32(lowValues);
+    return vaddq_f32(low, vmulq_f32(fraction, vsubq_f32(vld1q_f32(highValues), low)));
+}
+}
+
+template <>
+void sfz::panGains<float, true>(absl::Span<const float> panEnvelope, absl::Span<float> leftGain, absl::Span<float> rightGain) noexcept
+{
+    ASSERT(leftGain.size() >= panEnvelope.size());
+    ASSERT(rightGain.size() >= panEnvelope.size());
+    const auto& table = PanTable::get();
+    auto* pan = panEnvelope.begin();
+    auto* left = leftGain.begin();
+    auto* right = rightGain.begin();
+    const auto size = min(panEnvelope.size(), leftGain.size(), rightGain.size());
+    auto* sentinel = pan + size;
+    auto* lastVector = pan + (size & ~TypeAlignmentMask);
+
+    const auto half = vdupq_n_f32(0.5f);
+    while (pan < lastVector) {
+        const auto panValues = vmulq_f32(half, vld1q_f32(pan));
+        const auto leftValues = panTableGains(table.data(), vaddq_f32(half, panValues));
+        const auto rightValues = panTableGains(table.data(), vsubq_f32(half, panValues));
+        vst1q_f32(left, leftValues);
+        vst1q_f32(right, rightValues);
+        incrementAll<TypeAlignment>(pan, left, right);
+    }
+
+    while (pan < sentinel)
+        _internals::snippetPanGains(table, pan, left, right);
+}
+
 template <>
 float sfz::mean<float, true>(absl::Span<const float> vector) noexcept
 {
@@ -234,3 +283,239 @@ void sfz::diff<float, true>(absl::Span<const float> input, absl::Span<float> out
 {
     diff<float, false>(input, output);
 }
+
+template <>
+void sfz::interpolateLinear<float, true>(absl::Span<const float> input, absl::Span<const int> indices, absl::Span<const float> leftCoeffs, absl::Span<const float> rightCoeffs, absl::Span<float> output) noexcept
+{
+    ASSERT(indices.size() == leftCoeffs.size());
+    ASSERT(indices.size() == rightCoeffs.size());
+    ASSERT(output.size() >= indices.size());
+
+    auto in = input.data();
+    auto index = indices.data();
+    auto leftCoeff = leftCoeffs.data();
+    auto rightCoeff = rightCoeffs.data();
+    auto out = output.data();
+    const auto size = min(indices.size(), leftCoeffs.size(), rightCoeffs.size(), output.size());
+    const auto sentinel = index + size;
+    const auto lastVector = index + (size & ~TypeAlignmentMask);
+
+    // NEON has no gather, so the loads are scalar but the interpolation is not
+    while (index < lastVector) {
+        const float leftValues[4] { in[index[0]], in[index[1]], in[index[2]], in[index[3]] };
+        const float rightValues[4] { in[index[0] + 1], in[index[1] + 1], in[index[2] + 1], in[index[3] + 1] };
+        auto left = vmulq_f32(vld1q_f32(leftValues), vld1q_f32(leftCoeff));
+        auto right = vmulq_f32(vld1q_f32(rightValues), vld1q_f32(rightCoeff));
+        vst1q_f32(out, vaddq_f32(left, right));
+        incrementAll<TypeAlignment>(index, leftCoeff, rightCoeff, out);
+    }
+
+    while (index < sentinel)
+        _internals::snippetInterpolateLinear(in, index, leftCoeff, rightCoeff, out);
+}
+
+template <>
+void sfz::interpolateLinear<int16_t, true>(absl::Span<const int16_t> input, absl::Span<const int> indices, absl::Span<const float> leftCoeffs, absl::Span<const float> rightCoeffs, absl::Span<float> output) noexcept
+{
+    ASSERT(indices.size() == leftCoeffs.size());
+    ASSERT(indices.size() == rightCoeffs.size());
+    ASSERT(output.size() >= indices.size());
+
+    auto in = input.data();
+    auto index = indices.data();
+    auto leftCoeff = leftCoeffs.data();
+    auto rightCoeff = rightCoeffs.data();
+    auto out = output.data();
+    const auto size = min(indices.size(), leftCoeffs.size(), rightCoeffs.size(), output.size());
+    const auto sentinel = index + size;
+    const auto lastVector = index + (size & ~TypeAlignmentMask);
+
+    // The gathers are scalar, but the conversion and interpolation are not
+    const auto scale = vdupq_n_f32(sampleToFloat(int16_t { 1 }));
+    while (index < lastVector) {
+        const int32_t leftValues[4] { in[index[0]], in[index[1]], in[index[2]], in[index[3]] };
+        const int32_t rightValues[4] { in[index[0] + 1], in[index[1] + 1], in[index[2] + 1], in[index[3] + 1] };
+        auto left = vmulq_f32(vcvtq_f32_s32(vld1q_s32(leftValues)), scale);
+        auto right = vmulq_f32(vcvtq_f32_s32(vld1q_s32(rightValues)), scale);
+        left = vmulq_f32(left, vld1q_f32(leftCoeff));
+        right = vmulq_f32(right, vld1q_f32(rightCoeff));
+        vst1q_f32(out, vaddq_f32(left, right));
+        incrementAll<TypeAlignment>(index, leftCoeff, rightCoeff, out);
+    }
+
+    while (index < sentinel)
+        _internals::snippetInterpolateLinear(in, index, leftCoeff, rightCoeff, out);
+}
+
+namespace {
+/**
+ * @brief Check that the 4 indices of a vector can read the taps from
+ * index - before to index + after without going out of an input.
+ */
+inline bool vectorInRange(const int* index, int before, int after, int size) noexcept
+{
+    for (int k = 0; k < 4; ++k) {
+        if (index[k] < before || index[k] + after >= size)
+            return false;
+    }
+    return true;
+}
+
+inline float32x4_t hermiteNEON(float32x4_t x0, float32x4_t x1, float32x4_t x2, float32x4_t x3, float32x4_t position) noexcept
+{
+    const auto c1 = vmulq_n_f32(vsubq_f32(x2, x0), 0.5f);
+    auto c2 = vsubq_f32(x0, vmulq_n_f32(x1, 2.5f));
+    c2 = vaddq_f32(c2, vaddq_f32(x2, x2));
+    c2 = vsubq_f32(c2, vmulq_n_f32(x3, 0.5f));
+    auto c3 = vmulq_n_f32(vsubq_f32(x3, x0), 0.5f);
+    c3 = vaddq_f32(c3, vmulq_n_f32(vsubq_f32(x1, x2), 1.5f));
+    auto result = vaddq_f32(vmulq_f32(c3, position), c2);
+    result = vaddq_f32(vmulq_f32(result, position), c1);
+    return vaddq_f32(vmulq_f32(result, position), x1);
+}
+
+/**
+ * @brief Apply the sinc table row of a position to 8 taps
+ */
+inline float sincNEON(const sfz::SincTable& table, float32x4_t taps0, float32x4_t taps1, float position) noexcept
+{
+    int phase;
+    float phaseFraction;
+    sfz::SincTable::findPhase(position, phase, phaseFraction);
+    const float* lower = table.row(phase);
+    const float* upper = table.row(phase + 1);
+    auto lower0 = vld1q_f32(lower);
+    auto lower1 = vld1q_f32(lower + 4);
+    const auto coeffs0 = vaddq_f32(lower0, vmulq_n_f32(vsubq_f32(vld1q_f32(upper), lower0), phaseFraction));
+    const auto coeffs1 = vaddq_f32(lower1, vmulq_n_f32(vsubq_f32(vld1q_f32(upper + 4), lower1), phaseFraction));
+    const auto products = vaddq_f32(vmulq_f32(taps0, coeffs0), vmulq_f32(taps1, coeffs1));
+    const auto sums = vadd_f32(vget_low_f32(products), vget_high_f32(products));
+    return vget_lane_f32(vpadd_f32(sums, sums), 0);
+}
+}
+
+template <>
+void sfz::interpolateHermite<float, true>(absl::Span<const float> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept
+{
+    ASSERT(indices.size() == positions.size());
+    ASSERT(output.size() >= indices.size());
+
+    const auto in = input.data();
+    const auto inputSize = static_cast<int>(input.size());
+    auto index = indices.data();
+    auto position = positions.data();
+    auto out = output.data();
+    const auto size = min(indices.size(), positions.size(), output.size());
+    const auto sentinel = index + size;
+    const auto lastVector = index + (size & ~TypeAlignmentMask);
+
+    const auto gather = [&](int offset) {
+        const float values[4] { in[index[0] + offset], in[index[1] + offset], in[index[2] + offset], in[index[3] + offset] };
+        return vld1q_f32(values);
+    };
+
+    while (index < lastVector) {
+        if (!vectorInRange(index, 1, 2, inputSize)) {
+            for (unsigned k = 0; k < TypeAlignment; ++k)
+                _internals::snippetInterpolateHermite(input, index, position, out);
+            continue;
+        }
+        vst1q_f32(out, hermiteNEON(gather(-1), gather(0), gather(1), gather(2), vld1q_f32(position)));
+        incrementAll<TypeAlignment>(index, position, out);
+    }
+
+    while (index < sentinel)
+        _internals::snippetInterpolateHermite(input, index, position, out);
+}
+
+template <>
+void sfz::interpolateHermite<int16_t, true>(absl::Span<const int16_t> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept
+{
+    ASSERT(indices.size() == positions.size());
+    ASSERT(output.size() >= indices.size());
+
+    const auto in = input.data();
+    const auto inputSize = static_cast<int>(input.size());
+    auto index = indices.data();
+    auto position = positions.data();
+    auto out = output.data();
+    const auto size = min(indices.size(), positions.size(), output.size());
+    const auto sentinel = index + size;
+    const auto lastVector = index + (size & ~TypeAlignmentMask);
+
+    const auto scale = vdupq_n_f32(sampleToFloat(int16_t { 1 }));
+    const auto gather = [&](int offset) {
+        const int32_t values[4] { in[index[0] + offset], in[index[1] + offset], in[index[2] + offset], in[index[3] + offset] };
+        return vmulq_f32(vcvtq_f32_s32(vld1q_s32(values)), scale);
+    };
+
+    while (index < lastVector) {
+        if (!vectorInRange(index, 1, 2, inputSize)) {
+            for (unsigned k = 0; k < TypeAlignment; ++k)
+                _internals::snippetInterpolateHermite(input, index, position, out);
+            continue;
+        }
+        vst1q_f32(out, hermiteNEON(gather(-1), gather(0), gather(1), gather(2), vld1q_f32(position)));
+        incrementAll<TypeAlignment>(index, position, out);
+    }
+
+    while (index < sentinel)
+        _internals::snippetInterpolateHermite(input, index, position, out);
+}
+
+template <>
+void sfz::interpolateSinc<float, true>(absl::Span<const float> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept
+{
+    ASSERT(indices.size() == positions.size());
+    ASSERT(output.size() >= indices.size());
+
+    const auto& table = SincTable::get();
+    const auto in = input.data();
+    const auto inputSize = static_cast<int>(input.size());
+    auto index = indices.data();
+    auto position = positions.data();
+    auto out = output.data();
+    const auto sentinel = index + min(indices.size(), positions.size(), output.size());
+
+    // The 8 taps of an output sample are contiguous, so they are loaded as
+    // two vectors and the vectorization runs over the taps
+    while (index < sentinel) {
+        const auto i = *index;
+        if (i < SincTable::tapsBefore || i + SincTable::tapsAfter >= inputSize) {
+            _internals::snippetInterpolateSinc(table, input, index, position, out);
+            continue;
+        }
+        const float* taps = in + i - SincTable::tapsBefore;
+        *out = sincNEON(table, vld1q_f32(taps), vld1q_f32(taps + 4), *position);
+        incrementAll(index, position, out);
+    }
+}
+
+template <>
+void sfz::interpolateSinc<int16_t, true>(absl::Span<const int16_t> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept
+{
+    ASSERT(indices.size() == positions.size());
+    ASSERT(output.size() >= indices.size());
+
+    const auto& table = SincTable::get();
+    const auto in = input.data();
+    const auto inputSize = static_cast<int>(input.size());
+    auto index = indices.data();
+    auto position = positions.data();
+    auto out = output.data();
+    const auto sentinel = index + min(indices.size(), positions.size(), output.size());
+
+    const auto scale = vdupq_n_f32(sampleToFloat(int16_t { 1 }));
+    while (index < sentinel) {
+        const auto i = *index;
+        if (i < SincTable::tapsBefore || i + SincTable::tapsAfter >= inputSize) {
+            _internals::snippetInterpolateSinc(table, input, index, position, out);
+            continue;
+        }
+        const auto taps = vld1q_s16(in + i - SincTable::tapsBefore);
+        const auto taps0 = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(taps))), scale);
+        const auto taps1 = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(taps))), scale);
+        *out = sincNEON(table, taps0, taps1, *position);
+        incrementAll(index, position, out);
+    }
+}
@@ -585,38 +585,79 @@ void sfz::copy<float, true>(absl::Span<const float> input, absl::Span<float> out
         _internals::snippetCopy<float>(in, out);
 }
 
+namespace {
+/**
+ * @brief Read 4 gains of the pan law from the pan table, at positions
+ * between 0 and 1
+ */
+inline __m128 panTableGains(const float* table, __m128 mmPosition) noexcept
+{
+    mmPosition = _mm_min_ps(_mm_max_ps(mmPosition, _mm_setzero_ps()), _mm_set_ps1(1.0f));
+    mmPosition = _mm_mul_ps(mmPosition, _mm_set_ps1(static_cast<float>(sfz::PanTable::size)));
+    const auto mmIndex = _mm_cvttps_epi32(mmPosition);
+    const auto mmFraction = _mm_sub_ps(mmPosition, _mm_cvtepi32_ps(mmIndex));
+    alignas(ByteAlignment) int32_t index[TypeAlignment];
+    _mm_store_si128(reinterpret_cast<__m128i*>(index), mmIndex);
+
+    // SSE has no gather, so the loads are scalar but the interpolation is not
+    const auto mmLow = _mm_setr_ps(table[index[0]], table[index[1]], table[index[2]], table[index[3]]);
+    const auto mmHigh = _mm_setr_ps(table[index[0] + 1], table[index[1] + 1], table[index[2] + 1], table[index[3] + 1]);
+    return _mm_add_ps(mmLow, _mm_mul_ps(mmFraction, _mm_sub_ps(mmHigh, mmLow)));
+}
+}
+
+template <>
+void sfz::panGains<float, true>(absl::Span<const float> panEnvelope, absl::Span<float> leftGain, absl::Span<float> rightGain) noexcept
+{
+    ASSERT(leftGain.size() >= panEnvelope.size());
+    ASSERT(rightGain.size() >= panEnvelope.size());
+    const auto& table = PanTable::get();
+    auto* pan = panEnvelope.begin();
+    auto* left = leftGain.begin();
+    auto* right = rightGain.begin();
+    const auto size = min(panEnvelope.size(), leftGain.size(), rightGain.size());
+    auto* sentinel = pan + size;
+    auto* lastVector = pan + (size & ~TypeAlignmentMask);
+
+    const auto mmHalf = _mm_set_ps1(0.5f);
+    while (pan < lastVector) {
+        const auto mmPan = _mm_mul_ps(mmHalf, _mm_loadu_ps(pan));
+        const auto mmLeft = panTableGains(table.data(), _mm_add_ps(mmHalf, mmPan));
+        const auto mmRight = panTableGains(table.data(), _mm_sub_ps(mmHalf, mmPan));
+        _mm_storeu_ps(left, mmLeft);
+        _mm_storeu_ps(right, mmRight);
+        incrementAll<TypeAlignment>(pan, left, right);
+    }
+
+    while (pan < sentinel)
+        _internals::snippetPanGains(table, pan, left, right);
+}
+
 template <>
 void sfz::pan<float, true>(absl::Span<const float> panEnvelope, absl::Span<float> leftBuffer, absl::Span<float> rightBuffer) noexcept
 {
     ASSERT(leftBuffer.size() >= panEnvelope.size());
     ASSERT(rightBuffer.size() >= panEnvelope.size());
+    const auto& table = PanTable::get();
     auto* pan = panEnvelope.begin();
     auto* left = leftBuffer.begin();
     auto* right = rightBuffer.begin();
-    auto* sentinel = pan + min(panEnvelope.size(), leftBuffer.size(), rightBuffer.size());
-    const auto* lastAligned = prevAligned(sentinel);
-
-    while (unaligned(pan, left, right) && pan < lastAligned)
-        _internals::snippetPan(pan, left, right);
-
-    const auto mmOne = _mm_set_ps1(1.0f);
-    const auto mmPiFour = _mm_set_ps1(piFour<float>);
-    __m128 mmCos;
-    __m128 mmSin;
-    while (pan < lastAligned) {
-        auto mmPan = _mm_load_ps(pan);
-        mmPan = _mm_add_ps(mmOne, mmPan);
-        mmPan = _mm_mul_ps(mmPan, mmPiFour);
-        sincos_ps(mmPan, &mmSin, &mmCos);
-        auto mmLeft = _mm_mul_ps(mmCos, _mm_load_ps(left));
-        auto mmRight = _mm_mul_ps(mmCos, _mm_load_ps(left));
-        _mm_store_ps(left, mmLeft);
-        _mm_store_ps(right, mmRight);
+    const auto size = min(panEnvelope.size(), leftBuffer.size(), rightBuffer.size());
+    auto* sentinel = pan + size;
+    auto* lastVector = pan + (size & ~TypeAlignmentMask);
+
+    const auto mmHalf = _mm_set_ps1(0.5f);
+    while (pan < lastVector) {
+        const auto mmPan = _mm_mul_ps(mmHalf, _mm_loadu_ps(pan));
+        const auto mmLeft = panTableGains(table.data(), _mm_add_ps(mmHalf, mmPan));
+        const auto mmRight = panTableGains(table.data(), _mm_sub_ps(mmHalf, mmPan));
+        _mm_storeu_ps(left, _mm_mul_ps(mmLeft, _mm_loadu_ps(left)));
+        _mm_storeu_ps(right, _mm_mul_ps(mmRight, _mm_loadu_ps(right)));
         incrementAll<TypeAlignment>(pan, left, right);
     }
 
     while (pan < sentinel)
-        _internals::snippetPan(pan, left, right);
+        _internals::snippetPan(table, pan, left, right);
 }
 
 template <>
@@ -783,3 +824,244 @@ void sfz::diff<float, true>(absl::Span<const float> input, absl::Span<float> out
     while (in < sentinel)
         _internals::snippetDiff(in, out);
 }
+
+template <>
+void sfz::interpolateLinear<float, true>(absl::Span<const float> input, absl::Span<const int> indices, absl::Span<const float> leftCoeffs, absl::Span<const float> rightCoeffs, absl::Span<float> output) noexcept
+{
+    ASSERT(indices.size() == leftCoeffs.size());
+    ASSERT(indices.size() == rightCoeffs.size());
+    ASSERT(output.size() >= indices.size());
+
+    auto in = input.data();
+    auto index = indices.data();
+    auto leftCoeff = leftCoeffs.data();
+    auto rightCoeff = rightCoeffs.data();
+    auto out = output.data();
+    const auto size = min(indices.size(), leftCoeffs.size(), rightCoeffs.size(), output.size());
+    const auto sentinel = index + size;
+    const auto lastVector = index + (size & ~TypeAlignmentMask);
+
+    // SSE has no gather, so the loads are scalar but the interpolation is not
+    while (index < lastVector) {
+        auto mmLeft = _mm_setr_ps(in[index[0]], in[index[1]], in[index[2]], in[index[3]]);
+        auto mmRight = _mm_setr_ps(in[index[0] + 1], in[index[1] + 1], in[index[2] + 1], in[index[3] + 1]);
+        mmLeft = _mm_mul_ps(mmLeft, _mm_loadu_ps(leftCoeff));
+        mmRight = _mm_mul_ps(mmRight, _mm_loadu_ps(rightCoeff));
+        _mm_storeu_ps(out, _mm_add_ps(mmLeft, mmRight));
+        incrementAll<TypeAlignment>(index, leftCoeff, rightCoeff, out);
+    }
+
+    while (index < sentinel)
+        _internals::snippetInterpolateLinear(in, index, leftCoeff, rightCoeff, out);
+}
+
+template <>
+void sfz::interpolateLinear<int16_t, true>(absl::Span<const int16_t> input, absl::Span<const int> indices, absl::Span<const float> leftCoeffs, absl::Span<const float> rightCoeffs, absl::Span<float> output) noexcept
+{
+    ASSERT(indices.size() == leftCoeffs.size());
+    ASSERT(indices.size() == rightCoeffs.size());
+    ASSERT(output.size() >= indices.size());
+
+    auto in = input.data();
+    auto index = indices.data();
+    auto leftCoeff = leftCoeffs.data();
+    auto rightCoeff = rightCoeffs.data();
+    auto out = output.data();
+    const auto size = min(indices.size(), leftCoeffs.size(), rightCoeffs.size(), output.size());
+    const auto sentinel = index + size;
+    const auto lastVector = index + (size & ~TypeAlignmentMask);
+
+    // The gathers are scalar, but the conversion and interpolation are not
+    const auto mmScale = _mm_set_ps1(sampleToFloat(int16_t { 1 }));
+    while (index < lastVector) {
+        auto mmLeft = _mm_cvtepi32_ps(_mm_setr_epi32(in[index[0]], in[index[1]], in[index[2]], in[index[3]]));
+        auto mmRight = _mm_cvtepi32_ps(_mm_setr_epi32(in[index[0] + 1], in[index[1] + 1], in[index[2] + 1], in[index[3] + 1]));
+        mmLeft = _mm_mul_ps(_mm_mul_ps(mmLeft, mmScale), _mm_loadu_ps(leftCoeff));
+        mmRight = _mm_mul_ps(_mm_mul_ps(mmRight, mmScale), _mm_loadu_ps(rightCoeff));
+        _mm_storeu_ps(out, _mm_add_ps(mmLeft, mmRight));
+        incrementAll<TypeAlignment>(index, leftCoeff, rightCoeff, out);
+    }
+
+    while (index < sentinel)
+        _internals::snippetInterpolateLinear(in, index, leftCoeff, rightCoeff, out);
+}
+
+namespace {
+/**
+ * @brief Check that the 4 indices of a vector can read the taps from
+ * index - before to index + after without going out of an input.
+ */
+inline bool vectorInRange(const int* index, int before, int after, int size) noexcept
+{
+    for (int k = 0; k < 4; ++k) {
+        if (index[k] < before || index[k] + after >= size)
+            return false;
+    }
+    return true;
+}
+
+inline __m128 hermiteSSE(__m128 x0, __m128 x1, __m128 x2, __m128 x3, __m128 position) noexcept
+{
+    const auto mmHalf = _mm_set_ps1(0.5f);
+    const auto c1 = _mm_mul_ps(mmHalf, _mm_sub_ps(x2, x0));
+    auto c2 = _mm_sub_ps(x0, _mm_mul_ps(_mm_set_ps1(2.5f), x1));
+    c2 = _mm_add_ps(c2, _mm_add_ps(x2, x2));
+    c2 = _mm_sub_ps(c2, _mm_mul_ps(mmHalf, x3));
+    auto c3 = _mm_mul_ps(mmHalf, _mm_sub_ps(x3, x0));
+    c3 = _mm_add_ps(c3, _mm_mul_ps(_mm_set_ps1(1.5f), _mm_sub_ps(x1, x2)));
+    auto result = _mm_add_ps(_mm_mul_ps(c3, position), c2);
+    result = _mm_add_ps(_mm_mul_ps(result, position), c1);
+    return _mm_add_ps(_mm_mul_ps(result, position), x1);
+}
+
+inline float horizontalSum(__m128 x) noexcept
+{
+    const auto shuffled = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+    const auto sums = _mm_add_ps(x, shuffled);
+    return _mm_cvtss_f32(_mm_add_ss(sums, _mm_movehl_ps(shuffled, sums)));
+}
+
+/**
+ * @brief Apply the sinc table row of a position to 8 taps
+ */
+inline float sincSSE(const sfz::SincTable& table, __m128 taps0, __m128 taps1, float position) noexcept
+{
+    int phase;
+    float phaseFraction;
+    sfz::SincTable::findPhase(position, phase, phaseFraction);
+    const float* lower = table.row(phase);
+    const float* upper = table.row(phase + 1);
+    const auto mmFraction = _mm_set_ps1(phaseFraction);
+    auto mmLower = _mm_loadu_ps(lower);
+    auto coeffs0 = _mm_add_ps(mmLower, _mm_mul_ps(mmFraction, _mm_sub_ps(_mm_loadu_ps(upper), mmLower)));
+    mmLower = _mm_loadu_ps(lower + 4);
+    auto coeffs1 = _mm_add_ps(mmLower, _mm_mul_ps(mmFraction, _mm_sub_ps(_mm_loadu_ps(upper + 4), mmLower)));
+    return horizontalSum(_mm_add_ps(_mm_mul_ps(taps0, coeffs0), _mm_mul_ps(taps1, coeffs1)));
+}
+}
+
+template <>
+void sfz::interpolateHermite<float, true>(absl::Span<const float> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept
+{
+    ASSERT(indices.size() == positions.size());
+    ASSERT(output.size() >= indices.size());
+
+    const auto in = input.data();
+    const auto inputSize = static_cast<int>(input.size());
+    auto index = indices.data();
+    auto position = positions.data();
+    auto out = output.data();
+    const auto size = min(indices.size(), positions.size(), output.size());
+    const auto sentinel = index + size;
+    const auto lastVector = index + (size & ~TypeAlignmentMask);
+
+    while (index < lastVector) {
+        if (!vectorInRange(index, 1, 2, inputSize)) {
+            for (unsigned k = 0; k < TypeAlignment; ++k)
+                _internals::snippetInterpolateHermite(input, index, position, out);
+            continue;
+        }
+        const auto x0 = _mm_setr_ps(in[index[0] - 1], in[index[1] - 1], in[index[2] - 1], in[index[3] - 1]);
+        const auto x1 = _mm_setr_ps(in[index[0]], in[index[1]], in[index[2]], in[index[3]]);
+        const auto x2 = _mm_setr_ps(in[index[0] + 1], in[index[1] + 1], in[index[2] + 1], in[index[3] + 1]);
+        const auto x3 = _mm_setr_ps(in[index[0] + 2], in[index[1] + 2], in[index[2] + 2], in[index[3] + 2]);
+        _mm_storeu_ps(out, hermiteSSE(x0, x1, x2, x3, _mm_loadu_ps(position)));
+        incrementAll<TypeAlignment>(index, position, out);
+    }
+
+    while (index < sentinel)
+        _internals::snippetInterpolateHermite(input, index, position, out);
+}
+
+template <>
+void sfz::interpolateHermite<int16_t, true>(absl::Span<const int16_t> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept
+{
+    ASSERT(indices.size() == positions.size());
+    ASSERT(output.size() >= indices.size());
+
+    const auto in = input.data();
+    const auto inputSize = static_cast<int>(input.size());
+    auto index = indices.data();
+    auto position = positions.data();
+    auto out = output.data();
+    const auto size = min(indices.size(), positions.size(), output.size());
+    const auto sentinel = index + size;
+    const auto lastVector = index + (size & ~TypeAlignmentMask);
+
+    const auto mmScale = _mm_set_ps1(sampleToFloat(int16_t { 1 }));
+    const auto gather = [&](int offset) {
+        const auto mmInt = _mm_setr_epi32(in[index[0] + offset], in[index[1] + offset], in[index[2] + offset], in[index[3] + offset]);
+        return _mm_mul_ps(_mm_cvtepi32_ps(mmInt), mmScale);
+    };
+
+    while (index < lastVector) {
+        if (!vectorInRange(index, 1, 2, inputSize)) {
+            for (unsigned k = 0; k < TypeAlignment; ++k)
+                _internals::snippetInterpolateHermite(input, index, position, out);
+            continue;
+        }
+        _mm_storeu_ps(out, hermiteSSE(gather(-1), gather(0), gather(1), gather(2), _mm_loadu_ps(position)));
+        incrementAll<TypeAlignment>(index, position, out);
+    }
+
+    while (index < sentinel)
+        _internals::snippetInterpolateHermite(input, index, position, out);
+}
+
+template <>
+void sfz::interpolateSinc<float, true>(absl::Span<const float> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept
+{
+    ASSERT(indices.size() == positions.size());
+    ASSERT(output.size() >= indices.size());
+
+    const auto& table = SincTable::get();
+    const auto in = input.data();
+    const auto inputSize = static_cast<int>(input.size());
+    auto index = indices.data();
+    auto position = positions.data();
+    auto out = output.data();
+    const auto sentinel = index + min(indices.size(), positions.size(), output.size());
+
+    // The 8 taps of an output sample are contiguous, so they are loaded as
+    // two vectors and the vectorization runs over the taps
+    while (index < sentinel) {
+        const auto i = *index;
+        if (i < SincTable::tapsBefore || i + SincTable::tapsAfter >= inputSize) {
+            _internals::snippetInterpolateSinc(table, input, index, position, out);
+            continue;
+        }
+        const float* taps = in + i - SincTable::tapsBefore;
+        *out = sincSSE(table, _mm_loadu_ps(taps), _mm_loadu_ps(taps + 4), *position);
+        incrementAll(index, position, out);
+    }
+}
+
+template <>
+void sfz::interpolateSinc<int16_t, true>(absl::Span<const int16_t> input, absl::Span<const int> indices, absl::Span<const float> positions, absl::Span<float> output) noexcept
+{
+    ASSERT(indices.size() == positions.size());
+    ASSERT(output.size() >= indices.size());
+
+    const auto& table = SincTable::get();
+    const auto in = input.data();
+    const auto inputSize = static_cast<int>(input.size());
+    auto index = indices.data();
+    auto position = positions.data();
+    auto out = output.data();
+    const auto sentinel = index + min(indices.size(), positions.size(), output.size());
+
+    const auto mmScale = _mm_set_ps1(sampleToFloat(int16_t { 1 }));
+    while (index < sentinel) {
+        const auto i = *index;
+        if (i < SincTable::tapsBefore || i + SincTable::tapsAfter >= inputSize) {
+            _internals::snippetInterpolateSinc(table, input, index, position, out);
+            continue;
+        }
+        // Sign-extend the 8 taps by placing them in the upper halves of 32-bit lanes
+        const auto mmInt = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i - SincTable::tapsBefore));
+        const auto taps0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(mmInt, mmInt), 16));
+        const auto taps1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(mmInt, mmInt), 16));
+        *out = sincSSE(table, _mm_mul_ps(taps0, mmScale), _mm_mul_ps(taps1, mmScale), *position);
+        incrementAll(index, position, out);
+    }
+}
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "AudioBuffer.h"
+#include "AudioSpan.h"
+#include "MathHelpers.h"
+#include <cstdint>
+#include <memory>
+
+namespace sfz {
+/**
+ * @brief Storage format of sample frames
+ */
+enum class SampleFormat {
+    Float,
+    Int16
+};
+
+/**
+ * @brief A view on sample frames, in one of the storage formats.
+ */
+class SampleSpan {
+public:
+    SampleSpan() = default;
+    SampleSpan(AudioSpan<const float> frames)
+    : format(SampleFormat::Float), numFrames(frames.getNumFrames())
+    , numChannels(frames.getNumChannels()), floatFrames(frames) {}
+    SampleSpan(AudioSpan<const int16_t> frames)
+    : format(SampleFormat::Int16), numFrames(frames.getNumFrames())
+    , numChannels(frames.getNumChannels()), int16Frames(frames) {}
+
+    SampleFormat getFormat() const noexcept { return format; }
+    size_t getNumFrames() const noexcept { return numFrames; }
+    size_t getNumChannels() const noexcept { return numChannels; }
+
+    /**
+     * @brief Call a function with the AudioSpan of the frames, which is
+     * either an AudioSpan<const float> or an AudioSpan<const int16_t>.
+     *
+     * @param function
+     */
+    template <class Function>
+    void visit(Function&& function) const
+    {
+        if (format == SampleFormat::Int16)
+            function(int16Frames);
+        else
+            function(floatFrames);
+    }
+private:
+    SampleFormat format { SampleFormat::Float };
+    size_t numFrames { 0 };
+    size_t numChannels { 0 };
+    AudioSpan<const float> floatFrames {};
+    AudioSpan<const int16_t> int16Frames {};
+};
+
+/**
+ * @brief Sample frames stored either as float, or as 16-bit integers for the
+ * files that hold 16-bit PCM data. The latter halves the memory footprint of
+ * the data, and is converted to float by the readers.
+ */
+class SampleBuffer {
+public:
+    SampleBuffer() = default;
+    SampleBuffer(AudioBuffer<float>&& frames)
+    : format(SampleFormat::Float), floatFrames(std::move(frames)) {}
+    SampleBuffer(AudioBuffer<int16_t>&& frames)
+    : format(SampleFormat::Int16), int16Frames(std::move(frames)) {}
+    SampleBuffer(SampleFormat format, size_t numChannels, size_t numFrames)
+    : format(format)
+    {
+        if (format == SampleFormat::Int16)
+            int16Frames = AudioBuffer<int16_t>(numChannels, numFrames);
+        else
+            floatFrames = AudioBuffer<float>(numChannels, numFrames);
+    }
+
+    SampleFormat getFormat() const noexcept { return format; }
+    size_t getNumFrames() const noexcept
+    {
+        return format == SampleFormat::Int16 ? int16Frames.getNumFrames() : floatFrames.getNumFrames();
+    }
+    size_t getNumChannels() const noexcept
+    {
+        return format == SampleFormat::Int16 ? int16Frames.getNumChannels() : floatFrames.getNumChannels();
+    }
+    size_t getSampleSize() const noexcept
+    {
+        return format == SampleFormat::Int16 ? sizeof(int16_t) : sizeof(float);
+    }
+    /**
+     * @brief Get the size of the stored frames, in bytes
+     */
+    size_t getNumBytes() const noexcept
+    {
+        return getNumChannels() * getNumFrames() * getSampleSize();
+    }
+
+    /**
+     * @brief Get the raw bytes of a channel, in the storage format
+     */
+    const uint8_t* channelBytes(size_t channelIndex) const noexcept
+    {
+        if (format == SampleFormat::Int16)
+            return reinterpret_cast<const uint8_t*>(int16Frames.channelReader(channelIndex));
+        return reinterpret_cast<const uint8_t*>(floatFrames.channelReader(channelIndex));
+    }
+    uint8_t* channelBytes(size_t channelIndex) noexcept
+    {
+        if (format == SampleFormat::Int16)
+            return reinterpret_cast<uint8_t*>(int16Frames.channelWriter(channelIndex));
+        return reinterpret_cast<uint8_t*>(floatFrames.channelWriter(channelIndex));
+    }
+
+    SampleSpan getSpan() noexcept
+    {
+        if (format == SampleFormat::Int16)
+            return AudioSpan<const int16_t>(int16Frames);
+        return AudioSpan<const float>(floatFrames);
+    }
+private:
+    SampleFormat format { SampleFormat::Float };
+    AudioBuffer<float> floatFrames {};
+    AudioBuffer<int16_t> int16Frames {};
+};
+
+using SampleBufferPtr = std::shared_ptr<SampleBuffer>;
+}
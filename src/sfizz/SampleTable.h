@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "Debug.h"
+#include "LeakDetector.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include <cstdint>
+#include <deque>
+#include <string>
+
+namespace sfz {
+using SampleId = uint32_t;
+
+/**
+ * @brief Interned sample paths. Each distinct path is stored once and gets an
+ * integer identifier, which the regions, the voices and the file pool use in
+ * place of the path. Instruments with many regions on the same samples then
+ * hold a single copy of each path.
+ *
+ * The paths are never moved once interned, even when the table itself is
+ * moved, so views on them stay valid until the table is cleared or destroyed.
+ * Interning is not thread-safe and happens when loading an instrument.
+ */
+class SampleTable {
+public:
+    SampleTable() = default;
+    SampleTable(SampleTable&&) = default;
+    SampleTable& operator=(SampleTable&&) = default;
+    SampleTable(const SampleTable&) = delete;
+    SampleTable& operator=(const SampleTable&) = delete;
+
+    /**
+     * @brief Get the identifier of a path, adding the path to the table if needed
+     *
+     * @param path
+     * @return SampleId
+     */
+    SampleId intern(absl::string_view path)
+    {
+        const auto existing = ids.find(path);
+        if (existing != ids.end())
+            return existing->second;
+
+        const auto id = static_cast<SampleId>(paths.size());
+        paths.emplace_back(path);
+        ids.emplace(paths.back(), id);
+        return id;
+    }
+    /**
+     * @brief Get the path of an identifier
+     *
+     * @param id
+     * @return const std::string&
+     */
+    const std::string& getPath(SampleId id) const noexcept
+    {
+        ASSERT(id < paths.size());
+        return paths[id];
+    }
+    size_t size() const noexcept { return paths.size(); }
+    void clear() noexcept
+    {
+        ids.clear();
+        paths.clear();
+    }
+    /**
+     * @brief Get the memory held by the table, in bytes
+     *
+     * @return size_t
+     */
+    size_t getMemoryUsage() const noexcept
+    {
+        size_t bytes = sizeof(*this) + ids.capacity() * (sizeof(decltype(ids)::value_type) + 1);
+        for (const auto& path : paths)
+            bytes += sizeof(path) + (path.capacity() > std::string().capacity() ? path.capacity() + 1 : 0);
+        return bytes;
+    }
+private:
+    std::deque<std::string> paths;
+    absl::flat_hash_map<absl::string_view, SampleId> ids;
+    LEAK_DETECTOR(SampleTable);
+};
+}
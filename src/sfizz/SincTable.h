@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#pragma once
+#include "MathHelpers.h"
+#include <array>
+#include <cmath>
+
+namespace sfz {
+/**
+ * @brief Polyphase table of a Blackman-windowed sinc, to interpolate a
+ * sample at a fractional position from the 8 samples around it, from the
+ * index - 3 to the index + 4.
+ *
+ * Each of the numPhases + 1 rows holds the taps for one fractional position
+ * between 0 and 1, normalized to a unity gain. Positions in between are read
+ * by interpolating linearly between the two nearest rows.
+ *
+ * The table is built on the first call to get(), which should not happen on
+ * the audio thread.
+ */
+class SincTable {
+public:
+    static constexpr int numTaps { 8 };
+    static constexpr int tapsBefore { 3 };
+    static constexpr int tapsAfter { numTaps - tapsBefore - 1 };
+    static constexpr int numPhases { 128 };
+
+    static const SincTable& get() noexcept
+    {
+        static const SincTable table;
+        return table;
+    }
+
+    /**
+     * @brief Get the taps of a phase, from 0 to numPhases included
+     */
+    const float* row(int phase) const noexcept { return &coefficients[static_cast<size_t>(phase) * numTaps]; }
+
+    /**
+     * @brief Find the two rows around a fractional position
+     *
+     * @param position between 0 and 1
+     * @param phase the lower row
+     * @param phaseFraction the position between the lower row and the next one
+     */
+    static void findPhase(float position, int& phase, float& phaseFraction) noexcept
+    {
+        const float scaled = position * static_cast<float>(numPhases);
+        phase = clamp(static_cast<int>(scaled), 0, numPhases - 1);
+        phaseFraction = scaled - static_cast<float>(phase);
+    }
+
+    /**
+     * @brief Interpolate at a fractional position
+     *
+     * @param position between 0 and 1
+     * @param sampleAt a function returning the sample at an offset between
+     *                 -tapsBefore and tapsAfter, as a float
+     */
+    template <class Function>
+    float interpolate(float position, Function&& sampleAt) const noexcept
+    {
+        int phase;
+        float phaseFraction;
+        findPhase(position, phase, phaseFraction);
+        const float* lower = row(phase);
+        const float* upper = row(phase + 1);
+        float result { 0.0f };
+        for (int k = 0; k < numTaps; ++k)
+            result += sampleAt(k - tapsBefore) * (lower[k] + phaseFraction * (upper[k] - lower[k]));
+        return result;
+    }
+
+private:
+    SincTable() noexcept
+    {
+        constexpr double halfWidth { tapsAfter };
+        for (int phase = 0; phase <= numPhases; ++phase) {
+            const double position = static_cast<double>(phase) / numPhases;
+            std::array<double, numTaps> taps;
+            double sum { 0.0 };
+            for (int k = 0; k < numTaps; ++k) {
+                const double x = static_cast<double>(k - tapsBefore) - position;
+                const double sinc = x == 0.0 ? 1.0 : std::sin(pi<double> * x) / (pi<double> * x);
+                const double window = std::abs(x) >= halfWidth ? 0.0
+                    : 0.42 + 0.5 * std::cos(pi<double> * x / halfWidth) + 0.08 * std::cos(twoPi<double> * x / halfWidth);
+                taps[k] = sinc * window;
+                sum += taps[k];
+            }
+            for (int k = 0; k < numTaps; ++k)
+                coefficients[static_cast<size_t>(phase) * numTaps + k] = static_cast<float>(taps[k] / sum);
+        }
+    }
+
+    std::array<float, (numPhases + 1) * numTaps> coefficients;
+};
+}
@@ -16,6 +16,7 @@
  */
 
 #pragma once
+#include "absl/strings/ascii.h"
 #include "absl/strings/string_view.h"
 
 /**
@@ -25,14 +26,12 @@
  */
 inline void trimInPlace(absl::string_view& s)
 {
-    const auto leftPosition = s.find_first_not_of(" \r\t\n\f\v");
-    if (leftPosition != s.npos) {
-        s.remove_prefix(leftPosition);
-        const auto rightPosition = s.find_last_not_of(" \r\t\n\f\v");
-        s.remove_suffix(s.size() - rightPosition - 1);
-    } else {
-        s.remove_suffix(s.size());
-    }
+    // Character loops rather than find_first_not_of, which builds a lookup
+    // table on each call
+    while (!s.empty() && absl::ascii_isspace(s.front()))
+        s.remove_prefix(1);
+    while (!s.empty() && absl::ascii_isspace(s.back()))
+        s.remove_suffix(1);
 }
 
 /**
@@ -9,9 +9,12 @@
 #include "Config.h"
 #include "Debug.h"
 #include "MidiState.h"
+#include "PanTable.h"
 #include "ScopedFTZ.h"
+#include "SincTable.h"
 #include "StringViewHelpers.h"
 #include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_replace.h"
 #include <algorithm>
 #include <chrono>
@@ -21,11 +24,16 @@ using namespace std::literals;
 
 sfz::Synth::Synth()
 {
+    // Build the lookup tables here rather than on the audio thread
+    PanTable::get();
+    SincTable::get();
     resetVoices(this->numVoices);
 }
 
 sfz::Synth::Synth(int numVoices)
 {
+    PanTable::get();
+    SincTable::get();
     resetVoices(numVoices);
 }
 
@@ -47,26 +55,30 @@ void sfz::Synth::callback(absl::string_view header, const std::vector<Opcode>& m
     switch (hash(header)) {
     case hash("global"):
         globalOpcodes = members;
+        regionTemplate.reset();
         handleGlobalOpcodes(members);
         break;
     case hash("control"):
         defaultPath = ""; // Always reset on a new control header
+        regionTemplate.reset();
         handleControlOpcodes(members);
         break;
     case hash("master"):
         masterOpcodes = members;
-        numMasters++;
+        regionTemplate.reset();
+        parsedInstrument.numMasters++;
         break;
     case hash("group"):
         groupOpcodes = members;
-        numGroups++;
+        regionTemplate.reset();
+        parsedInstrument.numGroups++;
         break;
     case hash("region"):
         buildRegion(members);
         break;
     case hash("curve"):
         // TODO: implement curves
-        numCurves++;
+        parsedInstrument.numCurves++;
         break;
     case hash("effect"):
         // TODO: implement effects
@@ -78,59 +90,67 @@ void sfz::Synth::callback(absl::string_view header, const std::vector<Opcode>& m
 
 void sfz::Synth::buildRegion(const std::vector<Opcode>& regionOpcodes)
 {
-    auto lastRegion = std::make_unique<Region>(midiState, defaultPath);
-
-    auto parseOpcodes = [&](const auto& opcodes) {
+    auto& unknownOpcodes = parsedInstrument.unknownOpcodes;
+    auto parseOpcodes = [&](Region& region, const auto& opcodes) {
         for (auto& opcode : opcodes) {
             const auto unknown = absl::c_find_if(unknownOpcodes, [&](absl::string_view sv) { return sv.compare(opcode.opcode) == 0; });
             if (unknown != unknownOpcodes.end()) {
                 continue;
             }
 
-            if (!lastRegion->parseOpcode(opcode))
+            if (!region.parseOpcode(opcode))
                 unknownOpcodes.emplace_back(opcode.opcode);
         }
     };
 
-    parseOpcodes(globalOpcodes);
-    parseOpcodes(masterOpcodes);
-    parseOpcodes(groupOpcodes);
-    parseOpcodes(regionOpcodes);
+    if (!regionTemplate) {
+        regionTemplate = std::make_unique<Region>(midiState, *parsedSampleTable, defaultPath);
+        parseOpcodes(*regionTemplate, globalOpcodes);
+        parseOpcodes(*regionTemplate, masterOpcodes);
+        parseOpcodes(*regionTemplate, groupOpcodes);
+    }
+
+    auto lastRegion = std::make_unique<Region>(*regionTemplate);
+    parseOpcodes(*lastRegion, regionOpcodes);
 
     if (octaveOffset != 0 || noteOffset != 0)
         lastRegion->offsetAllKeys(octaveOffset * 12 + noteOffset);
 
-    regions.push_back(std::move(lastRegion));
+    parsedInstrument.regions.push_back(std::move(lastRegion));
 }
 
 void sfz::Synth::clear()
 {
-    AtomicDisabler callbackDisabler { canEnterCallback };
-    while (inCallback) {
-        std::this_thread::sleep_for(1ms);
-    }
-
     for (auto &voice: voices)
         voice->reset();
-    for (auto& list: noteActivationLists)
+    reclaimFreeVoices();
+    regionLists.offByVoiceLists.clear();
+    for (auto& list: regionLists.ccModulationLists)
+        list.clear();
+    regionLists.regionVoiceLists.clear();
+    for (auto& list: regionLists.noteActivationLists)
         list.clear();
-    for (auto& list: ccActivationLists)
+    for (auto& list: regionLists.ccActivationLists)
         list.clear();
+    regionLists.bendConditionRegions.clear();
+    for (auto& index: regionLists.noteActivationIndices)
+        index.clear();
+    noteOnCounts.fill(0);
+    // The preloaded files are kept for the next instrument, but the promises
+    // refer to the sample names of the regions
+    resources.filePool.emptyFileLoadingQueues();
+    resources.filePool.waitForBackgroundLoading();
     regions.clear();
-    resources.filePool.clear();
     resources.logger.clear();
     numGroups = 0;
     numMasters = 0;
     numCurves = 0;
     fileTicket = -1;
     defaultSwitch = absl::nullopt;
-    defaultPath = "";
     midiState.reset();
     ccNames.clear();
-    globalOpcodes.clear();
-    masterOpcodes.clear();
-    groupOpcodes.clear();
     unknownOpcodes.clear();
+    resetParsingState();
     modificationTime = fs::file_time_type::min();
 }
 
@@ -139,7 +159,7 @@ void sfz::Synth::handleGlobalOpcodes(const std::vector<Opcode>& members)
     for (auto& member : members) {
         switch (hash(member.opcode)) {
         case hash("sw_default"):
-            setValueFromOpcode(member, defaultSwitch, Default::keyRange);
+            setValueFromOpcode(member, parsedInstrument.defaultSwitch, Default::keyRange);
             break;
         case hash("volume"):
             // FIXME : Probably best not to mess with this and let the host control the volume
@@ -158,14 +178,14 @@ void sfz::Synth::handleControlOpcodes(const std::vector<Opcode>& members)
         case hash("set_cc"):
             if (member.parameter && Default::ccNumberRange.containsWithEnd(*member.parameter)) {
                 const auto ccValue = readOpcode(member.value, Default::ccValueRange).value_or(0);
-                midiState.ccEvent(*member.parameter, ccValue);
+                parsedInstrument.ccValues[*member.parameter] = ccValue;
             }
             break;
         case hash("Label_cc"):
             [[fallthrough]];
         case hash("label_cc"):
             if (member.parameter && Default::ccNumberRange.containsWithEnd(*member.parameter))
-                ccNames.emplace_back(*member.parameter, member.value);
+                parsedInstrument.ccNames.emplace_back(*member.parameter, member.value);
             break;
         case hash("Default_path"):
             [[fallthrough]];
@@ -204,142 +224,391 @@ void addEndpointsToVelocityCurve(sfz::Region& region)
     }
 }
 
-bool sfz::Synth::loadSfzFile(const fs::path& file)
+void sfz::Synth::activateRegion(Region& region, const absl::optional<FileInformation>& fileInformation, RegionLists& lists) noexcept
 {
-    AtomicDisabler callbackDisabler { canEnterCallback };
-    while (inCallback) {
-        std::this_thread::sleep_for(1ms);
-    }
+    if (fileInformation) {
+        region.sampleEnd = std::min(region.sampleEnd, fileInformation->end);
+        if (region.loopRange.getEnd() == Default::loopRange.getEnd())
+            region.loopRange.setEnd(region.sampleEnd);
 
-    clear();
-    auto parserReturned = sfz::Parser::loadSfzFile(file);
-    if (!parserReturned)
-        return false;
+        if (fileInformation->loopBegin != Default::loopRange.getStart() &&
+            fileInformation->loopEnd != Default::loopRange.getEnd()) {
+            if (region.loopRange.getStart() == Default::loopRange.getStart())
+                region.loopRange.setStart(fileInformation->loopBegin);
 
-    if (regions.empty())
-        return false;
+            if (region.loopRange.getEnd() == Default::loopRange.getEnd())
+                region.loopRange.setEnd(fileInformation->loopEnd);
 
-    resources.filePool.setRootDirectory(this->originalDirectory);
-    resources.logger.setPrefix(file.filename().string());
+            if (!region.loopMode)
+                region.loopMode = SfzLoopMode::loop_continuous;
+        }
 
-    auto currentRegion = regions.begin();
-    auto lastRegion = regions.rbegin();
-    auto removeCurrentRegion = [&currentRegion, &lastRegion]() {
-        if (currentRegion->get() == nullptr)
-            return;
+        if (fileInformation->numChannels == 2)
+            region.isStereo = true;
+    }
 
-        DBG("Removing the region with sample " << currentRegion->get()->sample);
-        std::iter_swap(currentRegion, lastRegion);
-        ++lastRegion;
-    };
+    if (region.offBy)
+        lists.offByVoiceLists.try_emplace(*region.offBy);
 
-    while (currentRegion < lastRegion.base()) {
-        auto region = currentRegion->get();
+    lists.regionVoiceLists.try_emplace(&region);
 
-        if (!region->isGenerator()) {
-            if (!resources.filePool.checkSample(region->sample)) {
-                removeCurrentRegion();
-                continue;
-            }
+    // Defaults; a new region is switched on for the CCs it has no condition
+    // on, and starts with the CC values of the instrument and a centered
+    // pitch wheel, which is the MIDI state once the instrument is swapped in
+    for (const auto& condition : region.ccConditions)
+        region.registerCC(condition.first, parsedInstrument.ccValues[condition.first]);
 
-            const auto fileInformation = resources.filePool.getFileInformation(region->sample);
-            if (!fileInformation) {
-                removeCurrentRegion();
-                continue;
-            }
+    if (parsedInstrument.defaultSwitch) {
+        region.registerNoteOn(*parsedInstrument.defaultSwitch, 127, 1.0);
+        region.registerNoteOff(*parsedInstrument.defaultSwitch, 0, 1.0);
+    }
 
-            region->sampleEnd = std::min(region->sampleEnd, fileInformation->end);
-            if (region->loopRange.getEnd() == Default::loopRange.getEnd())
-                region->loopRange.setEnd(region->sampleEnd);
+    addEndpointsToVelocityCurve(region);
+    region.registerPitchWheel(0);
+    if (region.bendRange != Default::bendRange)
+        lists.bendConditionRegions.push_back(&region);
+    region.registerAftertouch(0);
+    region.registerTempo(2.0f);
+}
 
-            if (fileInformation->loopBegin != Default::loopRange.getStart() &&
-                fileInformation->loopEnd != Default::loopRange.getEnd()) {
-                if (region->loopRange.getStart() == Default::loopRange.getStart())
-                    region->loopRange.setStart(fileInformation->loopBegin);
+void sfz::Synth::addToActivationLists(const ActivationLists& activationLists, absl::Span<Region* const> builtRegions,
+    const std::vector<bool>& activated, RegionLists& lists)
+{
+    for (int note = 0; note < 128; note++) {
+        for (auto index : activationLists.notes[note]) {
+            if (activated[index])
+                lists.noteActivationLists[note].push_back(builtRegions[index]);
+        }
+    }
 
-                if (region->loopRange.getEnd() == Default::loopRange.getEnd())
-                    region->loopRange.setEnd(fileInformation->loopEnd);
+    for (int cc = 0; cc < config::numCCs; cc++) {
+        for (auto index : activationLists.ccTriggers[cc]) {
+            if (activated[index])
+                lists.ccActivationLists[cc].push_back(builtRegions[index]);
+        }
 
-                if (!region->loopMode)
-                    region->loopMode = SfzLoopMode::loop_continuous;
-            }
+        for (auto index : activationLists.ccModulations[cc]) {
+            if (activated[index])
+                lists.ccModulationLists[cc].push_back(&lists.regionVoiceLists[builtRegions[index]]);
+        }
+    }
+}
 
-            if (fileInformation->numChannels == 2)
-                region->isStereo = true;
+void sfz::Synth::resetParsingState()
+{
+    // The parsed regions refer to the parsed sample table
+    regionTemplate.reset();
+    parsedInstrument = CompiledInstrument {};
+    parsedSampleTable = std::make_unique<SampleTable>();
+    defaultPath = "";
+    globalOpcodes.clear();
+    masterOpcodes.clear();
+    groupOpcodes.clear();
+}
 
-            // TODO: adjust with LFO targets
-            const auto maxOffset { region->offset + region->offsetRandom };
-            if (!resources.filePool.preloadFile(region->sample, maxOffset))
-                removeCurrentRegion();
+bool sfz::Synth::loadInstrument(const fs::path& file)
+{
+    std::error_code ec;
+    const auto cacheKey = fs::absolute(file, ec);
+    if (instrumentCache && !ec) {
+        if (instrumentCache->load(cacheKey, parsedInstrument, midiState, *parsedSampleTable)) {
+            restoreSfzFile(file, std::move(parsedInstrument.includedFiles), parsedInstrument.defines);
+            noteOffset = parsedInstrument.noteOffset;
+            octaveOffset = parsedInstrument.octaveOffset;
+            return true;
         }
 
-        for (auto note = 0; note < 128; note++) {
-            if (region->keyRange.containsWithEnd(note) ||
-                (region->hasKeyswitches() && region->keyswitchRange.containsWithEnd(note)))
-                noteActivationLists[note].push_back(region);
+        // Drop what could be read of the entry before parsing the file
+        parsedInstrument = CompiledInstrument {};
+        parsedSampleTable->clear();
+    }
+
+    if (!sfz::Parser::loadSfzFile(file))
+        return false;
+
+    auto& instrument = parsedInstrument;
+    instrument.activationLists.build(instrument.regions);
+    if (!instrumentCache || instrument.regions.empty() || ec)
+        return true;
+
+    instrument.includedFiles = getIncludedFiles();
+    instrument.defines = getDefines();
+    instrument.noteOffset = noteOffset;
+    instrument.octaveOffset = octaveOffset;
+    instrumentCache->store(cacheKey, instrument, *parsedSampleTable);
+    return true;
+}
+
+bool sfz::Synth::loadSfzFile(const fs::path& file)
+{
+    // The new instrument is parsed, preloaded and activated aside while the
+    // current one keeps playing; the callbacks are only disabled to swap them.
+    // The samples of the current instrument that are still used keep their
+    // preloaded data.
+    const auto previousDirectory = originalDirectory;
+    resetParsingState();
+    if (!loadInstrument(file) || parsedInstrument.regions.empty()) {
+        AtomicDisabler callbackDisabler { canEnterCallback };
+        while (inCallback) {
+            std::this_thread::sleep_for(1ms);
         }
 
-        for (auto cc = 0; cc < config::numCCs; cc++) {
-            if (region->ccTriggers.contains(cc) || region->ccConditions.contains(cc))
-                ccActivationLists[cc].push_back(region);
+        clear();
+        resources.filePool.clear();
+        return false;
+    }
+
+    // Resolve the sample paths once per sample and gather the distinct files to
+    // preload, with the largest offset required by the regions using each of them
+    absl::flat_hash_map<SampleId, size_t> fileIndices;
+    std::vector<FilePool::PreloadRequest> preloadRequests;
+    absl::flat_hash_map<SampleId, absl::optional<SampleId>> resolvedSamples;
+    for (auto& region : parsedInstrument.regions) {
+        if (region->isGenerator())
+            continue;
+
+        auto resolved = resolvedSamples.find(region->sampleId);
+        if (resolved == resolvedSamples.end()) {
+            std::string path { region->getSample() };
+            absl::optional<SampleId> resolvedId;
+            if (resources.filePool.checkSample(path, originalDirectory))
+                resolvedId = parsedSampleTable->intern(path);
+            resolved = resolvedSamples.emplace(region->sampleId, resolvedId).first;
         }
 
-        // Defaults
-        for (int ccIndex = 0; ccIndex < config::numCCs; ccIndex++) {
-            region->registerCC(ccIndex, midiState.getCCValue(ccIndex));
+        if (!resolved->second)
+            continue;
+
+        region->sampleId = *resolved->second;
+        // TODO: adjust with LFO targets
+        const auto maxOffset { region->offset + region->offsetRandom };
+        const auto inserted = fileIndices.try_emplace(region->sampleId, preloadRequests.size());
+        if (inserted.second)
+            preloadRequests.push_back({ region->sampleId, maxOffset });
+        else
+            preloadRequests[inserted.first->second].maxOffset = max(preloadRequests[inserted.first->second].maxOffset, maxOffset);
+    }
+
+    // The preloaded files of the current instrument can only be kept if the
+    // root directory did not change
+    const bool sameDirectory = originalDirectory == previousDirectory;
+    auto filesInformation = sameDirectory ?
+        resources.filePool.findRetainablePreloads(preloadRequests, *parsedSampleTable, originalDirectory) :
+        std::vector<absl::optional<FileInformation>>(preloadRequests.size());
+    std::vector<FilePool::PreloadRequest> retainedRequests;
+    std::vector<FilePool::PreloadRequest> missingRequests;
+    for (size_t index = 0; index < preloadRequests.size(); ++index) {
+        if (filesInformation[index])
+            retainedRequests.push_back(preloadRequests[index]);
+        else
+            missingRequests.push_back(preloadRequests[index]);
+    }
+
+    auto missingFiles = resources.filePool.readPreloadedFiles(missingRequests, *parsedSampleTable, originalDirectory);
+    for (size_t index = 0; index < missingRequests.size(); ++index) {
+        if (missingFiles[index])
+            filesInformation[fileIndices[missingRequests[index].sample]] = missingFiles[index]->information;
+    }
+
+    // Activate the regions whose files could be preloaded, by their index in
+    // the activation lists, before removing the others
+    RegionLists lists;
+    const auto numRegions = parsedInstrument.regions.size();
+    std::vector<Region*> builtRegions (numRegions);
+    std::vector<bool> activated (numRegions, false);
+    for (size_t index = 0; index < numRegions; ++index) {
+        auto& region = *parsedInstrument.regions[index];
+        builtRegions[index] = &region;
+        if (region.isGenerator()) {
+            activateRegion(region, {}, lists);
+            activated[index] = true;
+            continue;
         }
 
-        if (defaultSwitch) {
-            region->registerNoteOn(*defaultSwitch, 127, 1.0);
-            region->registerNoteOff(*defaultSwitch, 0, 1.0);
+        const auto fileIndex = fileIndices.find(region.sampleId);
+        if (fileIndex != fileIndices.end() && filesInformation[fileIndex->second]) {
+            activateRegion(region, filesInformation[fileIndex->second], lists);
+            activated[index] = true;
+        }
+    }
+    addToActivationLists(parsedInstrument.activationLists, builtRegions, activated, lists);
+
+    auto& newRegions = parsedInstrument.regions;
+    const auto removedRegions = std::remove_if(newRegions.begin(), newRegions.end(), [&](const auto& region) {
+        if (region->isGenerator())
+            return false;
+
+        const auto fileIndex = fileIndices.find(region->sampleId);
+        if (fileIndex != fileIndices.end() && filesInformation[fileIndex->second])
+            return false;
+
+        DBG("Removing the region with sample " << region->getSample());
+        return true;
+    });
+    newRegions.erase(removedRegions, newRegions.end());
+    DBG("Removing " << (numRegions - newRegions.size()) << " out of " << numRegions << " regions");
+    buildNoteActivationIndices(lists);
+
+    std::vector<absl::optional<FileInformation>> retainedInformation;
+    {
+        AtomicDisabler callbackDisabler { canEnterCallback };
+        while (inCallback) {
+            std::this_thread::sleep_for(1ms);
         }
 
-        addEndpointsToVelocityCurve(*region);
-        region->registerPitchWheel(0);
-        region->registerAftertouch(0);
-        region->registerTempo(2.0f);
+        for (auto& voice : voices)
+            voice->reset();
+        reclaimFreeVoices();
+        noteOnCounts.fill(0);
+        // The promises refer to the sample names of the current regions
+        resources.filePool.emptyFileLoadingQueues();
+        resources.filePool.waitForBackgroundLoading();
+
+        // The current instrument is swapped out, to be released once the
+        // callbacks are enabled again
+        std::swap(regionLists, lists);
+        std::swap(regions, parsedInstrument.regions);
+        std::swap(resources.sampleTable, parsedSampleTable);
+        std::swap(ccNames, parsedInstrument.ccNames);
+        std::swap(unknownOpcodes, parsedInstrument.unknownOpcodes);
+        defaultSwitch = parsedInstrument.defaultSwitch;
+        numGroups = parsedInstrument.numGroups;
+        numMasters = parsedInstrument.numMasters;
+        numCurves = parsedInstrument.numCurves;
+        fileTicket = -1;
+        midiState.reset();
+        for (int cc = 0; cc < config::numCCs; cc++)
+            midiState.ccEvent(cc, parsedInstrument.ccValues[cc]);
+
+        resources.logger.clear();
+        resources.logger.setPrefix(file.filename().string());
+        resources.filePool.setSampleTable(*resources.sampleTable);
+        if (!sameDirectory)
+            resources.filePool.clear();
+        resources.filePool.setRootDirectory(originalDirectory);
+        retainedInformation = resources.filePool.retainPreloadedFiles(retainedRequests, false);
+        resources.filePool.addPreloadedFiles(missingRequests, std::move(missingFiles));
+    }
+
+    resetParsingState();
+
+    // The preloads found earlier may have been evicted by the memory budget
+    // since, in which case their files are read again
+    std::vector<FilePool::PreloadRequest> evictedRequests;
+    for (size_t index = 0; index < retainedRequests.size(); ++index) {
+        if (!retainedInformation[index])
+            evictedRequests.push_back(retainedRequests[index]);
+    }
+
+    if (!evictedRequests.empty()) {
+        auto evictedFiles = resources.filePool.readPreloadedFiles(evictedRequests);
+        AtomicDisabler callbackDisabler { canEnterCallback };
+        while (inCallback) {
+            std::this_thread::sleep_for(1ms);
+        }
 
-        ++currentRegion;
+        resources.filePool.addPreloadedFiles(evictedRequests, std::move(evictedFiles));
     }
-    const auto remainingRegions = std::distance(regions.begin(), lastRegion.base());
-    DBG("Removing " << (regions.size() - remainingRegions) << " out of " << regions.size() << " regions");
-    regions.resize(remainingRegions);
+
     modificationTime = checkModificationTime();
+    return true;
+}
 
-    return parserReturned;
+void sfz::Synth::buildNoteActivationIndices(RegionLists& lists)
+{
+    for (int note = 0; note < 128; ++note)
+        lists.noteActivationIndices[note].build(lists.noteActivationLists[note]);
 }
 
 sfz::Voice* sfz::Synth::findFreeVoice() noexcept
 {
-    auto freeVoice = absl::c_find_if(voices, [](const auto& voice) { return voice->isFree(); });
-    if (freeVoice != voices.end())
-        return freeVoice->get();
-
-    // Find voices that can be stolen
-    voiceViewArray.clear();
-    for (auto& voice : voices)
-        if (voice->canBeStolen())
-            voiceViewArray.push_back(voice.get());
-    absl::c_sort(voices, [](const auto& lhs, const auto& rhs) { return lhs->getSourcePosition() > rhs->getSourcePosition(); });
+    if (!freeVoices.empty()) {
+        auto voice = freeVoices.back();
+        freeVoices.pop_back();
+        return voice;
+    }
 
-    for (auto* voice : voiceViewArray) {
-        if (voice->getMeanSquaredAverage() < config::voiceStealingThreshold) {
-            voice->reset();
-            return voice;
-        }
+    // Steal the voice releasing for the longest time that is quiet enough
+    for (auto& voice : releasingVoices) {
+        if (voice.getMeanSquaredAverage() >= config::voiceStealingThreshold)
+            continue;
+
+        voice.reset();
+        voice.getTriggerListNode().unlink();
+        voice.getOffByListNode().unlink();
+        voice.getRegionListNode().unlink();
+        voice.getActiveListNode().unlink();
+        voice.getReleasingListNode().unlink();
+        return &voice;
     }
 
     return {};
 }
 
-int sfz::Synth::getNumActiveVoices() const noexcept
+void sfz::Synth::startVoice(Region* region, int delay, int number, uint8_t value, Voice::TriggerType triggerType) noexcept
+{
+    auto voice = findFreeVoice();
+    if (voice == nullptr)
+        return;
+
+    voice->startVoice(region, delay * renderFactor(), number, value, triggerType);
+    // The voice may not start, e.g. if its file is missing
+    if (voice->isFree()) {
+        freeVoices.push_back(voice);
+        return;
+    }
+
+    activeVoices.pushBack(voice->getActiveListNode());
+    if (number >= 0 && number < static_cast<int>(noteVoiceLists.size()))
+        noteVoiceLists[number].pushBack(voice->getTriggerListNode());
+
+    auto regionList = regionLists.regionVoiceLists.find(region);
+    if (regionList != regionLists.regionVoiceLists.end())
+        regionList->second.pushBack(voice->getRegionListNode());
+
+    if (triggerType == Voice::TriggerType::NoteOn && region->offBy) {
+        auto offByList = regionLists.offByVoiceLists.find(*region->offBy);
+        if (offByList != regionLists.offByVoiceLists.end())
+            offByList->second.pushBack(voice->getOffByListNode());
+    }
+}
+
+void sfz::Synth::updateVoiceLists(Voice& voice) noexcept
 {
-    auto activeVoices { 0 };
-    for (const auto& voice : voices) {
-        if (!voice->isFree())
-            activeVoices++;
+    if (!voice.getActiveListNode().isLinked())
+        return;
+
+    if (voice.isFree()) {
+        voice.getTriggerListNode().unlink();
+        voice.getOffByListNode().unlink();
+        voice.getRegionListNode().unlink();
+        voice.getActiveListNode().unlink();
+        voice.getReleasingListNode().unlink();
+        freeVoices.push_back(&voice);
+    } else if (voice.canBeStolen() && !voice.getReleasingListNode().isLinked()) {
+        releasingVoices.pushBack(voice.getReleasingListNode());
     }
-    return activeVoices;
+}
+
+template <class F>
+void sfz::Synth::dispatchToVoices(IntrusiveList<Voice>& list, F&& event) noexcept
+{
+    for (auto it = list.begin(); it != list.end();) {
+        auto& voice = *it;
+        ++it;
+        event(voice);
+        updateVoiceLists(voice);
+    }
+}
+
+void sfz::Synth::reclaimFreeVoices() noexcept
+{
+    dispatchToVoices(activeVoices, [](Voice&) {});
+}
+
+int sfz::Synth::getNumActiveVoices() const noexcept
+{
+    return static_cast<int>(absl::c_count_if(activeVoices, [](const Voice& voice) { return !voice.isFree(); }));
 }
 
 void sfz::Synth::garbageCollect() noexcept
@@ -358,9 +627,9 @@ void sfz::Synth::setSamplesPerBlock(int samplesPerBlock) noexcept
     }
 
     this->samplesPerBlock = samplesPerBlock;
-    this->tempBuffer.resize(samplesPerBlock);
+    resizeRenderBuffers();
     for (auto& voice : voices)
-        voice->setSamplesPerBlock(samplesPerBlock);
+        voice->setSamplesPerBlock(samplesPerBlock * renderFactor());
 }
 
 void sfz::Synth::setSampleRate(float sampleRate) noexcept
@@ -372,7 +641,7 @@ void sfz::Synth::setSampleRate(float sampleRate) noexcept
 
     this->sampleRate = sampleRate;
     for (auto& voice : voices)
-        voice->setSampleRate(sampleRate);
+        voice->setSampleRate(sampleRate * renderFactor());
 }
 
 void sfz::Synth::renderBlock(AudioSpan<float> buffer) noexcept
@@ -391,16 +660,28 @@ void sfz::Synth::renderBlock(AudioSpan<float> buffer) noexcept
     if (!canEnterCallback)
         return;
 
-    auto tempSpan = AudioSpan<float>(tempBuffer).first(buffer.getNumFrames());
-    int numActiveVoices { 0 };
-    for (auto& voice : voices) {
-        if (!voice->isFree()) {
-            numActiveVoices++;
-            voice->renderBlock(tempSpan);
-            buffer.add(tempSpan);
-        }
+    // With render oversampling the voices are mixed at the internal rate,
+    // and the mix is then brought back to the output rate
+    const auto numRenderFrames = buffer.getNumFrames() * renderFactor();
+    auto tempSpan = AudioSpan<float>(tempBuffer).first(numRenderFrames);
+    auto renderSpan = buffer;
+    if (renderOversamplingFactor != Oversampling::x1) {
+        renderSpan = AudioSpan<float>(renderBuffer).first(numRenderFrames);
+        renderSpan.fill(0.0f);
     }
 
+    renderedVoices.clear();
+    for (auto& voice : activeVoices)
+        renderedVoices.push_back(&voice);
+    const int numActiveVoices { static_cast<int>(renderedVoices.size()) };
+    renderPool.render(renderedVoices, renderSpan, tempSpan);
+    // The voices can stop or start releasing while rendering
+    for (auto voice : renderedVoices)
+        updateVoiceLists(*voice);
+
+    if (renderOversamplingFactor != Oversampling::x1)
+        downsampler.process(renderSpan, buffer);
+
     buffer.applyGain(db2mag(volume));
 
     const auto callbackDuration = std::chrono::high_resolution_clock::now() - callbackStartTime;
@@ -437,8 +718,9 @@ void sfz::Synth::noteOff(int delay, int noteNumber, uint8_t velocity [[maybe_unu
     // auto replacedVelocity = (velocity == 0 ? sfz::getNoteVelocity(noteNumber) : velocity);
     const auto replacedVelocity = midiState.getNoteVelocity(noteNumber);
 
-    for (auto& voice : voices)
-        voice->registerNoteOff(delay, noteNumber, replacedVelocity);
+    dispatchToVoices(noteVoiceLists[noteNumber], [&](Voice& voice) {
+        voice.registerNoteOff(delay * renderFactor(), noteNumber, replacedVelocity);
+    });
 
     noteOffDispatch(delay, noteNumber, replacedVelocity);
 }
@@ -446,13 +728,9 @@ void sfz::Synth::noteOff(int delay, int noteNumber, uint8_t velocity [[maybe_unu
 void sfz::Synth::noteOffDispatch(int delay, int noteNumber, uint8_t velocity) noexcept
 {
     const auto randValue = randNoteDistribution(Random::randomGenerator);
-    for (auto& region : noteActivationLists[noteNumber]) {
+    for (auto& region : regionLists.noteActivationLists[noteNumber]) {
         if (region->registerNoteOff(noteNumber, velocity, randValue)) {
-            auto voice = findFreeVoice();
-            if (voice == nullptr)
-                continue;
-
-            voice->startVoice(region, delay, noteNumber, velocity, Voice::TriggerType::NoteOff);
+            startVoice(region, delay, noteNumber, velocity, Voice::TriggerType::NoteOff);
         }
     }
 }
@@ -460,18 +738,40 @@ void sfz::Synth::noteOffDispatch(int delay, int noteNumber, uint8_t velocity) no
 void sfz::Synth::noteOnDispatch(int delay, int noteNumber, uint8_t velocity) noexcept
 {
     const auto randValue = randNoteDistribution(Random::randomGenerator);
-    for (auto& region : noteActivationLists[noteNumber]) {
+    noteOnCounts[noteNumber] += 1;
+    const auto& index = regionLists.noteActivationIndices[noteNumber];
+    const auto candidates = index.getCandidates(velocity);
+    for (auto candidate = candidates.first; candidate < candidates.second; ++candidate) {
+        if (!index.matchesRandom(candidate, randValue))
+            continue;
+
+        // The region is not registered with every note-on on its keys
+        int numNoteOns { 0 };
+        if (index.isSequenced(candidate)) {
+            numNoteOns = index.countNoteOns(candidate, noteOnCounts);
+            if (!index.matchesSequence(candidate, numNoteOns))
+                continue;
+        }
+
+        auto region = index.getRegion(candidate);
+        if (index.isSequenced(candidate))
+            region->setSequenceCounter(numNoteOns - 1);
+
         if (region->registerNoteOn(noteNumber, velocity, randValue)) {
-            for (auto& voice : voices) {
-                if (voice->checkOffGroup(delay, region->group))
-                    noteOffDispatch(delay, voice->getTriggerNumber(), voice->getTriggerValue());
+            // The note-offs can start new voices, so they are dispatched
+            // once the voices of the group are all checked
+            auto offByList = regionLists.offByVoiceLists.find(region->group);
+            if (offByList != regionLists.offByVoiceLists.end()) {
+                offByNoteOffs.clear();
+                dispatchToVoices(offByList->second, [&](Voice& voice) {
+                    if (voice.checkOffGroup(delay * renderFactor(), region->group))
+                        offByNoteOffs.emplace_back(voice.getTriggerNumber(), voice.getTriggerValue());
+                });
+                for (const auto& noteOff : offByNoteOffs)
+                    noteOffDispatch(delay, noteOff.first, noteOff.second);
             }
 
-            auto voice = findFreeVoice();
-            if (voice == nullptr)
-                continue;
-
-            voice->startVoice(region, delay, noteNumber, velocity, Voice::TriggerType::NoteOn);
+            startVoice(region, delay, noteNumber, velocity, Voice::TriggerType::NoteOn);
         }
     }
 }
@@ -491,16 +791,21 @@ void sfz::Synth::cc(int delay, int ccNumber, uint8_t ccValue) noexcept
     }
 
     midiState.ccEvent(ccNumber, ccValue);
-    for (auto& voice : voices)
-        voice->registerCC(delay, ccNumber, ccValue);
+    if (ccNumber == config::allNotesOffCC || ccNumber == config::allSoundOffCC) {
+        dispatchToVoices(activeVoices, [&](Voice& voice) {
+            voice.registerCC(delay * renderFactor(), ccNumber, ccValue);
+        });
+    } else {
+        for (auto regionList : regionLists.ccModulationLists[ccNumber]) {
+            dispatchToVoices(*regionList, [&](Voice& voice) {
+                voice.registerCC(delay * renderFactor(), ccNumber, ccValue);
+            });
+        }
+    }
 
-    for (auto& region : ccActivationLists[ccNumber]) {
+    for (auto& region : regionLists.ccActivationLists[ccNumber]) {
         if (region->registerCC(ccNumber, ccValue)) {
-            auto voice = findFreeVoice();
-            if (voice == nullptr)
-                continue;
-
-            voice->startVoice(region, delay, ccNumber, ccValue, Voice::TriggerType::CC);
+            startVoice(region, delay, ccNumber, ccValue, Voice::TriggerType::CC);
         }
     }
 }
@@ -512,13 +817,15 @@ void sfz::Synth::pitchWheel(int delay, int pitch) noexcept
 
     midiState.pitchBendEvent(pitch);
 
-    for (auto& region: regions) {
+    AtomicGuard callbackGuard { inCallback };
+    if (!canEnterCallback)
+        return;
+
+    for (auto region : regionLists.bendConditionRegions)
         region->registerPitchWheel(pitch);
-    }
 
-    for (auto& voice: voices) {
-        voice->registerPitchWheel(delay, pitch);
-    }
+    for (auto& voice : activeVoices)
+        voice.registerPitchWheel(delay * renderFactor(), pitch);
 }
 void sfz::Synth::aftertouch(int /* delay */, uint8_t /* aftertouch */) noexcept
 {
@@ -564,6 +871,15 @@ size_t sfz::Synth::getNumPreloadedSamples() const noexcept
     return resources.filePool.getNumPreloadedSamples();
 }
 
+size_t sfz::Synth::getRegionsMemoryUsage() const noexcept
+{
+    size_t bytes = resources.sampleTable->getMemoryUsage();
+    for (const auto& region : regions)
+        bytes += region->getMemoryUsage();
+
+    return bytes;
+}
+
 float sfz::Synth::getVolume() const noexcept
 {
     return volume;
@@ -596,11 +912,19 @@ void sfz::Synth::resetVoices(int numVoices)
         voices.push_back(std::make_unique<Voice>(midiState, resources));
 
     for (auto& voice: voices) {
-        voice->setSampleRate(this->sampleRate);
-        voice->setSamplesPerBlock(this->samplesPerBlock);
+        voice->setSampleRate(this->sampleRate * renderFactor());
+        voice->setSamplesPerBlock(this->samplesPerBlock * renderFactor());
+        voice->setInterpolationQuality(sampleQuality);
     }
 
-    voiceViewArray.reserve(numVoices);
+    // The free voices are taken from the back, starting with the first voice
+    freeVoices.clear();
+    freeVoices.reserve(numVoices);
+    for (auto voice = voices.rbegin(); voice != voices.rend(); ++voice)
+        freeVoices.push_back(voice->get());
+    renderedVoices.clear();
+    renderedVoices.reserve(numVoices);
+    offByNoteOffs.reserve(numVoices);
     this->numVoices = numVoices;
 }
 
@@ -624,6 +948,70 @@ sfz::Oversampling sfz::Synth::getOversamplingFactor() const noexcept
     return oversamplingFactor;
 }
 
+void sfz::Synth::setRenderOversamplingFactor(sfz::Oversampling factor) noexcept
+{
+    AtomicDisabler callbackDisabler{ canEnterCallback };
+    while (inCallback) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    renderOversamplingFactor = factor;
+    resizeRenderBuffers();
+    downsampler.setFactor(factor);
+    for (auto& voice: voices) {
+        voice->reset();
+        voice->setSampleRate(sampleRate * renderFactor());
+        voice->setSamplesPerBlock(samplesPerBlock * renderFactor());
+    }
+}
+
+sfz::Oversampling sfz::Synth::getRenderOversamplingFactor() const noexcept
+{
+    return renderOversamplingFactor;
+}
+
+void sfz::Synth::setSampleQuality(sfz::InterpolationQuality quality) noexcept
+{
+    AtomicDisabler callbackDisabler{ canEnterCallback };
+    while (inCallback) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    sampleQuality = quality;
+    for (auto& voice: voices)
+        voice->setInterpolationQuality(quality);
+}
+
+sfz::InterpolationQuality sfz::Synth::getSampleQuality() const noexcept
+{
+    return sampleQuality;
+}
+
+void sfz::Synth::setNumRenderThreads(int numThreads) noexcept
+{
+    ASSERT(numThreads >= 0);
+    AtomicDisabler callbackDisabler{ canEnterCallback };
+    while (inCallback) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    renderPool.setNumThreads(numThreads);
+}
+
+int sfz::Synth::getNumRenderThreads() const noexcept
+{
+    return renderPool.getNumThreads();
+}
+
+void sfz::Synth::resizeRenderBuffers()
+{
+    const auto numRenderFrames = samplesPerBlock * renderFactor();
+    tempBuffer.resize(numRenderFrames);
+    renderBuffer.resize(renderOversamplingFactor != Oversampling::x1 ? numRenderFrames : 0);
+    renderPool.setSamplesPerBlock(numRenderFrames);
+    downsampler.setSamplesPerBlock(samplesPerBlock);
+}
+
 void sfz::Synth::setPreloadSize(uint32_t preloadSize) noexcept
 {
     AtomicDisabler callbackDisabler{ canEnterCallback };
@@ -639,6 +1027,34 @@ uint32_t sfz::Synth::getPreloadSize() const noexcept
     return resources.filePool.getPreloadSize();
 }
 
+void sfz::Synth::setPreloadCacheDirectory(const fs::path& directory)
+{
+    resources.filePool.setPreloadCacheDirectory(directory);
+}
+
+void sfz::Synth::setInstrumentCacheDirectory(const fs::path& directory)
+{
+    if (directory.empty())
+        instrumentCache.reset();
+    else
+        instrumentCache = std::make_unique<InstrumentCache>(directory);
+}
+
+void sfz::Synth::setPreloadMemoryBudget(size_t budget) noexcept
+{
+    resources.filePool.setMemoryBudget(budget);
+}
+
+size_t sfz::Synth::getPreloadMemoryBudget() const noexcept
+{
+    return resources.filePool.getMemoryBudget();
+}
+
+size_t sfz::Synth::getNumColdLoads() const noexcept
+{
+    return resources.filePool.getNumColdLoads();
+}
+
 void sfz::Synth::enableFreeWheeling() noexcept
 {
     if (!freeWheeling) {
@@ -661,11 +1077,14 @@ void sfz::Synth::resetAllControllers(int delay) noexcept
         return;
 
     midiState.resetAllControllers();
-    for (auto& voice: voices) {
-        voice->registerPitchWheel(delay, 0);
+    dispatchToVoices(activeVoices, [&](Voice& voice) {
+        voice.registerPitchWheel(delay * renderFactor(), 0);
         for (int cc = 0; cc < config::numCCs; ++cc)
-            voice->registerCC(delay, cc, 0);
-    }
+            voice.registerCC(delay * renderFactor(), cc, 0);
+    });
+
+    for (auto region : regionLists.bendConditionRegions)
+        region->registerPitchWheel(0);
 
     for (auto& region: regions) {
         for (int cc = 0; cc < config::numCCs; ++cc)
@@ -8,11 +8,18 @@
 #include "Resources.h"
 #include "Parser.h"
 #include "Voice.h"
+#include "IntrusiveList.h"
+#include "NoteActivationIndex.h"
 #include "Region.h"
+#include "InstrumentCache.h"
 #include "LeakDetector.h"
 #include "MidiState.h"
+#include "Oversampler.h"
+#include "RenderPool.h"
 #include "AudioSpan.h"
 #include "absl/types/span.h"
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/node_hash_map.h>
 #include <absl/types/optional.h>
 #include <random>
 #include <set>
@@ -78,9 +85,10 @@ public:
     /**
      * @brief Empties the current regions and load a new SFZ file into the synth.
      *
-     * This function will disable all callbacks so it is safe to call from a
-     * UI thread for example, although it may generate a click. However it is
-     * not reentrant, so you should not call it from concurrent threads.
+     * The new instrument is built while the current one keeps playing, and
+     * the callbacks are only disabled to swap them, so it is safe to call from
+     * a UI thread for example, although the swap may generate a click. However
+     * it is not reentrant, so you should not call it from concurrent threads.
      *
      * @param file
      * @return true
@@ -144,6 +152,13 @@ public:
      * @return size_t
      */
     size_t getNumPreloadedSamples() const noexcept;
+    /**
+     * @brief Get the memory held by the regions and their shared sample
+     * paths, in bytes. The audio data is not included.
+     *
+     * @return size_t
+     */
+    size_t getRegionsMemoryUsage() const noexcept;
 
     /**
      * @brief Set the maximum size of the blocks for the callback. The actual
@@ -282,6 +297,59 @@ public:
      */
     Oversampling getOversamplingFactor() const noexcept;
 
+    /**
+     * @brief Set the render oversampling factor. The voices then render at
+     * this multiple of the sample rate, from the samples at their native
+     * rate, and their mix is downsampled to the output rate. Unlike the
+     * oversampling factor, this does not reload or grow the samples in memory.
+     * This will disable the callback and kill all the voices.
+     *
+     * @param factor
+     */
+    void setRenderOversamplingFactor(Oversampling factor) noexcept;
+
+    /**
+     * @brief Get the current render oversampling factor
+     *
+     * @return Oversampling
+     */
+    Oversampling getRenderOversamplingFactor() const noexcept;
+
+    /**
+     * @brief Set the interpolation quality of the sample playback. The
+     * regions which set the sample_quality opcode keep their own quality.
+     * Higher qualities reduce the aliasing and imaging of transposed samples
+     * without oversampling them, but take more time to render.
+     * This will disable the callback.
+     *
+     * @param quality
+     */
+    void setSampleQuality(InterpolationQuality quality) noexcept;
+
+    /**
+     * @brief Get the current interpolation quality of the sample playback
+     *
+     * @return InterpolationQuality
+     */
+    InterpolationQuality getSampleQuality() const noexcept;
+
+    /**
+     * @brief Set the number of worker threads that render the voices in
+     * parallel with the audio thread. With 0 threads, which is the default,
+     * all the voices are rendered on the audio thread. This will disable the
+     * callback.
+     *
+     * @param numThreads
+     */
+    void setNumRenderThreads(int numThreads) noexcept;
+
+    /**
+     * @brief Get the number of worker threads that render the voices
+     *
+     * @return int
+     */
+    int getNumRenderThreads() const noexcept;
+
     /**
      * @brief Set the preloaded file size. This will disable the callback.
      *
@@ -296,6 +364,50 @@ public:
      */
     uint32_t getPreloadSize() const noexcept;
 
+    /**
+     * @brief Set the directory of the on-disk preload cache, which keeps the
+     * preloaded data of the samples between sessions. An empty path disables
+     * the cache, which is the default.
+     *
+     * @param directory
+     */
+    void setPreloadCacheDirectory(const fs::path& directory);
+
+    /**
+     * @brief Set the directory of the on-disk instrument cache, which keeps
+     * the regions built from the SFZ files between sessions so that they are
+     * not parsed again. An empty path disables the cache, which is the default.
+     *
+     * @param directory
+     */
+    void setInstrumentCacheDirectory(const fs::path& directory);
+
+    /**
+     * @brief Set the memory budget of the preloaded data, in bytes. The least
+     * recently used preloads are evicted to fit in the budget, and their
+     * samples are then streamed from disk with some added latency. A budget
+     * of 0, which is the default, disables the eviction. The budget only
+     * applies without oversampling.
+     *
+     * @param budget
+     */
+    void setPreloadMemoryBudget(size_t budget) noexcept;
+
+    /**
+     * @brief Get the memory budget of the preloaded data, in bytes.
+     *
+     * @return size_t
+     */
+    size_t getPreloadMemoryBudget() const noexcept;
+
+    /**
+     * @brief Get the number of notes that streamed their sample from disk
+     * because its preloaded data was evicted.
+     *
+     * @return size_t
+     */
+    size_t getNumColdLoads() const noexcept;
+
     /**
      * @brief      Gets the number of allocated buffers.
      *
@@ -348,6 +460,30 @@ protected:
     void callback(absl::string_view header, const std::vector<Opcode>& members) final;
 
 private:
+    using RegionPtrVector = std::vector<Region*>;
+    using VoiceList = IntrusiveList<Voice>;
+    /**
+     * @brief The lists of the regions of an instrument and of their voices.
+     * The lists of a new instrument are built aside while the current one
+     * plays, and swapped with the current lists once complete.
+     */
+    struct RegionLists {
+        // The active voices by the group that turns them off
+        absl::flat_hash_map<uint32_t, VoiceList> offByVoiceLists;
+        // The active voices of each region, and the lists of the regions whose
+        // voices are modulated by each CC, so that a CC event only visits the
+        // voices that react to it
+        absl::node_hash_map<const Region*, VoiceList> regionVoiceLists;
+        std::array<std::vector<VoiceList*>, config::numCCs> ccModulationLists;
+        std::array<RegionPtrVector, 128> noteActivationLists;
+        std::array<RegionPtrVector, config::numCCs> ccActivationLists;
+        // Compiled note-on activation of the regions in noteActivationLists
+        std::array<NoteActivationIndex, 128> noteActivationIndices;
+        // Regions with a lobend/hibend condition, which are the only ones
+        // concerned by the pitch wheel events
+        RegionPtrVector bendConditionRegions;
+    };
+
     /**
      * @brief Reset all CCs; to be used on CC 121
      *
@@ -362,7 +498,8 @@ private:
 
     /**
      * @brief Remove all regions, resets all voices and clears everything
-     * to bring back the synth in its original state.
+     * to bring back the synth in its original state. The preloaded files are
+     * kept for the next instrument. The callbacks must be disabled.
      *
      */
     void clear();
@@ -373,6 +510,18 @@ private:
      * @param numVoices
      */
     void resetVoices(int numVoices);
+    /**
+     * @brief Resize the voice mix buffers for the block size and the render
+     * oversampling factor. The callbacks must be disabled.
+     */
+    void resizeRenderBuffers();
+    /**
+     * @brief Get the render oversampling factor as a multiplier of the
+     * sample rate, block size and event delays of the voices.
+     *
+     * @return int
+     */
+    int renderFactor() const noexcept { return static_cast<int>(renderOversamplingFactor); }
     /**
      * @brief Helper function to dispatch <global> opcodes
      *
@@ -393,9 +542,49 @@ private:
      * @param regionOpcodes the opcodes that are specific to the region
      */
     void buildRegion(const std::vector<Opcode>& regionOpcodes);
+    /**
+     * @brief Apply the file information to a parsed region and add it to
+     * some region lists, so that it can start playing once these lists are
+     * swapped in. The region starts with the CC values of the instrument.
+     *
+     * @param region
+     * @param fileInformation the information of the region sample, or nothing
+     *                        for generators
+     * @param lists the lists of the parsed instrument
+     */
+    void activateRegion(Region& region, const absl::optional<FileInformation>& fileInformation, RegionLists& lists) noexcept;
+    /**
+     * @brief Add some activated regions to the note, CC and CC modulation lists.
+     *
+     * @param activationLists the activation lists of the instrument
+     * @param builtRegions the regions of the instrument, by index in the lists
+     * @param activated the regions to add, by index in the lists
+     * @param lists the lists of the parsed instrument
+     */
+    void addToActivationLists(const ActivationLists& activationLists, absl::Span<Region* const> builtRegions,
+        const std::vector<bool>& activated, RegionLists& lists);
+    /**
+     * @brief Build the regions of an SFZ file into parsedInstrument, or read
+     * them from the instrument cache, and write the cache entry if needed.
+     * This only touches the parsing state, so the callbacks can stay enabled.
+     *
+     * @param file
+     * @return true if the file could be read
+     */
+    bool loadInstrument(const fs::path& file);
+    /**
+     * @brief Reset the parsing state before loading a new instrument.
+     */
+    void resetParsingState();
 
     fs::file_time_type checkModificationTime();
 
+    /**
+     * @brief Compile the note-on activation of the active regions
+     *
+     * @param lists
+     */
+    static void buildNoteActivationIndices(RegionLists& lists);
     void noteOnDispatch(int delay, int noteNumber, uint8_t velocity) noexcept;
     void noteOffDispatch(int delay, int noteNumber, uint8_t velocity) noexcept;
 
@@ -404,36 +593,103 @@ private:
     std::vector<Opcode> globalOpcodes;
     std::vector<Opcode> masterOpcodes;
     std::vector<Opcode> groupOpcodes;
+    // Region holding the global, master and group opcodes, which is copied
+    // for each region of the group rather than parsing them again; it is
+    // reset when these opcodes or the default path change
+    std::unique_ptr<Region> regionTemplate;
+    // The instrument being parsed, with the table of its sample paths; the
+    // current instrument is swapped with it once it is built
+    CompiledInstrument parsedInstrument;
+    std::unique_ptr<SampleTable> parsedSampleTable { std::make_unique<SampleTable>() };
+    std::unique_ptr<InstrumentCache> instrumentCache;
 
     /**
-     * @brief Find a voice that is not currently playing
+     * @brief Find a voice that is not currently playing. This takes the top
+     * of the free voice stack, and otherwise steals the voice that has been
+     * releasing the longest among those quiet enough.
      *
-     * @return Voice*
+     * @return Voice* the voice, which is not part of the active voices yet,
+     *                or nullptr if none could be found
      */
     Voice* findFreeVoice() noexcept;
+    /**
+     * @brief Start a region on a free voice, if any.
+     *
+     * @param region
+     * @param delay
+     * @param number
+     * @param value
+     * @param triggerType
+     */
+    void startVoice(Region* region, int delay, int number, uint8_t value, Voice::TriggerType triggerType) noexcept;
+    /**
+     * @brief Move an active voice back to the free voices if it stopped
+     * playing, or add it to the releasing voices if it started releasing.
+     * This is called after every event sent to the voice, and after every
+     * block for the voices that changed while rendering.
+     *
+     * @param voice
+     */
+    void updateVoiceLists(Voice& voice) noexcept;
+    /**
+     * @brief Send an event to the voices of a list, and update the lists of
+     * each voice after it; the voices can leave the list on the way.
+     *
+     * @param list
+     * @param event called with each voice
+     */
+    template <class F>
+    void dispatchToVoices(IntrusiveList<Voice>& list, F&& event) noexcept;
+    /**
+     * @brief Move the voices that stopped playing from the active voices
+     * back to the free voices, e.g. after resetting them all.
+     */
+    void reclaimFreeVoices() noexcept;
     // Names for the cc as set by the label_cc opcode
     std::vector<CCNamePair> ccNames;
     // Default active switch if multiple keyswitchable regions are present
     absl::optional<uint8_t> defaultSwitch;
     std::vector<std::string> unknownOpcodes;
-    using RegionPtrVector = std::vector<Region*>;
     using VoicePtrVector = std::vector<Voice*>;
     std::vector<std::unique_ptr<Region>> regions;
     std::vector<std::unique_ptr<Voice>> voices;
-    // Views to speed up iteration over the regions and voices when events
-    // occur in the audio callback
-    VoicePtrVector voiceViewArray;
-    std::array<RegionPtrVector, 128> noteActivationLists;
-    std::array<RegionPtrVector, config::numCCs> ccActivationLists;
+    // Every voice is either on the free stack or in the active voices,
+    // which are ordered from the oldest to the most recently started. The
+    // releasing voices are the active voices that can be stolen, in the order
+    // they were found releasing. The voices only change list in
+    // updateVoiceLists(), so the active voices can hold voices that went idle
+    // since they were last updated, e.g. while rendering.
+    VoicePtrVector freeVoices;
+    VoiceList activeVoices;
+    VoiceList releasingVoices;
+    // The active voices of the current block, as rendered by the render pool
+    VoicePtrVector renderedVoices;
+    // The active voices by trigger number, and by the group that turns them
+    // off, so that note-off and off_by events only visit the voices they
+    // affect. Like the active voices, these can hold idle voices until they
+    // are updated.
+    std::array<VoiceList, 128> noteVoiceLists;
+    RegionLists regionLists;
+    // Note-offs triggered by an off_by group during a note-on
+    std::vector<std::pair<int, uint8_t>> offByNoteOffs;
+    // Number of note-ons received on each key, which gives the position of
+    // the regions in their sequence
+    std::array<int, 128> noteOnCounts {};
 
     // Internal temporary buffer
     AudioBuffer<float> tempBuffer { 2, config::defaultSamplesPerBlock };
+    // Mix of the voices at the internal rate, with render oversampling
+    AudioBuffer<float> renderBuffer { 2, 0 };
+    Downsampler downsampler;
+    RenderPool renderPool;
 
     int samplesPerBlock { config::defaultSamplesPerBlock };
     float sampleRate { config::defaultSampleRate };
     float volume { Default::globalVolume };
     int numVoices { config::numVoices };
     Oversampling oversamplingFactor { config::defaultOversamplingFactor };
+    Oversampling renderOversamplingFactor { Oversampling::x1 };
+    InterpolationQuality sampleQuality { config::defaultInterpolationQuality };
 
     // Distribution used to generate random value for the *rand opcodes
     std::uniform_real_distribution<float> randNoteDistribution { 0, 1 };
@@ -9,6 +9,7 @@
 #include "Config.h"
 #include "Defaults.h"
 #include "MathHelpers.h"
+#include "PanTable.h"
 #include "SIMDHelpers.h"
 #include "SfzHelpers.h"
 #include "absl/algorithm/container.h"
@@ -32,15 +33,20 @@ void sfz::Voice::startVoice(Region* region, int delay, int number, uint8_t value
     if (delay < 0)
         delay = 0;
 
+    pitchRatio = region->getBasePitchVariation(number, value);
+    sourcePosition = region->getOffset();
+
     if (!region->isGenerator()) {
-        currentPromise = resources.filePool.getFilePromise(region->sample);
+        absl::optional<Range<uint32_t>> loop {};
+        if (region->shouldLoop())
+            loop.emplace(region->loopRange);
+        currentPromise = resources.filePool.getFilePromise(region->sampleId, loop, sourcePosition, pitchRatio);
         if (currentPromise == nullptr) {
             reset();
             return;
         }
         speedRatio = static_cast<float>(currentPromise->sampleRate / this->sampleRate);
     }
-    pitchRatio = region->getBasePitchVariation(number, value);
 
     baseVolumedB = region->getBaseVolumedB(number);
     auto volumedB { baseVolumedB };
@@ -85,7 +91,6 @@ void sfz::Voice::startVoice(Region* region, int delay, int number, uint8_t value
     });
     pitchBendEnvelope.reset(static_cast<float>(midiState.getPitchBend()));
 
-    sourcePosition = region->getOffset();
     triggerDelay = delay;
     initialDelay = delay + static_cast<uint32_t>(region->getDelay() * sampleRate);
     baseFrequency = midiNoteFrequency(number);
@@ -265,6 +270,35 @@ void sfz::Voice::renderBlock(AudioSpan<float> buffer) noexcept
     this->triggerDelay = absl::nullopt;
 }
 
+absl::optional<float> sfz::Voice::getGainBlock(absl::Span<float> gainSpan, absl::Span<float> tempSpan) noexcept
+{
+    float constantGain { 1.0f };
+    bool varying { false };
+    const auto foldEnvelope = [&](auto& envelope) {
+        // The first varying envelope is written in the gain span directly
+        if (auto value = envelope.getBlockOrConstant(varying ? tempSpan : gainSpan)) {
+            constantGain *= *value;
+            return;
+        }
+
+        if (varying)
+            applyGain<float>(tempSpan, gainSpan);
+        varying = true;
+    };
+
+    foldEnvelope(amplitudeEnvelope);
+    foldEnvelope(crossfadeEnvelope);
+    foldEnvelope(volumeEnvelope);
+    foldEnvelope(egEnvelope);
+
+    if (!varying)
+        return constantGain;
+
+    if (constantGain != 1.0f)
+        applyGain<float>(constantGain, gainSpan);
+    return {};
+}
+
 void sfz::Voice::processMono(AudioSpan<float> buffer) noexcept
 {
     const auto numSamples = buffer.getNumFrames();
@@ -274,35 +308,31 @@ void sfz::Voice::processMono(AudioSpan<float> buffer) noexcept
     auto span1 = tempSpan1.first(numSamples);
     auto span2 = tempSpan2.first(numSamples);
 
-    // Amplitude envelope
-    amplitudeEnvelope.getBlock(span1);
-    applyGain<float>(span1, leftBuffer);
+    // Amplitude, crossfade, volume and AmpEG envelopes
+    float constantGain { 1.0f };
+    if (auto gain = getGainBlock(span1, span2))
+        constantGain = *gain;
+    else
+        applyGain<float>(span1, leftBuffer);
 
-    // Crossfade envelope
-    crossfadeEnvelope.getBlock(span1);
-    applyGain<float>(span1, leftBuffer);
+    // We assume that the pan envelope is already normalized between -1 and 1
+    if (auto pan = panEnvelope.getBlockOrConstant(span1)) {
+        // The constant gains are folded into the pan gains, and the right
+        // channel is written while copying the mono signal
+        float leftGain;
+        float rightGain;
+        PanTable::get().gains(*pan, leftGain, rightGain);
+        applyGain<float>(constantGain * rightGain, leftBuffer, rightBuffer);
+        applyGain<float>(constantGain * leftGain, leftBuffer);
+        return;
+    }
 
-    // Volume envelope
-    volumeEnvelope.getBlock(span1);
-    applyGain<float>(span1, leftBuffer);
+    if (constantGain != 1.0f)
+        applyGain<float>(constantGain, leftBuffer);
 
-    // AmpEG envelope
-    egEnvelope.getBlock(span1);
+    panGains<float>(span1, span1, span2);
+    applyGain<float>(span2, leftBuffer, rightBuffer);
     applyGain<float>(span1, leftBuffer);
-
-    // Prepare for stereo output
-    copy<float>(leftBuffer, rightBuffer);
-
-    panEnvelope.getBlock(span1);
-    // We assume that the pan envelope is already normalized between -1 and 1
-    // Check bm_pan for your architecture to check if it's interesting to use the pan helper instead
-    fill<float>(span2, 1.0f);
-    add<float>(span1, span2);
-    applyGain<float>(piFour<float>, span2);
-    cos<float>(span2, span1);
-    sin<float>(span2, span2);
-    applyGain<float>(span1, leftBuffer);
-    applyGain<float>(span2, rightBuffer);
 }
 
 void sfz::Voice::processStereo(AudioSpan<float> buffer) noexcept
@@ -314,53 +344,65 @@ void sfz::Voice::processStereo(AudioSpan<float> buffer) noexcept
     auto leftBuffer = buffer.getSpan(0);
     auto rightBuffer = buffer.getSpan(1);
 
-    // Amplitude envelope
-    amplitudeEnvelope.getBlock(span1);
-    buffer.applyGain(span1);
-
-    // Crossfade envelope
-    crossfadeEnvelope.getBlock(span1);
-    buffer.applyGain(span1);
-
-    // Volume envelope
-    volumeEnvelope.getBlock(span1);
-    buffer.applyGain(span1);
+    // Amplitude, crossfade, volume and AmpEG envelopes
+    float constantGain { 1.0f };
+    if (auto gain = getGainBlock(span1, span2))
+        constantGain = *gain;
+    else
+        buffer.applyGain(span1);
+
+    const auto& panTable = PanTable::get();
+    const auto width = widthEnvelope.getBlockOrConstant(span1);
+    const auto position = positionEnvelope.getBlockOrConstant(span2);
+    if (width && position) {
+        // With a constant width and position, the mid/side processing below
+        // reduces to a 2x2 matrix on the left and right channels, which also
+        // takes the constant gains
+        float widthCos;
+        float widthSin;
+        float positionCos;
+        float positionSin;
+        panTable.gains(*width, widthCos, widthSin);
+        panTable.gains(*position, positionCos, positionSin);
+        const float gain = 0.5f * constantGain;
+        const float leftToLeft = gain * (widthSin + positionCos * widthCos);
+        const float rightToLeft = gain * (widthSin - positionCos * widthCos);
+        const float leftToRight = gain * (widthSin + positionSin * widthCos);
+        const float rightToRight = gain * (widthSin - positionSin * widthCos);
+        applyGain<float>(leftToLeft, leftBuffer, span1);
+        applyGain<float>(leftToRight, leftBuffer, span2);
+        applyGain<float>(rightToLeft, rightBuffer, leftBuffer);
+        add<float>(span1, leftBuffer);
+        applyGain<float>(rightToRight, rightBuffer);
+        add<float>(span2, rightBuffer);
+        return;
+    }
 
-    // AmpEG envelope
-    egEnvelope.getBlock(span1);
-    buffer.applyGain(span1);
+    if (width)
+        fill<float>(span1, *width);
+    if (position)
+        fill<float>(span2, *position);
 
-    // Create mid/side from left/right in the output buffer
-    copy<float>(rightBuffer, span1);
+    // Create mid/side from left/right in the output buffer. The 1/sqrt(2)
+    // scalings of the mid/side conversion and of the position stage are
+    // applied together at the end, with the constant gains.
+    copy<float>(rightBuffer, span3);
     add<float>(leftBuffer, rightBuffer);
-    subtract<float>(span1, leftBuffer);
-    applyGain<float>(sqrtTwoInv<float>, leftBuffer);
-    applyGain<float>(sqrtTwoInv<float>, rightBuffer);
+    subtract<float>(span3, leftBuffer);
 
     // Apply the width process
-    widthEnvelope.getBlock(span1);
-    fill<float>(span2, 1.0f);
-    add<float>(span1, span2);
-    applyGain<float>(piFour<float>, span2);
-    cos<float>(span2, span1);
-    sin<float>(span2, span2);
+    panGains<float>(span1, span1, span3);
     applyGain<float>(span1, leftBuffer);
-    applyGain<float>(span2, rightBuffer);
+    applyGain<float>(span3, rightBuffer);
 
     // Apply a position to the "left" channel which is supposed to be our mid channel
     // TODO: add panning here too?
-    positionEnvelope.getBlock(span1);
-    fill<float>(span2, 1.0f);
-    add<float>(span1, span2);
-    applyGain<float>(piFour<float>, span2);
-    cos<float>(span2, span1);
-    sin<float>(span2, span2);
+    panGains<float>(span2, span1, span2);
     copy<float>(leftBuffer, span3);
     copy<float>(rightBuffer, leftBuffer);
     multiplyAdd<float>(span1, span3, leftBuffer);
     multiplyAdd<float>(span2, span3, rightBuffer);
-    applyGain<float>(sqrtTwoInv<float>, leftBuffer);
-    applyGain<float>(sqrtTwoInv<float>, rightBuffer);
+    buffer.applyGain(0.5f * constantGain);
 }
 
 void sfz::Voice::fillWithData(AudioSpan<float> buffer) noexcept
@@ -393,8 +435,11 @@ void sfz::Voice::fillWithData(AudioSpan<float> buffer) noexcept
     add<int>(sourcePosition, indices);
 
     absl::optional<int> releaseAt {};
+    const bool streaming = currentPromise->streaming;
 
-    if (region->shouldLoop() && region->loopEnd(currentPromise->oversamplingFactor) <= source.getNumFrames()) {
+    if (streaming && currentPromise->stream.looping) {
+        // Streamed loops are unrolled by the loading threads
+    } else if (!streaming && region->shouldLoop() && region->loopEnd(currentPromise->oversamplingFactor) <= source.getNumFrames()) {
         const auto loopEnd = static_cast<int>(region->loopEnd(currentPromise->oversamplingFactor));
         const auto offset = loopEnd - static_cast<int>(region->loopStart(currentPromise->oversamplingFactor)) + 1;
         for (auto* index = indices.begin(); index < indices.end(); ++index) {
@@ -404,19 +449,20 @@ void sfz::Voice::fillWithData(AudioSpan<float> buffer) noexcept
             }
         }
     } else {
+        const auto availableFrames = streaming ? currentPromise->stream.numFrames : source.getNumFrames();
         const auto sampleEnd = min(
             static_cast<int>(region->trueSampleEnd(currentPromise->oversamplingFactor)),
-            static_cast<int>(source.getNumFrames())
+            static_cast<int>(availableFrames)
         ) - 2;
         for (auto* index = indices.begin(); index < indices.end(); ++index) {
             if (*index >= sampleEnd) {
                 releaseAt = static_cast<int>(std::distance(indices.begin(), index));
                 const auto remainingElements = static_cast<size_t>(std::distance(index, indices.end()));
-                if (source.getNumFrames() != region->trueSampleEnd(currentPromise->oversamplingFactor)) {
+                if (availableFrames != region->trueSampleEnd(currentPromise->oversamplingFactor)) {
                     DBG("[sfizz] Underflow: source available samples "
                         << source.getNumFrames() << "/"
                         << region->trueSampleEnd(currentPromise->oversamplingFactor)
-                        << " for sample " << region->sample);
+                        << " for sample " << region->getSample());
                 }
                 fill<int>(indices.last(remainingElements), sampleEnd);
                 fill<float>(leftCoeffs.last(remainingElements), 0.0f);
@@ -426,28 +472,36 @@ void sfz::Voice::fillWithData(AudioSpan<float> buffer) noexcept
         }
     }
 
-    auto ind = indices.data();
-    auto leftCoeff = leftCoeffs.data();
-    auto rightCoeff = rightCoeffs.data();
-    auto leftSource = source.getConstSpan(0);
-    auto left = buffer.getChannel(0);
-    if (source.getNumChannels() == 1) {
-        while (ind < indices.end()) {
-            *left = linearInterpolation(leftSource[*ind], leftSource[*ind + 1], *leftCoeff, *rightCoeff);
-            incrementAll(ind, left, leftCoeff, rightCoeff);
-        }
+    const auto quality = region->sampleQuality.value_or(interpolationQuality);
+    if (streaming) {
+        fillWithStream(buffer, indices, leftCoeffs, rightCoeffs, quality);
     } else {
-        auto right = buffer.getChannel(1);
-        auto rightSource = source.getConstSpan(1);
-        while (ind < indices.end()) {
-            *left = linearInterpolation(leftSource[*ind], leftSource[*ind + 1], *leftCoeff, *rightCoeff);
-            *right = linearInterpolation(rightSource[*ind], rightSource[*ind + 1], *leftCoeff, *rightCoeff);
-            incrementAll(ind, left, right, leftCoeff, rightCoeff);
-        }
+        // The source is converted to float while interpolating if it is stored as integers
+        source.visit([&](auto frames) {
+            for (size_t c = 0; c < frames.getNumChannels(); ++c) {
+                switch (quality) {
+                case InterpolationQuality::Linear:
+                    interpolateLinear(frames.getConstSpan(c), indices, leftCoeffs, rightCoeffs, buffer.getSpan(c));
+                    break;
+                case InterpolationQuality::Hermite:
+                    interpolateHermite(frames.getConstSpan(c), indices, rightCoeffs, buffer.getSpan(c));
+                    break;
+                case InterpolationQuality::Sinc:
+                    interpolateSinc(frames.getConstSpan(c), indices, rightCoeffs, buffer.getSpan(c));
+                    break;
+                }
+            }
+        });
     }
 
     sourcePosition = indices.back();
     floatPositionOffset = rightCoeffs.back();
+    if (streaming) {
+        // Keep the frames before the position which the interpolation reads
+        const int history = quality == InterpolationQuality::Linear ? 0 : SincTable::tapsBefore;
+        const auto readPosition = static_cast<uint32_t>(max(sourcePosition - history, 0));
+        currentPromise->stream.readPosition = max(currentPromise->stream.startPosition, readPosition);
+    }
 
     if (state != State::release && releaseAt) {
         release(*releaseAt);
@@ -456,9 +510,93 @@ void sfz::Voice::fillWithData(AudioSpan<float> buffer) noexcept
     }
 }
 
+void sfz::Voice::fillWithStream(AudioSpan<float> buffer, absl::Span<const int> indices,
+    absl::Span<const float> leftCoeffs, absl::Span<const float> rightCoeffs,
+    InterpolationQuality quality) noexcept
+{
+    auto& stream = currentPromise->stream;
+    auto preloaded = currentPromise->getData();
+    const auto numChannels = preloaded.getNumChannels();
+    const auto startPosition = static_cast<int>(stream.startPosition);
+    const auto endPosition = static_cast<int>(stream.endPosition.load());
+    constexpr int ringFrames { static_cast<int>(FileStream::ringFrames) };
+
+    // The ring is only allocated once the first chunk is loaded
+    absl::Span<const float> ring[2] {};
+    if (endPosition > startPosition) {
+        for (size_t i = 0; i < numChannels; ++i)
+            ring[i] = stream.ring.getConstSpan(i);
+    }
+
+    bool underflow { false };
+    if (quality != InterpolationQuality::Linear) {
+        // The higher order interpolations read their taps one at a time, from
+        // the preloaded data or the ring
+        const auto& sincTable = SincTable::get();
+        const auto lastFrame = static_cast<int>(stream.numFrames) - 1;
+        preloaded.visit([&](auto preloadedFrames) {
+            const auto preloadedEnd = static_cast<int>(preloadedFrames.getNumFrames());
+            decltype(preloadedFrames.getConstSpan(0)) sources[2] {};
+            for (size_t c = 0; c < numChannels; ++c)
+                sources[c] = preloadedFrames.getConstSpan(c);
+
+            auto sampleAt = [&](size_t c, int tap) -> float {
+                if (!stream.looping)
+                    tap = min(tap, lastFrame);
+                tap = max(tap, 0);
+                if (tap <= startPosition && tap < preloadedEnd)
+                    return sampleToFloat(sources[c][tap]);
+                if (tap >= startPosition && tap < endPosition)
+                    return ring[c][(tap - startPosition) % ringFrames];
+                underflow = true;
+                return 0.0f;
+            };
+
+            for (size_t i = 0; i < indices.size(); ++i) {
+                const auto index = indices[i];
+                for (size_t c = 0; c < numChannels; ++c) {
+                    if (quality == InterpolationQuality::Hermite) {
+                        buffer.getSpan(c)[i] = hermiteInterpolation(sampleAt(c, index - 1), sampleAt(c, index),
+                            sampleAt(c, index + 1), sampleAt(c, index + 2), rightCoeffs[i]);
+                    } else {
+                        buffer.getSpan(c)[i] = sincTable.interpolate(rightCoeffs[i],
+                            [&](int offset) { return sampleAt(c, index + offset); });
+                    }
+                }
+            }
+        });
+    } else {
+        preloaded.visit([&](auto preloadedFrames) {
+            for (size_t i = 0; i < indices.size(); ++i) {
+                const auto index = indices[i];
+                if (index + 1 <= startPosition) {
+                    for (size_t c = 0; c < numChannels; ++c) {
+                        const auto source = preloadedFrames.getConstSpan(c);
+                        buffer.getSpan(c)[i] = linearInterpolation(sampleToFloat(source[index]), sampleToFloat(source[index + 1]), leftCoeffs[i], rightCoeffs[i]);
+                    }
+                } else if (index >= startPosition && index + 1 < endPosition) {
+                    const auto first = (index - startPosition) % ringFrames;
+                    const auto second = first + 1 < ringFrames ? first + 1 : 0;
+                    for (size_t c = 0; c < numChannels; ++c)
+                        buffer.getSpan(c)[i] = linearInterpolation(ring[c][first], ring[c][second], leftCoeffs[i], rightCoeffs[i]);
+                } else {
+                    for (size_t c = 0; c < numChannels; ++c)
+                        buffer.getSpan(c)[i] = 0.0f;
+                    underflow = true;
+                }
+            }
+        });
+    }
+
+    if (underflow) {
+        DBG("[sfizz] Underflow: streamed up to position " << endPosition
+            << " for sample " << region->getSample());
+    }
+}
+
 void sfz::Voice::fillWithGenerator(AudioSpan<float> buffer) noexcept
 {
-    if (region->sample != "*sine")
+    if (region->getSample() != "*sine")
         return;
 
     if (buffer.getNumFrames() == 0)
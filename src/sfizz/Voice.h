@@ -9,6 +9,7 @@
 #include "ADSREnvelope.h"
 #include "EventEnvelopes.h"
 #include "HistoricalBuffer.h"
+#include "IntrusiveList.h"
 #include "Region.h"
 #include "AudioBuffer.h"
 #include "MidiState.h"
@@ -57,6 +58,13 @@ public:
      * @param samplesPerBlock
      */
     void setSamplesPerBlock(int samplesPerBlock) noexcept;
+    /**
+     * @brief Set the interpolation quality of the sample playback, for the
+     * regions which do not set their own with sample_quality.
+     *
+     * @param quality
+     */
+    void setInterpolationQuality(InterpolationQuality quality) noexcept { interpolationQuality = quality; }
     /**
      * @brief Get the sample rate of the voice.
      *
@@ -196,6 +204,33 @@ public:
      * @return
      */
     const Region* getRegion() const noexcept { return region; }
+
+    using ListNode = IntrusiveList<Voice>::Node;
+    /**
+     * @brief Get the node of the voice in the list of voices triggered by the
+     * same number. The list is maintained by the synth.
+     */
+    ListNode& getTriggerListNode() noexcept { return triggerListNode; }
+    /**
+     * @brief Get the node of the voice in the list of voices that are turned
+     * off by the same group. The list is maintained by the synth.
+     */
+    ListNode& getOffByListNode() noexcept { return offByListNode; }
+    /**
+     * @brief Get the node of the voice in the list of voices playing the
+     * same region. The list is maintained by the synth.
+     */
+    ListNode& getRegionListNode() noexcept { return regionListNode; }
+    /**
+     * @brief Get the node of the voice in the list of active voices. The list
+     * is maintained by the synth.
+     */
+    ListNode& getActiveListNode() noexcept { return activeListNode; }
+    /**
+     * @brief Get the node of the voice in the list of releasing voices, which
+     * can be stolen. The list is maintained by the synth.
+     */
+    ListNode& getReleasingListNode() noexcept { return releasingListNode; }
 private:
     /**
      * @brief Fill a span with data from a file source. This is the first step
@@ -204,6 +239,19 @@ private:
      * @param buffer
      */
     void fillWithData(AudioSpan<float> buffer) noexcept;
+    /**
+     * @brief Interpolate the data of a streamed file source at the given
+     * playback positions.
+     *
+     * @param buffer
+     * @param indices
+     * @param leftCoeffs
+     * @param rightCoeffs
+     * @param quality
+     */
+    void fillWithStream(AudioSpan<float> buffer, absl::Span<const int> indices,
+        absl::Span<const float> leftCoeffs, absl::Span<const float> rightCoeffs,
+        InterpolationQuality quality) noexcept;
     /**
      * @brief Fill a span with data from a generator source. This is the first step
      * in rendering each block of data.
@@ -218,6 +266,19 @@ private:
      * @param velocity
      */
     void prepareEGEnvelope(int delay, uint8_t velocity) noexcept;
+    /**
+     * @brief Get the product of the amplitude, crossfade, volume and
+     * amplitude EG envelopes over a block. The envelopes which are constant
+     * over the block are folded into a scalar, and the others are multiplied
+     * together in a gain span.
+     *
+     * @param gainSpan the gain span, filled if an envelope varies
+     * @param tempSpan a temporary span of the same size
+     * @return absl::optional<float> the gain if all the envelopes are
+     *                               constant, in which case the gain span
+     *                               is left untouched
+     */
+    absl::optional<float> getGainBlock(absl::Span<float> gainSpan, absl::Span<float> tempSpan) noexcept;
     /**
      * @brief The function processing a mono sample source
      *
@@ -280,6 +341,7 @@ private:
     int samplesPerBlock { config::defaultSamplesPerBlock };
     int minEnvelopeDelay { config::defaultSamplesPerBlock / 2 };
     float sampleRate { config::defaultSampleRate };
+    InterpolationQuality interpolationQuality { config::defaultInterpolationQuality };
 
     const MidiState& midiState;
     Resources& resources;
@@ -295,6 +357,11 @@ private:
     float bendStepFactor { centsFactor(1) };
 
     HistoricalBuffer<float> powerHistory { config::powerHistoryLength };
+    ListNode triggerListNode { *this };
+    ListNode offByListNode { *this };
+    ListNode regionListNode { *this };
+    ListNode activeListNode { *this };
+    ListNode releasingListNode { *this };
     LEAK_DETECTOR(Voice);
 };
 
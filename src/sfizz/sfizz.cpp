@@ -150,6 +150,65 @@ int sfz::Sfizz::getOversamplingFactor() const noexcept
     return static_cast<int>(synth->getOversamplingFactor());
 }
 
+bool sfz::Sfizz::setRenderOversamplingFactor(int factor) noexcept
+{
+    switch(factor)
+    {
+        case 1:
+            synth->setRenderOversamplingFactor(sfz::Oversampling::x1);
+            return true;
+        case 2:
+            synth->setRenderOversamplingFactor(sfz::Oversampling::x2);
+            return true;
+        case 4:
+            synth->setRenderOversamplingFactor(sfz::Oversampling::x4);
+            return true;
+        case 8:
+            synth->setRenderOversamplingFactor(sfz::Oversampling::x8);
+            return true;
+        default:
+            return false;
+    }
+}
+
+int sfz::Sfizz::getRenderOversamplingFactor() const noexcept
+{
+    return static_cast<int>(synth->getRenderOversamplingFactor());
+}
+
+bool sfz::Sfizz::setSampleQuality(int quality) noexcept
+{
+    switch(quality)
+    {
+        case 1:
+            synth->setSampleQuality(sfz::InterpolationQuality::Linear);
+            return true;
+        case 2:
+            synth->setSampleQuality(sfz::InterpolationQuality::Hermite);
+            return true;
+        case 3:
+            synth->setSampleQuality(sfz::InterpolationQuality::Sinc);
+            return true;
+        default:
+            return false;
+    }
+}
+
+int sfz::Sfizz::getSampleQuality() const noexcept
+{
+    return static_cast<int>(synth->getSampleQuality());
+}
+
+void sfz::Sfizz::setNumRenderThreads(int numThreads) noexcept
+{
+    synth->setNumRenderThreads(numThreads);
+}
+
+int sfz::Sfizz::getNumRenderThreads() const noexcept
+{
+    return synth->getNumRenderThreads();
+}
+
 void sfz::Sfizz::setPreloadSize(uint32_t preloadSize) noexcept
 {
     synth->setPreloadSize(preloadSize);
@@ -160,6 +219,31 @@ uint32_t sfz::Sfizz::getPreloadSize() const noexcept
     return synth->getPreloadSize();
 }
 
+void sfz::Sfizz::setPreloadCacheDirectory(const std::string& directory)
+{
+    synth->setPreloadCacheDirectory(directory);
+}
+
+void sfz::Sfizz::setInstrumentCacheDirectory(const std::string& directory)
+{
+    synth->setInstrumentCacheDirectory(directory);
+}
+
+void sfz::Sfizz::setPreloadMemoryBudget(size_t budget) noexcept
+{
+    synth->setPreloadMemoryBudget(budget);
+}
+
+size_t sfz::Sfizz::getPreloadMemoryBudget() const noexcept
+{
+    return synth->getPreloadMemoryBudget();
+}
+
+size_t sfz::Sfizz::getNumColdLoads() const noexcept
+{
+    return synth->getNumColdLoads();
+}
+
 int sfz::Sfizz::getAllocatedBuffers() const noexcept
 {
     return synth->getAllocatedBuffers();
@@ -121,6 +121,31 @@ void sfizz_set_preload_size(sfizz_synth_t* synth, unsigned int preload_size)
     auto self = reinterpret_cast<sfz::Synth*>(synth);
     self->setPreloadSize(preload_size);
 }
+void sfizz_set_preload_cache_directory(sfizz_synth_t* synth, const char* directory)
+{
+    auto self = reinterpret_cast<sfz::Synth*>(synth);
+    self->setPreloadCacheDirectory(directory != nullptr ? directory : "");
+}
+void sfizz_set_instrument_cache_directory(sfizz_synth_t* synth, const char* directory)
+{
+    auto self = reinterpret_cast<sfz::Synth*>(synth);
+    self->setInstrumentCacheDirectory(directory != nullptr ? directory : "");
+}
+void sfizz_set_preload_memory_budget(sfizz_synth_t* synth, size_t budget)
+{
+    auto self = reinterpret_cast<sfz::Synth*>(synth);
+    self->setPreloadMemoryBudget(budget);
+}
+size_t sfizz_get_preload_memory_budget(sfizz_synth_t* synth)
+{
+    auto self = reinterpret_cast<sfz::Synth*>(synth);
+    return self->getPreloadMemoryBudget();
+}
+size_t sfizz_get_num_cold_loads(sfizz_synth_t* synth)
+{
+    auto self = reinterpret_cast<sfz::Synth*>(synth);
+    return self->getNumColdLoads();
+}
 
 sfizz_oversampling_factor_t sfizz_get_oversampling_factor(sfizz_synth_t* synth)
 {
@@ -151,6 +176,71 @@ bool sfizz_set_oversampling_factor(sfizz_synth_t* synth, sfizz_oversampling_fact
     }
 }
 
+sfizz_oversampling_factor_t sfizz_get_render_oversampling_factor(sfizz_synth_t* synth)
+{
+    auto self = reinterpret_cast<sfz::Synth*>(synth);
+    return static_cast<sfizz_oversampling_factor_t>(self->getRenderOversamplingFactor());
+}
+
+bool sfizz_set_render_oversampling_factor(sfizz_synth_t* synth, sfizz_oversampling_factor_t oversampling)
+{
+    auto self = reinterpret_cast<sfz::Synth*>(synth);
+    switch(oversampling)
+    {
+        case SFIZZ_OVERSAMPLING_X1:
+            self->setRenderOversamplingFactor(sfz::Oversampling::x1);
+            return true;
+        case SFIZZ_OVERSAMPLING_X2:
+            self->setRenderOversamplingFactor(sfz::Oversampling::x2);
+            return true;
+        case SFIZZ_OVERSAMPLING_X4:
+            self->setRenderOversamplingFactor(sfz::Oversampling::x4);
+            return true;
+        case SFIZZ_OVERSAMPLING_X8:
+            self->setRenderOversamplingFactor(sfz::Oversampling::x8);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool sfizz_set_sample_quality(sfizz_synth_t* synth, int quality)
+{
+    auto self = reinterpret_cast<sfz::Synth*>(synth);
+    switch(quality)
+    {
+        case 1:
+            self->setSampleQuality(sfz::InterpolationQuality::Linear);
+            return true;
+        case 2:
+            self->setSampleQuality(sfz::InterpolationQuality::Hermite);
+            return true;
+        case 3:
+            self->setSampleQuality(sfz::InterpolationQuality::Sinc);
+            return true;
+        default:
+            return false;
+    }
+}
+
+int sfizz_get_sample_quality(sfizz_synth_t* synth)
+{
+    auto self = reinterpret_cast<sfz::Synth*>(synth);
+    return static_cast<int>(self->getSampleQuality());
+}
+
+void sfizz_set_num_render_threads(sfizz_synth_t* synth, int num_threads)
+{
+    auto self = reinterpret_cast<sfz::Synth*>(synth);
+    self->setNumRenderThreads(num_threads);
+}
+
+int sfizz_get_num_render_threads(sfizz_synth_t* synth)
+{
+    auto self = reinterpret_cast<sfz::Synth*>(synth);
+    return self->getNumRenderThreads();
+}
+
 void sfizz_set_volume(sfizz_synth_t* synth, float volume)
 {
     auto self = reinterpret_cast<sfz::Synth*>(synth);
@@ -192,3 +192,27 @@ TEST_CASE("[ADSREnvelope] Hold with release 2")
     envelope.getBlock(absl::MakeSpan(output));
     REQUIRE(approxEqual<float>(output, expected));
 }
+
+TEST_CASE("[ADSREnvelope] Constant blocks")
+{
+    sfz::ADSREnvelope<float> envelope;
+    sfz::ADSREnvelope<float> reference;
+    envelope.reset(3, 4, 0.5f, 4, 2, 5);
+    reference.reset(3, 4, 0.5f, 4, 2, 5);
+    envelope.startRelease(26);
+    reference.startRelease(26);
+
+    std::array<float, 4> output;
+    std::array<float, 4> expected;
+    int numConstantBlocks { 0 };
+    for (int block = 0; block < 10; ++block) {
+        reference.getBlock(absl::MakeSpan(expected));
+        if (auto value = envelope.getBlockOrConstant(absl::MakeSpan(output))) {
+            absl::c_fill(output, *value);
+            ++numConstantBlocks;
+        }
+        REQUIRE(approxEqual<float>(output, expected));
+    }
+    // The delay, the hold and sustain stages, and the end of the release
+    REQUIRE( numConstantBlocks == 6 );
+}
@@ -387,3 +387,49 @@ TEST_CASE("[MultiplicativeEnvelope] Pitch envelope basic function")
     envelope.getBlock(absl::MakeSpan(output));
     REQUIRE(output[255] == Approx(0.9168).epsilon(0.01));
 }
+
+TEST_CASE("[LinearEnvelope] Constant blocks")
+{
+    sfz::LinearEnvelope<float> envelope;
+    std::array<float, 8> output;
+    auto value = envelope.getBlockOrConstant(absl::MakeSpan(output));
+    REQUIRE( value );
+    REQUIRE( *value == 0.0f );
+
+    // An event to the current value keeps the envelope constant
+    envelope.registerEvent(4, 0.0f);
+    value = envelope.getBlockOrConstant(absl::MakeSpan(output));
+    REQUIRE( value );
+    REQUIRE( *value == 0.0f );
+
+    envelope.registerEvent(4, 1.0f);
+    REQUIRE( !envelope.getBlockOrConstant(absl::MakeSpan(output)) );
+    std::array<float, 8> expected { 0.25f, 0.5f, 0.75f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+    REQUIRE( output == expected );
+
+    value = envelope.getBlockOrConstant(absl::MakeSpan(output));
+    REQUIRE( value );
+    REQUIRE( *value == 1.0f );
+
+    // An event past the block is brought back into it
+    envelope.registerEvent(10, 2.0f);
+    REQUIRE( !envelope.getBlockOrConstant(absl::MakeSpan(output)) );
+    REQUIRE( output.back() == 2.0_a );
+}
+
+TEST_CASE("[MultiplicativeEnvelope] Constant blocks")
+{
+    sfz::MultiplicativeEnvelope<float> envelope;
+    std::array<float, 8> output;
+    auto value = envelope.getBlockOrConstant(absl::MakeSpan(output));
+    REQUIRE( value );
+    REQUIRE( *value == 1.0f );
+
+    envelope.registerEvent(4, 2.0f);
+    REQUIRE( !envelope.getBlockOrConstant(absl::MakeSpan(output)) );
+    REQUIRE( output.back() == 2.0_a );
+
+    value = envelope.getBlockOrConstant(absl::MakeSpan(output));
+    REQUIRE( value );
+    REQUIRE( *value == 2.0_a );
+}
@@ -0,0 +1,519 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "sfizz/FilePool.h"
+#include "sfizz/Logger.h"
+#include "catch2/catch.hpp"
+using namespace Catch::literals;
+
+TEST_CASE("[FilePool] Sample table")
+{
+    sfz::SampleTable sampleTable;
+    const auto snare = sampleTable.intern("snare.wav");
+    const auto kick = sampleTable.intern("kick.wav");
+    REQUIRE( snare != kick );
+    REQUIRE( sampleTable.intern(std::string("snare.wav")) == snare );
+    REQUIRE( sampleTable.getPath(snare) == "snare.wav" );
+    REQUIRE( sampleTable.getPath(kick) == "kick.wav" );
+    REQUIRE( sampleTable.size() == 2 );
+
+    // Moving the table keeps the paths in place
+    const auto* path = &sampleTable.getPath(kick);
+    auto movedTable = std::move(sampleTable);
+    REQUIRE( &movedTable.getPath(kick) == path );
+    REQUIRE( movedTable.intern("kick.wav") == kick );
+}
+
+TEST_CASE("[FilePool] Promises on the same sample share their file data")
+{
+    sfz::Logger logger;
+    sfz::SampleTable sampleTable;
+    sfz::FilePool filePool { logger, sampleTable };
+    filePool.setRootDirectory(fs::current_path() / "tests/TestFiles");
+    // Short enough to be loaded whole rather than streamed
+    filePool.setPreloadSize(16384);
+    const auto sample = sampleTable.intern("snare.wav");
+    REQUIRE( filePool.preloadFile(sample, 0) );
+
+    auto promise1 = filePool.getFilePromise(sample);
+    auto promise2 = filePool.getFilePromise(sample);
+    REQUIRE( promise1 != nullptr );
+    REQUIRE( promise2 != nullptr );
+    REQUIRE( promise1 != promise2 );
+    REQUIRE( promise1->fileData != nullptr );
+    REQUIRE( promise1->fileData == promise2->fileData );
+    REQUIRE( promise1->fileData->readerCount == 2 );
+
+    filePool.waitForBackgroundLoading();
+    const auto fileInformation = filePool.getFileInformation(sampleTable.getPath(sample));
+    REQUIRE( fileInformation );
+    REQUIRE( promise1->getData().getNumFrames() == fileInformation->end + 1 );
+    REQUIRE( promise2->getData().getNumFrames() == fileInformation->end + 1 );
+}
+
+TEST_CASE("[FilePool] Different samples do not share their file data")
+{
+    sfz::Logger logger;
+    sfz::SampleTable sampleTable;
+    sfz::FilePool filePool { logger, sampleTable };
+    filePool.setRootDirectory(fs::current_path() / "tests/TestFiles");
+    filePool.setPreloadSize(16384);
+    const auto snare = sampleTable.intern("snare.wav");
+    const auto kick = sampleTable.intern("kick.wav");
+    REQUIRE( filePool.preloadFile(snare, 0) );
+    REQUIRE( filePool.preloadFile(kick, 0) );
+
+    auto promise1 = filePool.getFilePromise(snare);
+    auto promise2 = filePool.getFilePromise(kick);
+    REQUIRE( promise1 != nullptr );
+    REQUIRE( promise2 != nullptr );
+    REQUIRE( promise1->fileData != promise2->fileData );
+    filePool.waitForBackgroundLoading();
+}
+
+TEST_CASE("[FilePool] Promise deadlines follow the preloaded data left to play")
+{
+    sfz::Logger logger;
+    sfz::SampleTable sampleTable;
+    sfz::FilePool filePool { logger, sampleTable };
+    filePool.setRootDirectory(fs::current_path() / "tests/TestFiles");
+    filePool.setPreloadSize(16384);
+    const auto snare = sampleTable.intern("snare.wav");
+    const auto kick = sampleTable.intern("kick.wav");
+    REQUIRE( filePool.preloadFile(snare, 0) );
+    REQUIRE( filePool.preloadFile(kick, 0) );
+
+    const auto secondsLeft = [](const sfz::FilePromise& promise) {
+        return std::chrono::duration<double>(promise.deadline - promise.creationTime).count();
+    };
+
+    auto promise1 = filePool.getFilePromise(snare, {}, 0, 1.0f);
+    auto promise2 = filePool.getFilePromise(kick, {}, 8192, 2.0f);
+    REQUIRE( promise1 != nullptr );
+    REQUIRE( promise2 != nullptr );
+    REQUIRE( secondsLeft(*promise1) == Approx(16384 / promise1->sampleRate).margin(1e-3) );
+    REQUIRE( secondsLeft(*promise2) == Approx(8192 / (2 * promise2->sampleRate)).margin(1e-3) );
+    REQUIRE( promise2->deadline < promise1->deadline );
+    filePool.waitForBackgroundLoading();
+}
+
+namespace {
+bool streamMatchesFile(const sfz::FileStream& stream, sfz::SampleSpan reference)
+{
+    // Only the last ring-full of frames is still in the ring
+    const uint32_t endPosition = stream.endPosition;
+    const auto firstPosition = max(stream.startPosition, endPosition - sfz::FileStream::ringFrames);
+    bool matches { true };
+    reference.visit([&](auto frames) {
+        for (auto position = firstPosition; position < endPosition; ++position) {
+            const auto ringPosition = (position - stream.startPosition) % sfz::FileStream::ringFrames;
+            const auto filePosition = stream.filePosition(position);
+            for (size_t c = 0; c < frames.getNumChannels(); ++c) {
+                if (stream.ring.getConstSpan(c)[ringPosition] != sampleToFloat(frames.getConstSpan(c)[filePosition]))
+                    matches = false;
+            }
+        }
+    });
+    return matches;
+}
+}
+
+TEST_CASE("[FilePool] Long samples are streamed in a bounded ring")
+{
+    sfz::Logger logger;
+    sfz::SampleTable sampleTable;
+    const auto sample = sampleTable.intern("looped_flute.wav");
+
+    sfz::FilePool referencePool { logger, sampleTable };
+    referencePool.setRootDirectory(fs::current_path() / "tests/TestFiles");
+    referencePool.setPreloadSize(0);
+    REQUIRE( referencePool.preloadFile(sample, 0) );
+    auto reference = referencePool.getFilePromise(sample);
+    REQUIRE( reference != nullptr );
+
+    sfz::FilePool filePool { logger, sampleTable };
+    filePool.setRootDirectory(fs::current_path() / "tests/TestFiles");
+    filePool.setPreloadSize(1024);
+    REQUIRE( filePool.preloadFile(sample, 0) );
+
+    auto promise = filePool.getFilePromise(sample);
+    REQUIRE( promise != nullptr );
+    REQUIRE( promise->streaming );
+    REQUIRE( promise->fileData == nullptr );
+    REQUIRE( promise->stream.startPosition == 1023 );
+
+    filePool.waitForBackgroundLoading();
+    auto& stream = promise->stream;
+    REQUIRE( stream.ring.getNumFrames() == sfz::FileStream::ringFrames );
+    REQUIRE( stream.endPosition == stream.startPosition + sfz::FileStream::ringFrames );
+    REQUIRE( streamMatchesFile(stream, reference->getData()) );
+
+    // The voice consumed a few chunks
+    stream.readPosition = stream.startPosition + 4 * sfz::config::chunkSize;
+    filePool.cleanupPromises();
+    filePool.waitForBackgroundLoading();
+    REQUIRE( stream.endPosition == stream.startPosition + sfz::FileStream::ringFrames + 4 * sfz::config::chunkSize );
+    REQUIRE( streamMatchesFile(stream, reference->getData()) );
+}
+
+TEST_CASE("[FilePool] Streams follow the loop")
+{
+    sfz::Logger logger;
+    sfz::SampleTable sampleTable;
+    const auto sample = sampleTable.intern("looped_flute.wav");
+
+    sfz::FilePool referencePool { logger, sampleTable };
+    referencePool.setRootDirectory(fs::current_path() / "tests/TestFiles");
+    referencePool.setPreloadSize(0);
+    REQUIRE( referencePool.preloadFile(sample, 0) );
+    auto reference = referencePool.getFilePromise(sample);
+    REQUIRE( reference != nullptr );
+
+    sfz::FilePool filePool { logger, sampleTable };
+    filePool.setRootDirectory(fs::current_path() / "tests/TestFiles");
+    filePool.setPreloadSize(1024);
+    REQUIRE( filePool.preloadFile(sample, 0) );
+
+    auto promise = filePool.getFilePromise(sample, sfz::Range<uint32_t>(500, 9999));
+    REQUIRE( promise != nullptr );
+    REQUIRE( promise->streaming );
+    REQUIRE( promise->stream.looping );
+    REQUIRE( promise->stream.filePosition(10000) == 500 );
+
+    filePool.waitForBackgroundLoading();
+    auto& stream = promise->stream;
+    REQUIRE( stream.endPosition == stream.startPosition + sfz::FileStream::ringFrames );
+    REQUIRE( streamMatchesFile(stream, reference->getData()) );
+}
+
+TEST_CASE("[FilePool] Preload many files at once")
+{
+    sfz::Logger logger;
+    sfz::SampleTable sampleTable;
+    sfz::FilePool filePool { logger, sampleTable };
+    filePool.setRootDirectory(fs::current_path() / "tests/TestFiles");
+    filePool.setPreloadSize(1024);
+    std::vector<sfz::SampleId> samples;
+    for (auto name : { "snare.wav", "kick.wav", "missing.wav", "closedhat.wav", "stereo_sample.wav", "mono_sample.wav" })
+        samples.push_back(sampleTable.intern(name));
+    std::vector<sfz::FilePool::PreloadRequest> requests;
+    for (auto sample : samples)
+        requests.push_back({ sample, 0 });
+    requests[1].maxOffset = 2048;
+
+    const auto information = filePool.preloadFiles(requests);
+    REQUIRE( information.size() == samples.size() );
+    REQUIRE( filePool.getNumPreloadedSamples() == samples.size() - 1 );
+    REQUIRE( !information[2] );
+    for (size_t i = 0; i < samples.size(); ++i) {
+        if (i == 2)
+            continue;
+
+        const auto expected = filePool.getFileInformation(sampleTable.getPath(samples[i]));
+        REQUIRE( information[i] );
+        REQUIRE( information[i]->end == expected->end );
+        REQUIRE( information[i]->numChannels == expected->numChannels );
+        REQUIRE( information[i]->sampleRate == expected->sampleRate );
+    }
+    REQUIRE( information[4]->numChannels == 2 );
+
+    auto kick = filePool.getFilePromise(samples[1]);
+    REQUIRE( kick != nullptr );
+    REQUIRE( kick->preloadedData->getNumFrames() == 3072 );
+
+    // Preloading again with a larger offset keeps the same file data
+    const auto fileData = kick->fileData;
+    REQUIRE( filePool.preloadFile(samples[1], 4096) );
+    auto kickAgain = filePool.getFilePromise(samples[1]);
+    REQUIRE( kickAgain->fileData == fileData );
+    REQUIRE( kickAgain->preloadedData->getNumFrames() == 5120 );
+    filePool.waitForBackgroundLoading();
+}
+
+TEST_CASE("[FilePool] Preload cache")
+{
+    const auto testDirectory = fs::temp_directory_path() / "sfizz_preload_cache_test";
+    const auto cacheDirectory = testDirectory / "cache";
+    fs::remove_all(testDirectory);
+    fs::create_directories(testDirectory);
+    fs::copy_file(fs::current_path() / "tests/TestFiles/kick.wav", testDirectory / "sample.wav");
+
+    const auto preload = [&](bool useCache) {
+        sfz::Logger logger;
+        sfz::SampleTable sampleTable;
+        sfz::FilePool filePool { logger, sampleTable };
+        const auto sample = sampleTable.intern("sample.wav");
+        filePool.setRootDirectory(testDirectory);
+        filePool.setPreloadSize(1024);
+        if (useCache)
+            filePool.setPreloadCacheDirectory(cacheDirectory);
+        const sfz::FilePool::PreloadRequest request { sample, 100 };
+        auto information = filePool.preloadFiles({ &request, 1 }).front();
+        auto promise = filePool.getFilePromise(sample);
+        REQUIRE( information );
+        REQUIRE( promise != nullptr );
+        auto data = promise->preloadedData;
+        filePool.waitForBackgroundLoading();
+        return std::make_pair(*information, data);
+    };
+
+    const auto reference = preload(false);
+    REQUIRE( !fs::exists(cacheDirectory) );
+    const auto first = preload(true);
+    REQUIRE( std::distance(fs::directory_iterator(cacheDirectory), fs::directory_iterator()) == 1 );
+    const auto second = preload(true);
+
+    for (const auto* result : { &first, &second }) {
+        REQUIRE( result->first.end == reference.first.end );
+        REQUIRE( result->first.numChannels == reference.first.numChannels );
+        REQUIRE( result->first.sampleRate == reference.first.sampleRate );
+        REQUIRE( result->second->getNumFrames() == reference.second->getNumFrames() );
+        REQUIRE( result->second->getNumChannels() == reference.second->getNumChannels() );
+        REQUIRE( result->second->getFormat() == reference.second->getFormat() );
+        const auto size = reference.second->getNumFrames() * reference.second->getSampleSize();
+        for (size_t channel = 0; channel < reference.second->getNumChannels(); ++channel) {
+            const auto* expected = reference.second->channelBytes(channel);
+            const auto* actual = result->second->channelBytes(channel);
+            REQUIRE( std::equal(expected, expected + size, actual) );
+        }
+    }
+
+    // Replacing the sample invalidates its entry
+    fs::copy_file(fs::current_path() / "tests/TestFiles/snare.wav", testDirectory / "sample.wav",
+        fs::copy_options::overwrite_existing);
+    const auto replaced = preload(true);
+    sfz::Logger logger;
+    sfz::SampleTable sampleTable;
+    sfz::FilePool filePool { logger, sampleTable };
+    filePool.setRootDirectory(fs::current_path() / "tests/TestFiles");
+    REQUIRE( replaced.first.end == filePool.getFileInformation("snare.wav")->end );
+    fs::remove_all(testDirectory);
+}
+
+TEST_CASE("[FilePool] Retain the preloaded files still in use")
+{
+    sfz::Logger logger;
+    sfz::SampleTable sampleTable;
+    sfz::FilePool filePool { logger, sampleTable };
+    filePool.setRootDirectory(fs::current_path() / "tests/TestFiles");
+    filePool.setPreloadSize(1024);
+    const auto snare = sampleTable.intern("snare.wav");
+    const auto kick = sampleTable.intern("kick.wav");
+    REQUIRE( filePool.preloadFile(snare, 0) );
+    REQUIRE( filePool.preloadFile(kick, 0) );
+    auto promise = filePool.getFilePromise(snare);
+    REQUIRE( promise != nullptr );
+    const auto preloadedData = promise->preloadedData;
+    const auto fileData = promise->fileData;
+    promise.reset();
+    filePool.waitForBackgroundLoading();
+
+    // The instrument is reloaded with a new sample table, where the snare
+    // has another identifier
+    const auto previousSampleTable = std::move(sampleTable);
+    sampleTable.clear();
+    const auto closedhat = sampleTable.intern("closedhat.wav");
+    const auto newSnare = sampleTable.intern("snare.wav");
+    REQUIRE( newSnare != snare );
+    std::vector<sfz::FilePool::PreloadRequest> requests { { newSnare, 0 }, { closedhat, 0 } };
+
+    auto information = filePool.retainPreloadedFiles(requests);
+    REQUIRE( information.size() == 2 );
+    REQUIRE( information[0] );
+    REQUIRE( information[0]->end == filePool.getFileInformation("snare.wav")->end );
+    REQUIRE( !information[1] );
+    REQUIRE( filePool.getNumPreloadedSamples() == 1 );
+    promise = filePool.getFilePromise(newSnare);
+    REQUIRE( promise != nullptr );
+    REQUIRE( promise->filename == "snare.wav" );
+    REQUIRE( promise->preloadedData == preloadedData );
+    REQUIRE( promise->fileData == fileData );
+    REQUIRE( filePool.getFilePromise(closedhat) == nullptr );
+
+    // A larger offset needs the file to be preloaded again
+    requests[0].maxOffset = 4096;
+    information = filePool.retainPreloadedFiles(requests);
+    REQUIRE( !information[0] );
+    REQUIRE( filePool.getNumPreloadedSamples() == 0 );
+    filePool.waitForBackgroundLoading();
+}
+
+TEST_CASE("[FilePool] Emptying the queues leaves the file data loadable")
+{
+    sfz::Logger logger;
+    sfz::SampleTable sampleTable;
+    sfz::FilePool filePool { logger, sampleTable };
+    filePool.setRootDirectory(fs::current_path() / "tests/TestFiles");
+    filePool.setPreloadSize(16384);
+    const auto sample = sampleTable.intern("snare.wav");
+    REQUIRE( filePool.preloadFile(sample, 0) );
+    const auto numFrames = filePool.getFileInformation("snare.wav")->end + 1;
+
+    // The queue is emptied before or after the promise is loaded, as it
+    // happens when an instrument is reloaded
+    for (int i = 0; i < 20; ++i) {
+        auto promise = filePool.getFilePromise(sample);
+        REQUIRE( promise != nullptr );
+        filePool.emptyFileLoadingQueues();
+        filePool.waitForBackgroundLoading();
+        const auto status = promise->fileData->status.load();
+        REQUIRE( (status == sfz::FileData::Status::Ready || status == sfz::FileData::Status::Unloaded) );
+        // The pool gets the promise back either way
+        filePool.cleanupPromises();
+        REQUIRE( promise.use_count() > 1 );
+        promise.reset();
+        filePool.cleanupPromises();
+        filePool.waitForBackgroundLoading();
+    }
+
+    auto promise = filePool.getFilePromise(sample);
+    REQUIRE( promise != nullptr );
+    filePool.waitForBackgroundLoading();
+    REQUIRE( promise->getData().getNumFrames() == numFrames );
+}
+
+TEST_CASE("[FilePool] Evict the least recently used preloads")
+{
+    sfz::Logger logger;
+    sfz::SampleTable sampleTable;
+    const auto snare = sampleTable.intern("snare.wav");
+    const auto kick = sampleTable.intern("kick.wav");
+
+    sfz::FilePool referencePool { logger, sampleTable };
+    referencePool.setRootDirectory(fs::current_path() / "tests/TestFiles");
+    referencePool.setPreloadSize(0);
+    REQUIRE( referencePool.preloadFile(kick, 0) );
+    auto reference = referencePool.getFilePromise(kick);
+    REQUIRE( reference != nullptr );
+
+    sfz::FilePool filePool { logger, sampleTable };
+    filePool.setRootDirectory(fs::current_path() / "tests/TestFiles");
+    filePool.setPreloadSize(1024);
+    REQUIRE( filePool.preloadFile(snare, 0) );
+    REQUIRE( filePool.preloadFile(kick, 0) );
+    const auto totalBytes = filePool.getPreloadedBytes();
+    REQUIRE( filePool.getFilePromise(snare) != nullptr );
+
+    // Only one of the preloads fits in the budget, and the kick was not played
+    filePool.setMemoryBudget(totalBytes - 1);
+    REQUIRE( filePool.getPreloadedBytes() > 0 );
+    REQUIRE( filePool.getPreloadedBytes() < totalBytes );
+    REQUIRE( filePool.getNumColdLoads() == 0 );
+    REQUIRE( filePool.getFilePromise(snare)->preloadedData->getNumFrames() == 1024 );
+
+    auto promise = filePool.getFilePromise(kick);
+    REQUIRE( promise != nullptr );
+    REQUIRE( promise->streaming );
+    REQUIRE( promise->stream.startPosition == 0 );
+    REQUIRE( promise->preloadedData->getNumFrames() == 0 );
+    REQUIRE( promise->preloadedData->getNumChannels() == reference->getData().getNumChannels() );
+    REQUIRE( filePool.getNumColdLoads() == 1 );
+    filePool.waitForBackgroundLoading();
+    REQUIRE( promise->stream.endPosition > 0 );
+    REQUIRE( streamMatchesFile(promise->stream, reference->getData()) );
+
+    // The kick was played last, so it takes the place of the snare
+    filePool.setMemoryBudget(totalBytes - 1);
+    REQUIRE( filePool.getPreloadedBytes() < totalBytes );
+    promise = filePool.getFilePromise(kick);
+    REQUIRE( promise != nullptr );
+    REQUIRE( promise->preloadedData->getNumFrames() == 1024 );
+    REQUIRE( filePool.getNumColdLoads() == 1 );
+    promise = filePool.getFilePromise(snare);
+    REQUIRE( promise != nullptr );
+    REQUIRE( promise->streaming );
+    REQUIRE( promise->stream.startPosition == 0 );
+    REQUIRE( filePool.getNumColdLoads() == 2 );
+
+    // Without a budget, the next preloads are kept
+    filePool.setMemoryBudget(0);
+    filePool.setPreloadSize(1024);
+    REQUIRE( filePool.getPreloadedBytes() == totalBytes );
+    filePool.waitForBackgroundLoading();
+}
+
+TEST_CASE("[FilePool] Promises are honored while the preloads are evicted")
+{
+    sfz::Logger logger;
+    sfz::SampleTable sampleTable;
+    const auto snare = sampleTable.intern("snare.wav");
+    const auto kick = sampleTable.intern("kick.wav");
+    sfz::FilePool filePool { logger, sampleTable };
+    filePool.setRootDirectory(fs::current_path() / "tests/TestFiles");
+    filePool.setPreloadSize(1024);
+    REQUIRE( filePool.preloadFile(snare, 0) );
+    REQUIRE( filePool.preloadFile(kick, 0) );
+    const auto totalBytes = filePool.getPreloadedBytes();
+
+    std::atomic<bool> playing { true };
+    std::thread budgetThread { [&]() {
+        while (playing) {
+            filePool.setMemoryBudget(1);
+            filePool.setMemoryBudget(totalBytes);
+        }
+    } };
+
+    std::vector<sfz::FilePromisePtr> promises;
+    for (int i = 0; i < 200; ++i) {
+        promises.push_back(filePool.getFilePromise(i % 2 == 0 ? snare : kick));
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+    }
+    playing = false;
+    budgetThread.join();
+    filePool.waitForBackgroundLoading();
+
+    for (const auto& promise : promises) {
+        REQUIRE( promise != nullptr );
+        REQUIRE( promise->preloadedData != nullptr );
+        REQUIRE( promise->preloadedData->getNumChannels() > 0 );
+    }
+}
+
+TEST_CASE("[FilePool] 16-bit samples are preloaded in their own width")
+{
+    sfz::Logger logger;
+    sfz::SampleTable sampleTable;
+    sfz::FilePool filePool { logger, sampleTable };
+    filePool.setRootDirectory(fs::current_path() / "tests/TestFiles");
+    filePool.setPreloadSize(1024);
+    const auto compactSample = sampleTable.intern("looped_flute.wav");
+    const auto floatSample = sampleTable.intern("stereo_sample.wav");
+    REQUIRE( filePool.preloadFile(compactSample, 0) );
+    REQUIRE( filePool.preloadFile(floatSample, 0) );
+
+    auto compactPromise = filePool.getFilePromise(compactSample);
+    REQUIRE( compactPromise != nullptr );
+    REQUIRE( compactPromise->preloadedData->getFormat() == sfz::SampleFormat::Int16 );
+    REQUIRE( compactPromise->preloadedData->getNumChannels() == 2 );
+    REQUIRE( compactPromise->preloadedData->getNumBytes() == 2 * 1024 * sizeof(int16_t) );
+    auto floatPromise = filePool.getFilePromise(floatSample);
+    REQUIRE( floatPromise != nullptr );
+    REQUIRE( floatPromise->preloadedData->getFormat() == sfz::SampleFormat::Float );
+
+    // The preloaded data matches the file read as float
+    fs::path file { fs::current_path() / "tests/TestFiles" / sampleTable.getPath(compactSample) };
+    SndfileHandle sndFile(file.string().c_str());
+    std::vector<float> reference (2 * 1024);
+    REQUIRE( sndFile.readf(reference.data(), 1024) == 1024 );
+    auto preloaded = compactPromise->getData();
+    REQUIRE( preloaded.getFormat() == sfz::SampleFormat::Int16 );
+    bool matches { true };
+    preloaded.visit([&](auto frames) {
+        for (size_t i = 0; i < 1024; ++i) {
+            for (size_t c = 0; c < 2; ++c) {
+                if (sampleToFloat(frames.getConstSpan(c)[i]) != reference[2 * i + c])
+                    matches = false;
+            }
+        }
+    });
+    REQUIRE( matches );
+    filePool.waitForBackgroundLoading();
+
+    // Oversampled samples are kept as float
+    filePool.setOversamplingFactor(sfz::Oversampling::x2);
+    REQUIRE( filePool.getFilePromise(compactSample)->preloadedData->getFormat() == sfz::SampleFormat::Float );
+    filePool.waitForBackgroundLoading();
+}
@@ -14,7 +14,7 @@ TEST_CASE("[Files] Single region (regions_one.sfz)")
     sfz::Synth synth;
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/Regions/regions_one.sfz");
     REQUIRE(synth.getNumRegions() == 1);
-    REQUIRE(synth.getRegionView(0)->sample == "dummy.wav");
+    REQUIRE(synth.getRegionView(0)->getSample() == "dummy.wav");
 }
 
 
@@ -23,9 +23,9 @@ TEST_CASE("[Files] Multiple regions (regions_many.sfz)")
     sfz::Synth synth;
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/Regions/regions_many.sfz");
     REQUIRE(synth.getNumRegions() == 3);
-    REQUIRE(synth.getRegionView(0)->sample == "dummy.wav");
-    REQUIRE(synth.getRegionView(1)->sample == "dummy.1.wav");
-    REQUIRE(synth.getRegionView(2)->sample == "dummy.2.wav");
+    REQUIRE(synth.getRegionView(0)->getSample() == "dummy.wav");
+    REQUIRE(synth.getRegionView(1)->getSample() == "dummy.1.wav");
+    REQUIRE(synth.getRegionView(2)->getSample() == "dummy.2.wav");
 }
 
 TEST_CASE("[Files] Basic opcodes (regions_opcodes.sfz)")
@@ -49,8 +49,8 @@ TEST_CASE("[Files] (regions_bad.sfz)")
     sfz::Synth synth;
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/Regions/regions_bad.sfz");
     REQUIRE(synth.getNumRegions() == 2);
-    REQUIRE(synth.getRegionView(0)->sample == "dummy.wav");
-    REQUIRE(synth.getRegionView(1)->sample == "dummy.wav");
+    REQUIRE(synth.getRegionView(0)->getSample() == "dummy.wav");
+    REQUIRE(synth.getRegionView(1)->getSample() == "dummy.wav");
 }
 
 TEST_CASE("[Files] Local include")
@@ -58,7 +58,7 @@ TEST_CASE("[Files] Local include")
     sfz::Synth synth;
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/Includes/root_local.sfz");
     REQUIRE(synth.getNumRegions() == 1);
-    REQUIRE(synth.getRegionView(0)->sample == "dummy.wav");
+    REQUIRE(synth.getRegionView(0)->getSample() == "dummy.wav");
 }
 
 TEST_CASE("[Files] Multiple includes")
@@ -66,8 +66,8 @@ TEST_CASE("[Files] Multiple includes")
     sfz::Synth synth;
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/Includes/multiple_includes.sfz");
     REQUIRE(synth.getNumRegions() == 2);
-    REQUIRE(synth.getRegionView(0)->sample == "dummy.wav");
-    REQUIRE(synth.getRegionView(1)->sample == "dummy2.wav");
+    REQUIRE(synth.getRegionView(0)->getSample() == "dummy.wav");
+    REQUIRE(synth.getRegionView(1)->getSample() == "dummy2.wav");
 }
 
 TEST_CASE("[Files] Multiple includes with comments")
@@ -75,8 +75,8 @@ TEST_CASE("[Files] Multiple includes with comments")
     sfz::Synth synth;
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/Includes/multiple_includes_with_comments.sfz");
     REQUIRE(synth.getNumRegions() == 2);
-    REQUIRE(synth.getRegionView(0)->sample == "dummy.wav");
-    REQUIRE(synth.getRegionView(1)->sample == "dummy2.wav");
+    REQUIRE(synth.getRegionView(0)->getSample() == "dummy.wav");
+    REQUIRE(synth.getRegionView(1)->getSample() == "dummy2.wav");
 }
 
 TEST_CASE("[Files] Subdir include")
@@ -84,7 +84,7 @@ TEST_CASE("[Files] Subdir include")
     sfz::Synth synth;
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/Includes/root_subdir.sfz");
     REQUIRE(synth.getNumRegions() == 1);
-    REQUIRE(synth.getRegionView(0)->sample == "dummy_subdir.wav");
+    REQUIRE(synth.getRegionView(0)->getSample() == "dummy_subdir.wav");
 }
 
 TEST_CASE("[Files] Subdir include Win")
@@ -92,7 +92,7 @@ TEST_CASE("[Files] Subdir include Win")
     sfz::Synth synth;
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/Includes/root_subdir_win.sfz");
     REQUIRE(synth.getNumRegions() == 1);
-    REQUIRE(synth.getRegionView(0)->sample == "dummy_subdir.wav");
+    REQUIRE(synth.getRegionView(0)->getSample() == "dummy_subdir.wav");
 }
 
 TEST_CASE("[Files] Recursive include (with include guard)")
@@ -101,8 +101,8 @@ TEST_CASE("[Files] Recursive include (with include guard)")
     synth.enableRecursiveIncludeGuard();
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/Includes/root_recursive.sfz");
     REQUIRE(synth.getNumRegions() == 2);
-    REQUIRE(synth.getRegionView(0)->sample == "dummy_recursive2.wav");
-    REQUIRE(synth.getRegionView(1)->sample == "dummy_recursive1.wav");
+    REQUIRE(synth.getRegionView(0)->getSample() == "dummy_recursive2.wav");
+    REQUIRE(synth.getRegionView(1)->getSample() == "dummy_recursive1.wav");
 }
 
 TEST_CASE("[Files] Include loops (with include guard)")
@@ -111,8 +111,8 @@ TEST_CASE("[Files] Include loops (with include guard)")
     synth.enableRecursiveIncludeGuard();
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/Includes/root_loop.sfz");
     REQUIRE(synth.getNumRegions() == 2);
-    REQUIRE(synth.getRegionView(0)->sample == "dummy_loop2.wav");
-    REQUIRE(synth.getRegionView(1)->sample == "dummy_loop1.wav");
+    REQUIRE(synth.getRegionView(0)->getSample() == "dummy_loop2.wav");
+    REQUIRE(synth.getRegionView(1)->getSample() == "dummy_loop1.wav");
 }
 
 TEST_CASE("[Files] Define test")
@@ -126,6 +126,21 @@ TEST_CASE("[Files] Define test")
     REQUIRE(synth.getRegionView(3)->volume == -12.0f);
 }
 
+TEST_CASE("[Files] Headers and opcodes across lines")
+{
+    sfz::Synth synth;
+    synth.loadSfzFile(fs::current_path() / "tests/TestFiles/headers_across_lines.sfz");
+    REQUIRE(synth.getNumRegions() == 3);
+    REQUIRE(synth.getRegionView(0)->getSample() == "kick.wav");
+    REQUIRE(synth.getRegionView(0)->keyRange == sfz::Range<uint8_t>(36, 38));
+    REQUIRE(synth.getRegionView(0)->volume == -6.0f);
+    REQUIRE(synth.getRegionView(1)->getSample() == "snare.wav");
+    REQUIRE(synth.getRegionView(1)->keyRange == sfz::Range<uint8_t>(38, 38));
+    REQUIRE(synth.getRegionView(1)->pan == 36.0f);
+    REQUIRE(synth.getRegionView(2)->getSample() == "*sine");
+    REQUIRE(synth.getRegionView(2)->keyRange == sfz::Range<uint8_t>(36, 38));
+}
+
 TEST_CASE("[Files] Group from AVL")
 {
     sfz::Synth synth;
@@ -198,31 +213,42 @@ TEST_CASE("[Files] Full hierarchy with antislashes")
         sfz::Synth synth;
         synth.loadSfzFile(fs::current_path() / "tests/TestFiles/basic_hierarchy.sfz");
         REQUIRE(synth.getNumRegions() == 8);
-        REQUIRE(synth.getRegionView(0)->sample == "Regions/dummy.wav");
-        REQUIRE(synth.getRegionView(1)->sample == "Regions/dummy.1.wav");
-        REQUIRE(synth.getRegionView(2)->sample == "Regions/dummy.wav");
-        REQUIRE(synth.getRegionView(3)->sample == "Regions/dummy.1.wav");
-        REQUIRE(synth.getRegionView(4)->sample == "Regions/dummy.wav");
-        REQUIRE(synth.getRegionView(5)->sample == "Regions/dummy.1.wav");
-        REQUIRE(synth.getRegionView(6)->sample == "Regions/dummy.wav");
-        REQUIRE(synth.getRegionView(7)->sample == "Regions/dummy.1.wav");
+        REQUIRE(synth.getRegionView(0)->getSample() == "Regions/dummy.wav");
+        REQUIRE(synth.getRegionView(1)->getSample() == "Regions/dummy.1.wav");
+        REQUIRE(synth.getRegionView(2)->getSample() == "Regions/dummy.wav");
+        REQUIRE(synth.getRegionView(3)->getSample() == "Regions/dummy.1.wav");
+        REQUIRE(synth.getRegionView(4)->getSample() == "Regions/dummy.wav");
+        REQUIRE(synth.getRegionView(5)->getSample() == "Regions/dummy.1.wav");
+        REQUIRE(synth.getRegionView(6)->getSample() == "Regions/dummy.wav");
+        REQUIRE(synth.getRegionView(7)->getSample() == "Regions/dummy.1.wav");
     }
 
     {
         sfz::Synth synth;
         synth.loadSfzFile(fs::current_path() / "tests/TestFiles/basic_hierarchy_antislash.sfz");
         REQUIRE(synth.getNumRegions() == 8);
-        REQUIRE(synth.getRegionView(0)->sample == "Regions/dummy.wav");
-        REQUIRE(synth.getRegionView(1)->sample == "Regions/dummy.1.wav");
-        REQUIRE(synth.getRegionView(2)->sample == "Regions/dummy.wav");
-        REQUIRE(synth.getRegionView(3)->sample == "Regions/dummy.1.wav");
-        REQUIRE(synth.getRegionView(4)->sample == "Regions/dummy.wav");
-        REQUIRE(synth.getRegionView(5)->sample == "Regions/dummy.1.wav");
-        REQUIRE(synth.getRegionView(6)->sample == "Regions/dummy.wav");
-        REQUIRE(synth.getRegionView(7)->sample == "Regions/dummy.1.wav");
+        REQUIRE(synth.getRegionView(0)->getSample() == "Regions/dummy.wav");
+        REQUIRE(synth.getRegionView(1)->getSample() == "Regions/dummy.1.wav");
+        REQUIRE(synth.getRegionView(2)->getSample() == "Regions/dummy.wav");
+        REQUIRE(synth.getRegionView(3)->getSample() == "Regions/dummy.1.wav");
+        REQUIRE(synth.getRegionView(4)->getSample() == "Regions/dummy.wav");
+        REQUIRE(synth.getRegionView(5)->getSample() == "Regions/dummy.1.wav");
+        REQUIRE(synth.getRegionView(6)->getSample() == "Regions/dummy.wav");
+        REQUIRE(synth.getRegionView(7)->getSample() == "Regions/dummy.1.wav");
     }
 }
 
+TEST_CASE("[Files] Regions share their sample paths")
+{
+    sfz::Synth synth;
+    synth.loadSfzFile(fs::current_path() / "tests/TestFiles/basic_hierarchy.sfz");
+    REQUIRE(synth.getNumRegions() == 8);
+    REQUIRE(synth.getRegionView(0)->sampleId != synth.getRegionView(1)->sampleId);
+    for (int i = 2; i < 8; ++i)
+        REQUIRE(synth.getRegionView(i)->sampleId == synth.getRegionView(i % 2)->sampleId);
+    REQUIRE(synth.getRegionsMemoryUsage() >= 8 * sizeof(sfz::Region));
+}
+
 TEST_CASE("[Files] Pizz basic")
 {
     sfz::Synth synth;
@@ -238,10 +264,10 @@ TEST_CASE("[Files] Pizz basic")
     REQUIRE(synth.getRegionView(1)->randRange == sfz::Range<float>(0.25, 0.5));
     REQUIRE(synth.getRegionView(2)->randRange == sfz::Range<float>(0.5, 0.75));
     REQUIRE(synth.getRegionView(3)->randRange == sfz::Range<float>(0.75, 1.0));
-    REQUIRE(synth.getRegionView(0)->sample == R"(../Samples/pizz/a0_vl4_rr1.wav)");
-    REQUIRE(synth.getRegionView(1)->sample == R"(../Samples/pizz/a0_vl4_rr2.wav)");
-    REQUIRE(synth.getRegionView(2)->sample == R"(../Samples/pizz/a0_vl4_rr3.wav)");
-    REQUIRE(synth.getRegionView(3)->sample == R"(../Samples/pizz/a0_vl4_rr4.wav)");
+    REQUIRE(synth.getRegionView(0)->getSample() == R"(../Samples/pizz/a0_vl4_rr1.wav)");
+    REQUIRE(synth.getRegionView(1)->getSample() == R"(../Samples/pizz/a0_vl4_rr2.wav)");
+    REQUIRE(synth.getRegionView(2)->getSample() == R"(../Samples/pizz/a0_vl4_rr3.wav)");
+    REQUIRE(synth.getRegionView(3)->getSample() == R"(../Samples/pizz/a0_vl4_rr4.wav)");
 }
 
 TEST_CASE("[Files] Channels (channels.sfz)")
@@ -249,9 +275,9 @@ TEST_CASE("[Files] Channels (channels.sfz)")
     sfz::Synth synth;
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/channels.sfz");
     REQUIRE(synth.getNumRegions() == 2);
-    REQUIRE(synth.getRegionView(0)->sample == "mono_sample.wav");
+    REQUIRE(synth.getRegionView(0)->getSample() == "mono_sample.wav");
     REQUIRE(!synth.getRegionView(0)->isStereo);
-    REQUIRE(synth.getRegionView(1)->sample == "stereo_sample.wav");
+    REQUIRE(synth.getRegionView(1)->getSample() == "stereo_sample.wav");
     REQUIRE(synth.getRegionView(1)->isStereo);
 }
 
@@ -315,7 +341,7 @@ TEST_CASE("[Files] Specific bug: relative path with backslashes")
     sfz::Synth synth;
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/SpecificBugs/win_backslashes.sfz");
     REQUIRE(synth.getNumRegions() == 1);
-    REQUIRE(synth.getRegionView(0)->sample == R"(Xylo/Subfolder/closedhat.wav)");
+    REQUIRE(synth.getRegionView(0)->getSample() == R"(Xylo/Subfolder/closedhat.wav)");
 }
 
 TEST_CASE("[Files] Default path")
@@ -323,10 +349,10 @@ TEST_CASE("[Files] Default path")
     sfz::Synth synth;
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/default_path.sfz");
     REQUIRE(synth.getNumRegions() == 4);
-    REQUIRE(synth.getRegionView(0)->sample == R"(DefaultPath/SubPath1/sample1.wav)");
-    REQUIRE(synth.getRegionView(1)->sample == R"(DefaultPath/SubPath2/sample2.wav)");
-    REQUIRE(synth.getRegionView(2)->sample == R"(DefaultPath/SubPath1/sample1.wav)");
-    REQUIRE(synth.getRegionView(3)->sample == R"(DefaultPath/SubPath2/sample2.wav)");
+    REQUIRE(synth.getRegionView(0)->getSample() == R"(DefaultPath/SubPath1/sample1.wav)");
+    REQUIRE(synth.getRegionView(1)->getSample() == R"(DefaultPath/SubPath2/sample2.wav)");
+    REQUIRE(synth.getRegionView(2)->getSample() == R"(DefaultPath/SubPath1/sample1.wav)");
+    REQUIRE(synth.getRegionView(3)->getSample() == R"(DefaultPath/SubPath2/sample2.wav)");
 }
 
 TEST_CASE("[Files] Default path reset when calling loadSfzFile again")
@@ -336,7 +362,7 @@ TEST_CASE("[Files] Default path reset when calling loadSfzFile again")
     REQUIRE(synth.getNumRegions() == 4);
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/default_path_reset.sfz");
     REQUIRE(synth.getNumRegions() == 1);
-    REQUIRE(synth.getRegionView(0)->sample == R"(DefaultPath/SubPath2/sample2.wav)");
+    REQUIRE(synth.getRegionView(0)->getSample() == R"(DefaultPath/SubPath2/sample2.wav)");
 }
 
 TEST_CASE("[Files] Default path is ignored for generators")
@@ -344,7 +370,7 @@ TEST_CASE("[Files] Default path is ignored for generators")
     sfz::Synth synth;
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/default_path_generator.sfz");
     REQUIRE(synth.getNumRegions() == 1);
-    REQUIRE(synth.getRegionView(0)->sample == R"(*sine)");
+    REQUIRE(synth.getRegionView(0)->getSample() == R"(*sine)");
 }
 
 TEST_CASE("[Files] Set CC applies properly")
@@ -490,9 +516,28 @@ TEST_CASE("[Files] Case sentitiveness")
     sfz::Synth synth;
     synth.loadSfzFile(fs::current_path() / "tests/TestFiles/case_insensitive.sfz");
     REQUIRE(synth.getNumRegions() == 4);
-    REQUIRE(synth.getRegionView(0)->sample == "dummy1.wav");
-    REQUIRE(synth.getRegionView(1)->sample == "Regions/dummy.wav");
-    REQUIRE(synth.getRegionView(2)->sample == "Regions/dummy.wav");
-    REQUIRE(synth.getRegionView(3)->sample == "Regions/dummy.wav");
+    REQUIRE(synth.getRegionView(0)->getSample() == "dummy1.wav");
+    REQUIRE(synth.getRegionView(1)->getSample() == "Regions/dummy.wav");
+    REQUIRE(synth.getRegionView(2)->getSample() == "Regions/dummy.wav");
+    REQUIRE(synth.getRegionView(3)->getSample() == "Regions/dummy.wav");
 #endif
 }
+
+TEST_CASE("[Files] Reloading keeps the samples still in use")
+{
+    sfz::Synth synth;
+    synth.loadSfzFile(fs::current_path() / "tests/TestFiles/Regions/regions_many.sfz");
+    REQUIRE(synth.getNumRegions() == 3);
+    REQUIRE(synth.getNumPreloadedSamples() == 3);
+    synth.loadSfzFile(fs::current_path() / "tests/TestFiles/Regions/regions_one.sfz");
+    REQUIRE(synth.getNumRegions() == 1);
+    REQUIRE(synth.getRegionView(0)->getSample() == "dummy.wav");
+    REQUIRE(synth.getNumPreloadedSamples() == 1);
+    synth.loadSfzFile(fs::current_path() / "tests/TestFiles/Regions/regions_many.sfz");
+    REQUIRE(synth.getNumRegions() == 3);
+    REQUIRE(synth.getNumPreloadedSamples() == 3);
+    synth.loadSfzFile(fs::current_path() / "tests/TestFiles/looped_regions.sfz");
+    REQUIRE(synth.getNumPreloadedSamples() == 1);
+    REQUIRE(!synth.loadSfzFile(fs::current_path() / "tests/TestFiles/Regions/missing.sfz"));
+    REQUIRE(synth.getNumPreloadedSamples() == 0);
+}
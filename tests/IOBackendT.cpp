@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "sfizz/IOBackend.h"
+#include "sfizz/PCMFile.h"
+#include "sfizz/AudioBuffer.h"
+#include "catch2/catch.hpp"
+#include "ghc/fs_std.hpp"
+#include <sndfile.hh>
+#include <cerrno>
+#include <limits>
+#include <vector>
+using namespace Catch::literals;
+
+namespace {
+sfz::AudioBuffer<float> readWithSndfile(const fs::path& file)
+{
+    SndfileHandle sndFile(file.string().c_str());
+    const auto numChannels = static_cast<size_t>(sndFile.channels());
+    const auto numFrames = static_cast<size_t>(sndFile.frames());
+    std::vector<float> interleaved(numChannels * numFrames);
+    sndFile.readf(interleaved.data(), static_cast<sf_count_t>(numFrames));
+
+    sfz::AudioBuffer<float> output { numChannels, numFrames };
+    for (size_t frame = 0; frame < numFrames; ++frame)
+        for (size_t channel = 0; channel < numChannels; ++channel)
+            output.getSample(channel, frame) = interleaved[frame * numChannels + channel];
+    return output;
+}
+
+bool readsLikeSndfile(sfz::IOBackend& backend, const fs::path& file, uint32_t chunkFrames)
+{
+    const auto layout = sfz::readPCMLayout(file);
+    if (!layout)
+        return false;
+
+    sfz::ReadableFile readable { file };
+    if (!readable)
+        return false;
+
+    std::vector<uint32_t> firstFrames;
+    for (uint32_t frame = 0; frame < layout->numFrames; frame += chunkFrames)
+        firstFrames.push_back(frame);
+
+    std::vector<std::vector<uint8_t>> buffers;
+    std::vector<sfz::ReadRequest> requests;
+    for (auto frame : firstFrames) {
+        const auto numFrames = std::min(chunkFrames, layout->numFrames - frame);
+        buffers.emplace_back(numFrames * layout->bytesPerFrame);
+        requests.push_back({ readable.descriptor(), layout->byteOffset(frame),
+            static_cast<uint32_t>(buffers.back().size()), buffers.back().data() });
+    }
+
+    sfz::AudioBuffer<float> output { layout->numChannels, layout->numFrames };
+    size_t numCompleted = 0;
+    bool allComplete = true;
+    backend.read(requests, [&](size_t index, int64_t result) {
+        if (result != static_cast<int64_t>(requests[index].size))
+            allComplete = false;
+        sfz::decodePCM(buffers[index], *layout, output, firstFrames[index]);
+        numCompleted++;
+    });
+
+    if (!allComplete || numCompleted != requests.size())
+        return false;
+
+    auto reference = readWithSndfile(file);
+    if (reference.getNumChannels() != output.getNumChannels() || reference.getNumFrames() != output.getNumFrames())
+        return false;
+
+    for (size_t channel = 0; channel < output.getNumChannels(); ++channel)
+        for (size_t frame = 0; frame < output.getNumFrames(); ++frame)
+            if (output.getSample(channel, frame) != reference.getSample(channel, frame))
+                return false;
+
+    return true;
+}
+}
+
+TEST_CASE("[IOBackend] WAV layouts")
+{
+    auto mono = sfz::readPCMLayout(fs::current_path() / "tests/TestFiles/mono_sample.wav");
+    REQUIRE(mono);
+    REQUIRE(mono->numChannels == 1);
+    REQUIRE(mono->dataOffset > 0);
+    REQUIRE(mono->byteOffset(10) == mono->dataOffset + 10 * mono->bytesPerFrame);
+
+    auto stereo = sfz::readPCMLayout(fs::current_path() / "tests/TestFiles/stereo_sample.wav");
+    REQUIRE(stereo);
+    REQUIRE(stereo->numChannels == 2);
+
+    SndfileHandle sndFile((fs::current_path() / "tests/TestFiles/looped_flute.wav").string().c_str());
+    auto flute = sfz::readPCMLayout(fs::current_path() / "tests/TestFiles/looped_flute.wav");
+    REQUIRE(flute);
+    REQUIRE(flute->numFrames == static_cast<uint32_t>(sndFile.frames()));
+    REQUIRE(flute->numChannels == static_cast<uint32_t>(sndFile.channels()));
+
+    REQUIRE(!sfz::readPCMLayout(fs::current_path() / "tests/TestFiles/Regions/regions_one.sfz"));
+    REQUIRE(!sfz::readPCMLayout(fs::current_path() / "tests/TestFiles/missing.wav"));
+}
+
+TEST_CASE("[IOBackend] Blocking reads decode like libsndfile")
+{
+    sfz::BlockingIOBackend backend;
+    REQUIRE(readsLikeSndfile(backend, fs::current_path() / "tests/TestFiles/mono_sample.wav", 1000));
+    REQUIRE(readsLikeSndfile(backend, fs::current_path() / "tests/TestFiles/stereo_sample.wav", 1000));
+    REQUIRE(readsLikeSndfile(backend, fs::current_path() / "tests/TestFiles/looped_flute.wav", 4096));
+}
+
+TEST_CASE("[IOBackend] Default backend decodes like libsndfile")
+{
+    // Many more reads than the io_uring queue depth
+    auto backend = sfz::createIOBackend();
+    REQUIRE(backend);
+    REQUIRE(readsLikeSndfile(*backend, fs::current_path() / "tests/TestFiles/looped_flute.wav", 64));
+    REQUIRE(readsLikeSndfile(*backend, fs::current_path() / "tests/TestFiles/stereo_sample.wav", 7));
+}
+
+#if SFIZZ_IO_URING
+namespace {
+// Fails every io_uring_enter call after a given number of them
+class FailingIOUringBackend : public sfz::IOUringBackend {
+public:
+    using IOUringBackend::setup;
+    int numSuccessfulEnters { 0 };
+protected:
+    int enter(unsigned toSubmit, unsigned minCompletions, unsigned flags) noexcept override
+    {
+        if (numSuccessfulEnters-- > 0)
+            return IOUringBackend::enter(toSubmit, minCompletions, flags);
+
+        errno = EIO;
+        return -1;
+    }
+};
+}
+
+TEST_CASE("[IOBackend] io_uring failures complete the whole batch")
+{
+    const auto file = fs::current_path() / "tests/TestFiles/looped_flute.wav";
+    sfz::ReadableFile readable { file };
+    REQUIRE(readable);
+
+    for (int numSuccessfulEnters : { 0, 1, 3 }) {
+        FailingIOUringBackend backend;
+        if (!backend.setup(4)) {
+            WARN("io_uring is not available");
+            return;
+        }
+
+        constexpr size_t numRequests { 64 };
+        constexpr uint32_t requestSize { 256 };
+        std::vector<std::vector<uint8_t>> buffers(numRequests, std::vector<uint8_t>(requestSize));
+        std::vector<sfz::ReadRequest> requests;
+        for (size_t index = 0; index < numRequests; ++index)
+            requests.push_back({ readable.descriptor(), index * requestSize, requestSize, buffers[index].data() });
+
+        std::vector<int> numCompletions(numRequests, 0);
+        size_t numFailures = 0;
+        backend.numSuccessfulEnters = numSuccessfulEnters;
+        backend.read(requests, [&](size_t index, int64_t result) {
+            REQUIRE(index < numRequests);
+            numCompletions[index]++;
+            if (result < 0)
+                numFailures++;
+        });
+
+        // Every request is completed exactly once, and nothing is left in the
+        // ring for the next batch
+        for (auto count : numCompletions)
+            REQUIRE(count == 1);
+        REQUIRE(numFailures > 0);
+
+        backend.numSuccessfulEnters = std::numeric_limits<int>::max();
+        REQUIRE(readsLikeSndfile(backend, file, 64));
+    }
+}
+#endif
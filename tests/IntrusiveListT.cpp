@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "sfizz/IntrusiveList.h"
+#include "catch2/catch.hpp"
+#include <memory>
+#include <vector>
+
+namespace {
+struct Item {
+    explicit Item(int value) : value(value) {}
+    int value;
+    sfz::IntrusiveList<Item>::Node firstNode { *this };
+    sfz::IntrusiveList<Item>::Node secondNode { *this };
+};
+
+std::vector<int> values(const sfz::IntrusiveList<Item>& list)
+{
+    std::vector<int> result;
+    for (const auto& item : list)
+        result.push_back(item.value);
+    return result;
+}
+}
+
+TEST_CASE("[IntrusiveList] Add and remove items")
+{
+    sfz::IntrusiveList<Item> list;
+    Item one { 1 }, two { 2 }, three { 3 };
+    REQUIRE( list.empty() );
+    list.pushBack(one.firstNode);
+    list.pushBack(two.firstNode);
+    list.pushBack(three.firstNode);
+    REQUIRE( list.size() == 3 );
+    REQUIRE( values(list) == std::vector<int> { 1, 2, 3 } );
+
+    two.firstNode.unlink();
+    REQUIRE( !two.firstNode.isLinked() );
+    REQUIRE( values(list) == std::vector<int> { 1, 3 } );
+    list.remove(one.firstNode);
+    REQUIRE( values(list) == std::vector<int> { 3 } );
+    list.pushBack(one.firstNode);
+    REQUIRE( values(list) == std::vector<int> { 3, 1 } );
+    three.firstNode.unlink();
+    one.firstNode.unlink();
+    REQUIRE( list.empty() );
+    REQUIRE( list.size() == 0 );
+}
+
+TEST_CASE("[IntrusiveList] Items in several lists")
+{
+    sfz::IntrusiveList<Item> first;
+    sfz::IntrusiveList<Item> second;
+    Item one { 1 }, two { 2 };
+    first.pushBack(one.firstNode);
+    first.pushBack(two.firstNode);
+    second.pushBack(two.secondNode);
+    second.pushBack(one.secondNode);
+    REQUIRE( values(first) == std::vector<int> { 1, 2 } );
+    REQUIRE( values(second) == std::vector<int> { 2, 1 } );
+    one.firstNode.unlink();
+    REQUIRE( values(first) == std::vector<int> { 2 } );
+    REQUIRE( values(second) == std::vector<int> { 2, 1 } );
+}
+
+TEST_CASE("[IntrusiveList] Lifetimes")
+{
+    sfz::IntrusiveList<Item> list;
+    Item one { 1 };
+    list.pushBack(one.firstNode);
+    {
+        Item two { 2 };
+        list.pushBack(two.firstNode);
+    }
+    REQUIRE( values(list) == std::vector<int> { 1 } );
+
+    {
+        sfz::IntrusiveList<Item> other;
+        other.pushBack(one.secondNode);
+    }
+    REQUIRE( !one.secondNode.isLinked() );
+
+    // Moving a list moves its items along
+    sfz::IntrusiveList<Item> moved { std::move(list) };
+    REQUIRE( list.empty() );
+    REQUIRE( values(moved) == std::vector<int> { 1 } );
+    one.firstNode.unlink();
+    REQUIRE( moved.empty() );
+}
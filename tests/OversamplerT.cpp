@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "sfizz/Oversampler.h"
+#include "sfizz/MathHelpers.h"
+#include "catch2/catch.hpp"
+#include <cmath>
+using namespace Catch::literals;
+
+namespace {
+float rms(absl::Span<const float> span)
+{
+    float sum { 0.0f };
+    for (auto value : span)
+        sum += value * value;
+    return std::sqrt(sum / static_cast<float>(span.size()));
+}
+
+void fillSine(absl::Span<float> span, float frequency, float sampleRate)
+{
+    for (size_t i = 0; i < span.size(); ++i)
+        span[i] = std::sin(twoPi<float> * frequency * static_cast<float>(i) / sampleRate);
+}
+}
+
+TEST_CASE("[Downsampler] Constant signal")
+{
+    for (auto factor : { sfz::Oversampling::x2, sfz::Oversampling::x4, sfz::Oversampling::x8 }) {
+        constexpr int numFrames { 256 };
+        sfz::Downsampler downsampler { factor, numFrames };
+        sfz::AudioBuffer<float> input { 2, numFrames * static_cast<size_t>(factor) };
+        sfz::AudioBuffer<float> output { 2, numFrames };
+        sfz::AudioSpan<float>(input).fill(1.0f);
+        downsampler.process(input, output);
+        for (size_t channel = 0; channel < 2; ++channel)
+            REQUIRE( output.getSpan(channel).back() == Approx(1.0f).margin(1e-3) );
+    }
+}
+
+TEST_CASE("[Downsampler] Passband and stopband")
+{
+    constexpr float sampleRate { 48000.0f };
+    constexpr int numFrames { 2048 };
+    for (auto factor : { sfz::Oversampling::x2, sfz::Oversampling::x4, sfz::Oversampling::x8 }) {
+        const auto internalRate = sampleRate * static_cast<float>(factor);
+        sfz::Downsampler downsampler { factor, numFrames };
+        sfz::AudioBuffer<float> input { 1, numFrames * static_cast<size_t>(factor) };
+        sfz::AudioBuffer<float> output { 1, numFrames };
+
+        fillSine(input.getSpan(0), 1000.0f, internalRate);
+        downsampler.process(input, output);
+        REQUIRE( rms(output.getConstSpan(0).subspan(numFrames / 2)) == Approx(1.0f / std::sqrt(2.0f)).margin(1e-2) );
+
+        // A tone above the output Nyquist frequency is filtered out rather than folded back
+        downsampler.reset();
+        fillSine(input.getSpan(0), sampleRate * 0.75f, internalRate);
+        downsampler.process(input, output);
+        REQUIRE( rms(output.getConstSpan(0).subspan(numFrames / 2)) < 0.01f );
+    }
+}
+
+TEST_CASE("[Downsampler] Block by block processing")
+{
+    constexpr int numFrames { 512 };
+    constexpr int blockSize { 64 };
+    const auto factor = sfz::Oversampling::x4;
+    sfz::AudioBuffer<float> input { 1, numFrames * static_cast<size_t>(factor) };
+    fillSine(input.getSpan(0), 3000.0f, 48000.0f * static_cast<float>(factor));
+
+    sfz::Downsampler wholeDownsampler { factor, numFrames };
+    sfz::AudioBuffer<float> wholeOutput { 1, numFrames };
+    wholeDownsampler.process(input, wholeOutput);
+
+    sfz::Downsampler blockDownsampler { factor, blockSize };
+    sfz::AudioBuffer<float> blockOutput { 1, numFrames };
+    for (size_t start = 0; start < numFrames; start += blockSize) {
+        const auto inputBlock = sfz::AudioSpan<float>(input).subspan(start * static_cast<size_t>(factor), blockSize * static_cast<size_t>(factor));
+        const auto outputBlock = sfz::AudioSpan<float>(blockOutput).subspan(start, blockSize);
+        blockDownsampler.process(inputBlock, outputBlock);
+    }
+
+    for (size_t i = 0; i < numFrames; ++i)
+        REQUIRE( blockOutput.getSpan(0)[i] == wholeOutput.getSpan(0)[i] );
+}
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: BSD-2-Clause
+
+// This code is part of the sfizz library and is licensed under a BSD 2-clause
+// license. You should have receive a LICENSE.md file along with the code.
+// If not, contact the sfizz maintainers at https://github.com/sfztools/sfizz
+
+#include "sfizz/RTSemaphore.h"
+#include "catch2/catch.hpp"
+#include <atomic>
+#include <thread>
+
+TEST_CASE("[RTSemaphore] Counting")
+{
+    sfz::RTSemaphore semaphore { 1 };
+    REQUIRE( semaphore.tryWait() );
+    REQUIRE( !semaphore.tryWait() );
+    semaphore.post();
+    semaphore.post();
+    REQUIRE( semaphore.tryWait() );
+    REQUIRE( semaphore.tryWait() );
+    REQUIRE( !semaphore.tryWait() );
+}
+
+TEST_CASE("[RTSemaphore] Wake up a waiting thread")
+{
+    sfz::RTSemaphore semaphore;
+    std::atomic<int> woken { 0 };
+    std::thread waiter { [&]() {
+        for (int i = 0; i < 3; ++i) {
+            semaphore.wait();
+            woken++;
+        }
+    } };
+
+    for (int i = 0; i < 3; ++i)
+        semaphore.post();
+
+    waiter.join();
+    REQUIRE( woken == 3 );
+    REQUIRE( !semaphore.tryWait() );
+}
@@ -11,7 +11,8 @@ using namespace Catch::literals;
 TEST_CASE("Region activation", "Region tests")
 {
     sfz::MidiState midiState;
-    sfz::Region region { midiState };
+    sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
 
     region.parseOpcode({ "sample", "*sine" });
     SECTION("Basic state")
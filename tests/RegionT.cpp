@@ -12,13 +12,14 @@ using namespace Catch::literals;
 TEST_CASE("[Region] Parsing opcodes")
 {
     sfz::MidiState midiState;
-    sfz::Region region { midiState };
+    sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
 
     SECTION("sample")
     {
-        REQUIRE(region.sample == "");
+        REQUIRE(region.getSample() == "");
         region.parseOpcode({ "sample", "dummy.wav" });
-        REQUIRE(region.sample == "dummy.wav");
+        REQUIRE(region.getSample() == "dummy.wav");
     }
 
     SECTION("delay")
@@ -93,6 +94,21 @@ TEST_CASE("[Region] Parsing opcodes")
         REQUIRE(region.loopMode == SfzLoopMode::loop_sustain);
     }
 
+    SECTION("sample_quality")
+    {
+        REQUIRE( !region.sampleQuality );
+        region.parseOpcode({ "sample_quality", "1" });
+        REQUIRE(region.sampleQuality == sfz::InterpolationQuality::Linear);
+        region.parseOpcode({ "sample_quality", "2" });
+        REQUIRE(region.sampleQuality == sfz::InterpolationQuality::Hermite);
+        region.parseOpcode({ "sample_quality", "3" });
+        REQUIRE(region.sampleQuality == sfz::InterpolationQuality::Sinc);
+        region.parseOpcode({ "sample_quality", "0" });
+        REQUIRE(region.sampleQuality == sfz::InterpolationQuality::Linear);
+        region.parseOpcode({ "sample_quality", "10" });
+        REQUIRE(region.sampleQuality == sfz::InterpolationQuality::Sinc);
+    }
+
     SECTION("loopmode")
     {
         REQUIRE( !region.loopMode );
@@ -1035,7 +1051,8 @@ TEST_CASE("[Region] Parsing opcodes")
 TEST_CASE("[Region] Non-conforming floating point values in integer opcodes")
 {
     sfz::MidiState midiState;
-    sfz::Region region { midiState };
+    sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "offset", "2014.5" });
     REQUIRE(region.offset == 2014);
     region.parseOpcode({ "pitch_keytrack", "-2.1" });
@@ -11,7 +11,8 @@ using namespace Catch::literals;
 TEST_CASE("Basic triggers", "Region triggers")
 {
     sfz::MidiState midiState;
-    sfz::Region region { midiState };
+    sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
 
     region.parseOpcode({ "sample", "*sine" });
     SECTION("key")
@@ -128,7 +129,8 @@ TEST_CASE("Basic triggers", "Region triggers")
 TEST_CASE("Legato triggers", "Region triggers")
 {
     sfz::MidiState midiState;
-    sfz::Region region { midiState };
+    sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     SECTION("First note playing")
     {
@@ -16,7 +16,8 @@ constexpr int numRandomTests { 64 };
 TEST_CASE("[Region] Crossfade in on key")
 {
 	sfz::MidiState midiState;
-    sfz::Region region { midiState };
+	sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "xfin_lokey", "1" });
     region.parseOpcode({ "xfin_hikey", "3" });
@@ -28,7 +29,8 @@ TEST_CASE("[Region] Crossfade in on key")
 TEST_CASE("[Region] Crossfade in on key - 2")
 {
 	sfz::MidiState midiState;
-    sfz::Region region { midiState };
+	sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "xfin_lokey", "1" });
     region.parseOpcode({ "xfin_hikey", "5" });
@@ -43,7 +45,8 @@ TEST_CASE("[Region] Crossfade in on key - 2")
 TEST_CASE("[Region] Crossfade in on key - gain")
 {
 	sfz::MidiState midiState;
-    sfz::Region region { midiState };
+	sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "xfin_lokey", "1" });
     region.parseOpcode({ "xfin_hikey", "5" });
@@ -58,7 +61,8 @@ TEST_CASE("[Region] Crossfade in on key - gain")
 TEST_CASE("[Region] Crossfade out on key")
 {
 	sfz::MidiState midiState;
-    sfz::Region region { midiState };
+	sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "xfout_lokey", "51" });
     region.parseOpcode({ "xfout_hikey", "55" });
@@ -74,7 +78,8 @@ TEST_CASE("[Region] Crossfade out on key")
 TEST_CASE("[Region] Crossfade out on key - gain")
 {
 	sfz::MidiState midiState;
-    sfz::Region region { midiState };
+	sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "xfout_lokey", "51" });
     region.parseOpcode({ "xfout_hikey", "55" });
@@ -91,7 +96,8 @@ TEST_CASE("[Region] Crossfade out on key - gain")
 TEST_CASE("[Region] Crossfade in on velocity")
 {
 	sfz::MidiState midiState;
-    sfz::Region region { midiState };
+	sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "xfin_lovel", "20" });
     region.parseOpcode({ "xfin_hivel", "24" });
@@ -108,7 +114,8 @@ TEST_CASE("[Region] Crossfade in on velocity")
 TEST_CASE("[Region] Crossfade in on vel - gain")
 {
 	sfz::MidiState midiState;
-    sfz::Region region { midiState };
+	sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "xfin_lovel", "20" });
     region.parseOpcode({ "xfin_hivel", "24" });
@@ -126,7 +133,8 @@ TEST_CASE("[Region] Crossfade in on vel - gain")
 TEST_CASE("[Region] Crossfade out on vel")
 {
 	sfz::MidiState midiState;
-    sfz::Region region { midiState };
+	sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "xfout_lovel", "51" });
     region.parseOpcode({ "xfout_hivel", "55" });
@@ -143,7 +151,8 @@ TEST_CASE("[Region] Crossfade out on vel")
 TEST_CASE("[Region] Crossfade out on vel - gain")
 {
 	sfz::MidiState midiState;
-    sfz::Region region { midiState };
+	sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "xfout_lovel", "51" });
     region.parseOpcode({ "xfout_hivel", "55" });
@@ -161,7 +170,8 @@ TEST_CASE("[Region] Crossfade out on vel - gain")
 TEST_CASE("[Region] Crossfade in on CC")
 {
 	sfz::MidiState midiState;
-    sfz::Region region { midiState };
+	sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "xfin_locc24", "20" });
     region.parseOpcode({ "xfin_hicc24", "24" });
@@ -178,7 +188,8 @@ TEST_CASE("[Region] Crossfade in on CC")
 TEST_CASE("[Region] Crossfade in on CC - gain")
 {
 	sfz::MidiState midiState;
-    sfz::Region region { midiState };
+	sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "xfin_locc24", "20" });
     region.parseOpcode({ "xfin_hicc24", "24" });
@@ -195,7 +206,8 @@ TEST_CASE("[Region] Crossfade in on CC - gain")
 TEST_CASE("[Region] Crossfade out on CC")
 {
 	sfz::MidiState midiState;
-    sfz::Region region { midiState };
+	sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "xfout_locc24", "20" });
     region.parseOpcode({ "xfout_hicc24", "24" });
@@ -212,7 +224,8 @@ TEST_CASE("[Region] Crossfade out on CC")
 TEST_CASE("[Region] Crossfade out on CC - gain")
 {
 	sfz::MidiState midiState;
-    sfz::Region region { midiState };
+	sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "xfout_locc24", "20" });
     region.parseOpcode({ "xfout_hicc24", "24" });
@@ -230,7 +243,8 @@ TEST_CASE("[Region] Crossfade out on CC - gain")
 TEST_CASE("[Region] Velocity bug for extreme values - veltrack at 0")
 {
     sfz::MidiState midiState;
-    sfz::Region region { midiState };
+    sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "amp_veltrack", "0" });
     REQUIRE( region.getNoteGain(64, 127) == 1.0_a );
@@ -241,7 +255,8 @@ TEST_CASE("[Region] Velocity bug for extreme values - veltrack at 0")
 TEST_CASE("[Region] Velocity bug for extreme values - positive veltrack")
 {
     sfz::MidiState midiState;
-    sfz::Region region { midiState };
+    sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "amp_veltrack", "100" });
     REQUIRE( region.getNoteGain(64, 127) == 1.0_a );
@@ -251,7 +266,8 @@ TEST_CASE("[Region] Velocity bug for extreme values - positive veltrack")
 TEST_CASE("[Region] Velocity bug for extreme values - negative veltrack")
 {
     sfz::MidiState midiState;
-    sfz::Region region { midiState };
+    sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "amp_veltrack", "-100" });
     REQUIRE( region.getNoteGain(64, 127) == Approx(0.0).margin(0.0001) );
@@ -261,7 +277,8 @@ TEST_CASE("[Region] Velocity bug for extreme values - negative veltrack")
 TEST_CASE("[Region] rt_decay")
 {
     sfz::MidiState midiState;
-    sfz::Region region { midiState };
+    sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "trigger", "release" });
     region.parseOpcode({ "rt_decay", "10" });
@@ -281,7 +298,8 @@ TEST_CASE("[Region] rt_decay")
 TEST_CASE("[Region] Base delay")
 {
     sfz::MidiState midiState;
-    sfz::Region region{ midiState };
+    sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
     region.parseOpcode({ "sample", "*sine" });
     region.parseOpcode({ "delay", "10" });
     REQUIRE( region.getDelay() == 10.0f );
@@ -293,3 +311,23 @@ TEST_CASE("[Region] Base delay")
         REQUIRE( (delay >= 10.0 && delay <= 20.0) );
     }
 }
+
+TEST_CASE("[Region] CC modulations")
+{
+    sfz::MidiState midiState;
+    sfz::SampleTable sampleTable;
+    sfz::Region region { midiState, sampleTable };
+    REQUIRE( region.isModulatedByCC(64) );
+    REQUIRE( !region.isModulatedByCC(7) );
+    region.parseOpcode({ "sustain_sw", "off" });
+    REQUIRE( !region.isModulatedByCC(64) );
+
+    region.parseOpcode({ "volume_oncc7", "-6" });
+    region.parseOpcode({ "pan_oncc10", "50" });
+    region.parseOpcode({ "xfin_locc1", "20" });
+    region.parseOpcode({ "xfin_hicc1", "40" });
+    REQUIRE( region.isModulatedByCC(7) );
+    REQUIRE( region.isModulatedByCC(10) );
+    REQUIRE( region.isModulatedByCC(1) );
+    REQUIRE( !region.isModulatedByCC(11) );
+}
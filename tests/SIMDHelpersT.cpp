@@ -756,3 +756,194 @@ TEST_CASE("[Helpers] Diff (SIMD vs Scalar)")
     sfz::diff<float, true>(input, absl::MakeSpan(outputSIMD));
     REQUIRE(approxEqual<float>(outputScalar, outputSIMD));
 }
+
+TEST_CASE("[Helpers] Linear interpolation")
+{
+    std::array<float, 4> input { 0.0f, 1.0f, 3.0f, -1.0f };
+    std::array<int, 5> indices { 0, 0, 1, 2, 2 };
+    std::array<float, 5> leftCoeffs { 1.0f, 0.5f, 0.75f, 0.5f, 0.0f };
+    std::array<float, 5> rightCoeffs { 0.0f, 0.5f, 0.25f, 0.5f, 1.0f };
+    std::array<float, 5> output;
+    std::array<float, 5> expected { 0.0f, 0.5f, 1.5f, 1.0f, -1.0f };
+    sfz::interpolateLinear<float, false>(input, indices, leftCoeffs, rightCoeffs, absl::MakeSpan(output));
+    REQUIRE(approxEqual<float>(output, expected));
+
+    std::array<int16_t, 4> compactInput { 0, 16384, -32768, 8192 };
+    std::array<float, 5> compactExpected { 0.0f, 0.25f, 0.125f, -0.375f, 0.25f };
+    sfz::interpolateLinear<int16_t, false>(compactInput, indices, leftCoeffs, rightCoeffs, absl::MakeSpan(output));
+    REQUIRE(approxEqual<float>(output, compactExpected));
+}
+
+TEST_CASE("[Helpers] Linear interpolation of 16-bit samples (SIMD vs Scalar)")
+{
+    std::vector<int16_t> input(bigBufferSize);
+    for (size_t i = 0; i < input.size(); ++i)
+        input[i] = static_cast<int16_t>((i * 7919) % 65536 - 32768);
+
+    std::vector<float> floatIndices(medBufferSize);
+    std::vector<int> indices(medBufferSize);
+    std::vector<float> leftCoeffs(medBufferSize);
+    std::vector<float> rightCoeffs(medBufferSize);
+    sfz::linearRamp<float>(absl::MakeSpan(floatIndices), 0.0f, 31.3f);
+    sfz::sfzInterpolationCast<float>(floatIndices, absl::MakeSpan(indices), absl::MakeSpan(leftCoeffs), absl::MakeSpan(rightCoeffs));
+
+    std::vector<float> outputScalar(medBufferSize);
+    std::vector<float> outputSIMD(medBufferSize);
+    sfz::interpolateLinear<int16_t, false>(input, indices, leftCoeffs, rightCoeffs, absl::MakeSpan(outputScalar));
+    sfz::interpolateLinear<int16_t, true>(input, indices, leftCoeffs, rightCoeffs, absl::MakeSpan(outputSIMD));
+    REQUIRE(approxEqual<float>(outputScalar, outputSIMD));
+
+    // Converting on the fly matches interpolating samples converted beforehand
+    std::vector<float> floatInput(bigBufferSize);
+    std::transform(input.begin(), input.end(), floatInput.begin(), [](int16_t value) { return sampleToFloat(value); });
+    std::vector<float> outputFloat(medBufferSize);
+    sfz::interpolateLinear<float, false>(floatInput, indices, leftCoeffs, rightCoeffs, absl::MakeSpan(outputFloat));
+    REQUIRE(outputFloat == outputSIMD);
+}
+
+TEST_CASE("[Helpers] Linear interpolation (SIMD vs Scalar)")
+{
+    std::vector<float> input(bigBufferSize);
+    for (size_t i = 0; i < input.size(); ++i)
+        input[i] = std::sin(static_cast<float>(i) * 0.01f);
+
+    // An odd size to go through the tail of the SIMD version
+    const size_t size = medBufferSize - 3;
+    std::vector<float> floatIndices(size);
+    std::vector<int> indices(size);
+    std::vector<float> leftCoeffs(size);
+    std::vector<float> rightCoeffs(size);
+    sfz::linearRamp<float>(absl::MakeSpan(floatIndices), 0.0f, 1.37f);
+    sfz::sfzInterpolationCast<float>(floatIndices, absl::MakeSpan(indices), absl::MakeSpan(leftCoeffs), absl::MakeSpan(rightCoeffs));
+
+    std::vector<float> outputScalar(size);
+    std::vector<float> outputSIMD(size);
+    sfz::interpolateLinear<float, false>(input, indices, leftCoeffs, rightCoeffs, absl::MakeSpan(outputScalar));
+    sfz::interpolateLinear<float, true>(input, indices, leftCoeffs, rightCoeffs, absl::MakeSpan(outputSIMD));
+    REQUIRE(approxEqual<float>(outputScalar, outputSIMD));
+}
+
+TEST_CASE("[Helpers] Hermite interpolation of a ramp")
+{
+    std::vector<float> input(medBufferSize);
+    for (size_t i = 0; i < input.size(); ++i)
+        input[i] = static_cast<float>(i);
+
+    // A cubic interpolation reproduces a line away from the edges
+    const size_t size = medBufferSize - 3;
+    std::vector<float> floatIndices(size);
+    std::vector<int> indices(size);
+    std::vector<float> leftCoeffs(size);
+    std::vector<float> rightCoeffs(size);
+    sfz::linearRamp<float>(absl::MakeSpan(floatIndices), 1.0f, 0.9f);
+    sfz::sfzInterpolationCast<float>(floatIndices, absl::MakeSpan(indices), absl::MakeSpan(leftCoeffs), absl::MakeSpan(rightCoeffs));
+
+    std::vector<float> output(size);
+    sfz::interpolateHermite<float, false>(input, indices, rightCoeffs, absl::MakeSpan(output));
+    REQUIRE(approxEqual<float>(floatIndices, output));
+    sfz::interpolateHermite<float, true>(input, indices, rightCoeffs, absl::MakeSpan(output));
+    REQUIRE(approxEqual<float>(floatIndices, output));
+}
+
+TEST_CASE("[Helpers] Sinc interpolation at integer positions and on DC")
+{
+    std::vector<float> input(medBufferSize);
+    for (size_t i = 0; i < input.size(); ++i)
+        input[i] = std::sin(static_cast<float>(i) * 0.3f);
+
+    const size_t size = medBufferSize;
+    std::vector<int> indices(size);
+    std::vector<float> positions(size, 0.0f);
+    for (size_t i = 0; i < size; ++i)
+        indices[i] = static_cast<int>(i);
+
+    std::vector<float> output(size);
+    sfz::interpolateSinc<float, false>(input, indices, positions, absl::MakeSpan(output));
+    REQUIRE(approxEqualMargin<float>(input, output));
+    sfz::interpolateSinc<float, true>(input, indices, positions, absl::MakeSpan(output));
+    REQUIRE(approxEqualMargin<float>(input, output));
+
+    // The taps have a unity gain at all fractional positions
+    std::vector<float> constant(medBufferSize, 0.5f);
+    sfz::linearRamp<float>(absl::MakeSpan(positions), 0.0f, 1.0f / size);
+    sfz::interpolateSinc<float, true>(constant, indices, positions, absl::MakeSpan(output));
+    REQUIRE(approxEqual<float>(constant, output));
+}
+
+TEST_CASE("[Helpers] Hermite and sinc interpolation (SIMD vs Scalar)")
+{
+    // A short input, so that the taps go over both edges
+    const size_t inputSize = medBufferSize;
+    std::vector<float> input(inputSize);
+    std::vector<int16_t> inputInt16(inputSize);
+    for (size_t i = 0; i < inputSize; ++i) {
+        input[i] = std::sin(static_cast<float>(i) * 0.1f);
+        inputInt16[i] = static_cast<int16_t>(input[i] * 32767.0f);
+    }
+
+    const size_t size = bigBufferSize;
+    std::vector<float> floatIndices(size);
+    std::vector<int> indices(size);
+    std::vector<float> leftCoeffs(size);
+    std::vector<float> rightCoeffs(size);
+    sfz::linearRamp<float>(absl::MakeSpan(floatIndices), 0.0f, static_cast<float>(inputSize - 1) / size);
+    sfz::sfzInterpolationCast<float>(floatIndices, absl::MakeSpan(indices), absl::MakeSpan(leftCoeffs), absl::MakeSpan(rightCoeffs));
+
+    std::vector<float> outputScalar(size);
+    std::vector<float> outputSIMD(size);
+    sfz::interpolateHermite<float, false>(input, indices, rightCoeffs, absl::MakeSpan(outputScalar));
+    sfz::interpolateHermite<float, true>(input, indices, rightCoeffs, absl::MakeSpan(outputSIMD));
+    REQUIRE(approxEqual<float>(outputScalar, outputSIMD));
+    sfz::interpolateHermite<int16_t, false>(inputInt16, indices, rightCoeffs, absl::MakeSpan(outputScalar));
+    sfz::interpolateHermite<int16_t, true>(inputInt16, indices, rightCoeffs, absl::MakeSpan(outputSIMD));
+    REQUIRE(approxEqual<float>(outputScalar, outputSIMD));
+
+    sfz::interpolateSinc<float, false>(input, indices, rightCoeffs, absl::MakeSpan(outputScalar));
+    sfz::interpolateSinc<float, true>(input, indices, rightCoeffs, absl::MakeSpan(outputSIMD));
+    REQUIRE(approxEqual<float>(outputScalar, outputSIMD));
+    sfz::interpolateSinc<int16_t, false>(inputInt16, indices, rightCoeffs, absl::MakeSpan(outputScalar));
+    sfz::interpolateSinc<int16_t, true>(inputInt16, indices, rightCoeffs, absl::MakeSpan(outputSIMD));
+    REQUIRE(approxEqual<float>(outputScalar, outputSIMD));
+}
+
+TEST_CASE("[Helpers] Pan gains")
+{
+    std::vector<float> pan(bigBufferSize);
+    sfz::linearRamp<float>(absl::MakeSpan(pan), -1.0f, 2.0f / (bigBufferSize - 1));
+    pan.back() = 1.0f;
+    std::vector<float> expectedLeft(bigBufferSize);
+    std::vector<float> expectedRight(bigBufferSize);
+    for (size_t i = 0; i < pan.size(); ++i) {
+        expectedLeft[i] = std::cos(piFour<float> * (1.0f + pan[i]));
+        expectedRight[i] = std::sin(piFour<float> * (1.0f + pan[i]));
+    }
+
+    std::vector<float> left(bigBufferSize);
+    std::vector<float> right(bigBufferSize);
+    sfz::panGains<float, false>(pan, absl::MakeSpan(left), absl::MakeSpan(right));
+    REQUIRE(approxEqualMargin<float>(left, expectedLeft, 1e-5f));
+    REQUIRE(approxEqualMargin<float>(right, expectedRight, 1e-5f));
+    sfz::panGains<float, true>(pan, absl::MakeSpan(left), absl::MakeSpan(right));
+    REQUIRE(approxEqualMargin<float>(left, expectedLeft, 1e-5f));
+    REQUIRE(approxEqualMargin<float>(right, expectedRight, 1e-5f));
+
+    // The pan span can be reused for the gains
+    std::vector<float> inPlace { pan };
+    sfz::panGains<float, true>(inPlace, absl::MakeSpan(inPlace), absl::MakeSpan(right));
+    REQUIRE(approxEqualMargin<float>(inPlace, expectedLeft, 1e-5f));
+    REQUIRE(approxEqualMargin<float>(right, expectedRight, 1e-5f));
+}
+
+TEST_CASE("[Helpers] Pan (SIMD vs Scalar)")
+{
+    std::vector<float> pan(medBufferSize);
+    sfz::linearRamp<float>(absl::MakeSpan(pan), -1.0f, 2.0f / medBufferSize);
+    std::vector<float> leftScalar(medBufferSize, 1.0f);
+    std::vector<float> rightScalar(medBufferSize, 0.5f);
+    std::vector<float> leftSIMD(medBufferSize, 1.0f);
+    std::vector<float> rightSIMD(medBufferSize, 0.5f);
+    sfz::pan<float, false>(pan, absl::MakeSpan(leftScalar), absl::MakeSpan(rightScalar));
+    sfz::pan<float, true>(pan, absl::MakeSpan(leftSIMD), absl::MakeSpan(rightSIMD));
+    REQUIRE(approxEqualMargin<float>(leftScalar, leftSIMD, 1e-5f));
+    REQUIRE(approxEqualMargin<float>(rightScalar, rightSIMD, 1e-5f));
+}
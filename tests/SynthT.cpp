@@ -6,6 +6,13 @@
 
 #include "sfizz/Synth.h"
 #include "catch2/catch.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <thread>
 using namespace Catch::literals;
 
 constexpr int blockSize { 256 };
@@ -162,3 +169,509 @@ TEST_CASE("[Synth] Releasing after the initial and normal mode does not trigger
     synth.renderBlock(buffer);
     REQUIRE( !synth.getVoiceView(0)->isFree() );
 }
+
+TEST_CASE("[Synth] Render oversampling")
+{
+    const auto renderSine = [](sfz::Oversampling factor, float& rms, int& zeroCrossings) {
+        sfz::Synth synth;
+        synth.setSampleRate(48000.0f);
+        synth.setSamplesPerBlock(256);
+        synth.setRenderOversamplingFactor(factor);
+        REQUIRE( synth.getRenderOversamplingFactor() == factor );
+        synth.loadSfzFile(fs::current_path() / "tests/TestFiles/default_path_generator.sfz");
+        sfz::AudioBuffer<float> buffer(2, 256);
+        synth.noteOn(0, 60, 127);
+        for (int i = 0; i < 8; ++i)
+            synth.renderBlock(buffer);
+
+        // Measure the last block, once the envelope and filters have settled
+        float sum { 0.0f };
+        zeroCrossings = 0;
+        const auto left = buffer.getConstSpan(0);
+        for (size_t i = 0; i < left.size(); ++i) {
+            sum += left[i] * left[i];
+            if (i > 0 && (left[i - 1] < 0.0f) != (left[i] < 0.0f))
+                zeroCrossings++;
+        }
+        rms = std::sqrt(sum / static_cast<float>(left.size()));
+        REQUIRE( synth.getOversamplingFactor() == sfz::Oversampling::x1 );
+    };
+
+    float referenceRms;
+    int referenceCrossings;
+    renderSine(sfz::Oversampling::x1, referenceRms, referenceCrossings);
+    REQUIRE( referenceRms > 0.0f );
+    for (auto factor : { sfz::Oversampling::x2, sfz::Oversampling::x4, sfz::Oversampling::x8 }) {
+        float rms;
+        int crossings;
+        renderSine(factor, rms, crossings);
+        REQUIRE( rms == Approx(referenceRms).epsilon(0.05) );
+        REQUIRE( std::abs(crossings - referenceCrossings) <= 1 );
+    }
+}
+
+TEST_CASE("[Synth] Render oversampling keeps the event delays in output frames")
+{
+    sfz::Synth synth;
+    synth.setSamplesPerBlock(256);
+    synth.setRenderOversamplingFactor(sfz::Oversampling::x4);
+    synth.loadSfzFile(fs::current_path() / "tests/TestFiles/default_path_generator.sfz");
+    sfz::AudioBuffer<float> buffer(2, 256);
+    synth.noteOn(128, 60, 127);
+    synth.renderBlock(buffer);
+    const auto left = buffer.getConstSpan(0);
+    REQUIRE( std::all_of(left.begin(), left.begin() + 128, [](float value) { return value == 0.0f; }) );
+    REQUIRE( std::any_of(left.begin() + 128, left.end(), [](float value) { return value != 0.0f; }) );
+}
+
+TEST_CASE("[Synth] Render voices on worker threads")
+{
+    const auto renderChord = [](int numThreads, sfz::AudioBuffer<float>& buffer) {
+        sfz::Synth synth;
+        synth.setSamplesPerBlock(256);
+        synth.setNumRenderThreads(numThreads);
+        REQUIRE( synth.getNumRenderThreads() == numThreads );
+        synth.loadSfzFile(fs::current_path() / "tests/TestFiles/default_path_generator.sfz");
+        for (int note = 40; note < 72; ++note)
+            synth.noteOn(note - 40, note, 100);
+        REQUIRE( synth.getNumActiveVoices() == 32 );
+        for (int i = 0; i < 4; ++i)
+            synth.renderBlock(buffer);
+    };
+
+    sfz::AudioBuffer<float> reference { 2, 256 };
+    renderChord(0, reference);
+    for (int numThreads : { 1, 3 }) {
+        sfz::AudioBuffer<float> buffer { 2, 256 };
+        renderChord(numThreads, buffer);
+        for (size_t channel = 0; channel < 2; ++channel) {
+            for (size_t i = 0; i < 256; ++i)
+                REQUIRE( buffer.getSpan(channel)[i] == Approx(reference.getSpan(channel)[i]).margin(1e-4) );
+        }
+    }
+}
+
+TEST_CASE("[Synth] Render a varying number of voices on worker threads")
+{
+    sfz::Synth reference;
+    sfz::Synth synth;
+    synth.setNumRenderThreads(3);
+    for (auto* s : { &reference, &synth }) {
+        s->setSamplesPerBlock(256);
+        s->loadSfzFile(fs::current_path() / "tests/TestFiles/default_path_generator.sfz");
+    }
+
+    sfz::AudioBuffer<float> referenceBuffer { 2, 256 };
+    sfz::AudioBuffer<float> buffer { 2, 256 };
+    // Blocks with no voice or a single one leave the workers asleep, so
+    // that they can wake up late for the next blocks
+    for (int block = 0; block < 200; ++block) {
+        for (auto* s : { &reference, &synth }) {
+            if (block % 50 == 0)
+                s->cc(0, sfz::config::allSoundOffCC, 0);
+            else if (block % 5 == 0)
+                s->noteOn(0, 40 + block % 32, 100);
+        }
+
+        reference.renderBlock(referenceBuffer);
+        synth.renderBlock(buffer);
+        REQUIRE( synth.getNumActiveVoices() == reference.getNumActiveVoices() );
+        for (size_t channel = 0; channel < 2; ++channel) {
+            for (size_t i = 0; i < 256; ++i)
+                REQUIRE( buffer.getSpan(channel)[i] == Approx(referenceBuffer.getSpan(channel)[i]).margin(1e-4) );
+        }
+    }
+}
+
+TEST_CASE("[Synth] Sample quality")
+{
+    const auto renderNote = [](sfz::InterpolationQuality quality, int note, sfz::AudioBuffer<float>& buffer) {
+        sfz::Synth synth;
+        synth.setSampleRate(44100.0f);
+        synth.setSamplesPerBlock(256);
+        synth.setSampleQuality(quality);
+        REQUIRE( synth.getSampleQuality() == quality );
+        synth.loadSfzFile(fs::current_path() / "tests/TestFiles/channels.sfz");
+        synth.noteOn(0, note, 127);
+        for (int i = 0; i < 4; ++i)
+            synth.renderBlock(buffer);
+    };
+
+    // At the rate of the sample and without transposition, all the qualities
+    // read the samples as they are
+    sfz::AudioBuffer<float> reference { 2, 256 };
+    renderNote(sfz::InterpolationQuality::Linear, 60, reference);
+    REQUIRE( std::any_of(reference.getSpan(0).begin(), reference.getSpan(0).end(), [](float value) { return value != 0.0f; }) );
+    for (auto quality : { sfz::InterpolationQuality::Hermite, sfz::InterpolationQuality::Sinc }) {
+        sfz::AudioBuffer<float> buffer { 2, 256 };
+        renderNote(quality, 60, buffer);
+        for (size_t i = 0; i < 256; ++i)
+            REQUIRE( buffer.getSpan(0)[i] == Approx(reference.getSpan(0)[i]).margin(1e-4) );
+    }
+}
+
+TEST_CASE("[Synth] Constant pan")
+{
+    // Render a note for a while and get the RMS level of both channels
+    const auto renderNote = [](int noteNumber) {
+        sfz::Synth synth;
+        synth.setSamplesPerBlock(256);
+        synth.loadSfzFile(fs::current_path() / "tests/TestFiles/pan_generator.sfz");
+        sfz::AudioBuffer<float> buffer { 2, 256 };
+        synth.noteOn(0, noteNumber, 127);
+        std::array<float, 2> energy { 0.0f, 0.0f };
+        constexpr int numBlocks { 32 };
+        for (int i = 0; i < numBlocks; ++i) {
+            synth.renderBlock(buffer);
+            for (size_t channel = 0; channel < 2; ++channel) {
+                for (auto value : buffer.getConstSpan(channel))
+                    energy[channel] += value * value;
+            }
+        }
+        for (auto& level : energy)
+            level = std::sqrt(level / (numBlocks * 256));
+        return energy;
+    };
+
+    const auto left = renderNote(60);
+    REQUIRE( left[0] > 0.1f );
+    REQUIRE( left[1] == 0.0f );
+
+    const auto right = renderNote(62);
+    REQUIRE( right[0] == 0.0f );
+    REQUIRE( right[1] == Approx(left[0]).epsilon(0.005) );
+
+    // A centered voice keeps the power of a fully panned one
+    const auto center = renderNote(64);
+    REQUIRE( center[0] == center[1] );
+    REQUIRE( center[0] == Approx(left[0] / std::sqrt(2.0f)).epsilon(0.005) );
+}
+
+TEST_CASE("[Synth] Steal the oldest released voice")
+{
+    sfz::Synth synth;
+    synth.setSamplesPerBlock(256);
+    synth.setNumVoices(2);
+    synth.loadSfzFile(fs::current_path() / "tests/TestFiles/voice_stealing.sfz");
+    sfz::AudioBuffer<float> buffer { 2, 256 };
+    synth.noteOn(0, 60, 127);
+    synth.noteOn(0, 62, 127);
+    synth.renderBlock(buffer);
+    REQUIRE( synth.getNumActiveVoices() == 2 );
+
+    // Both voices are releasing, and the new note takes the oldest one
+    synth.noteOff(0, 60, 0);
+    synth.noteOff(0, 62, 0);
+    synth.renderBlock(buffer);
+    synth.noteOn(0, 64, 127);
+    REQUIRE( synth.getNumActiveVoices() == 2 );
+    REQUIRE( synth.getVoiceView(0)->getTriggerNumber() == 64 );
+    REQUIRE( synth.getVoiceView(1)->getTriggerNumber() == 62 );
+
+    // The next one takes the remaining released voice
+    synth.noteOn(0, 65, 127);
+    REQUIRE( synth.getVoiceView(1)->getTriggerNumber() == 65 );
+
+    // No voice can be stolen while they are all playing
+    synth.noteOn(0, 67, 127);
+    REQUIRE( synth.getVoiceView(0)->getTriggerNumber() == 64 );
+    REQUIRE( synth.getVoiceView(1)->getTriggerNumber() == 65 );
+}
+
+TEST_CASE("[Synth] Reuse the voices stopped by an event before the next block")
+{
+    sfz::Synth synth;
+    synth.setSamplesPerBlock(256);
+    synth.setNumVoices(2);
+    synth.loadSfzFile(fs::current_path() / "tests/TestFiles/voice_stealing.sfz");
+    synth.noteOn(0, 60, 127);
+    synth.noteOn(0, 62, 127);
+    REQUIRE( synth.getNumActiveVoices() == 2 );
+
+    synth.cc(0, sfz::config::allSoundOffCC, 0);
+    REQUIRE( synth.getNumActiveVoices() == 0 );
+    synth.noteOn(0, 64, 127);
+    synth.noteOn(0, 65, 127);
+    REQUIRE( synth.getNumActiveVoices() == 2 );
+    std::array<int, 2> triggerNumbers {
+        synth.getVoiceView(0)->getTriggerNumber(),
+        synth.getVoiceView(1)->getTriggerNumber()
+    };
+    std::sort(triggerNumbers.begin(), triggerNumbers.end());
+    REQUIRE( triggerNumbers == std::array<int, 2> { 64, 65 } );
+}
+
+TEST_CASE("[Synth] Pitch bend conditions")
+{
+    sfz::Synth synth;
+    synth.loadSfzFile(fs::current_path() / "tests/TestFiles/bend_conditions.sfz");
+    synth.pitchWheel(0, 4000);
+    synth.noteOn(0, 60, 127);
+    REQUIRE( synth.getNumActiveVoices() == 1 );
+    REQUIRE( synth.getVoiceView(0)->getRegion()->bendRange.getStart() == 0 );
+
+    synth.pitchWheel(0, -4000);
+    synth.noteOn(0, 60, 127);
+    REQUIRE( synth.getNumActiveVoices() == 2 );
+    REQUIRE( synth.getVoiceView(1)->getRegion()->bendRange.getEnd() == -1 );
+
+    // Regions without conditions play with any bend
+    synth.noteOn(0, 62, 127);
+    REQUIRE( synth.getNumActiveVoices() == 3 );
+
+    // Resetting the controllers stops the voices and brings the bend back
+    // to the center
+    synth.cc(0, sfz::config::resetCC, 0);
+    REQUIRE( synth.getNumActiveVoices() == 0 );
+    synth.noteOn(0, 60, 127);
+    REQUIRE( synth.getNumActiveVoices() == 1 );
+    for (int i = 0; i < synth.getNumVoices(); ++i) {
+        const auto voice = synth.getVoiceView(i);
+        if (!voice->isFree())
+            REQUIRE( voice->getRegion()->bendRange.getStart() == 0 );
+    }
+}
+
+TEST_CASE("[Synth] Velocity layers and sequences")
+{
+    sfz::Synth synth;
+    synth.loadSfzFile(fs::current_path() / "tests/TestFiles/velocity_layers.sfz");
+    const auto lastVoice = [&]() { return synth.getVoiceView(synth.getNumActiveVoices() - 1); };
+
+    synth.noteOn(0, 60, 30);
+    REQUIRE( synth.getNumActiveVoices() == 1 );
+    REQUIRE( lastVoice()->getRegion()->velocityRange == sfz::Range<uint8_t>(0, 63) );
+    synth.noteOn(0, 60, 105);
+    REQUIRE( synth.getNumActiveVoices() == 3 );
+    synth.noteOn(0, 60, 64);
+    REQUIRE( synth.getNumActiveVoices() == 4 );
+    REQUIRE( lastVoice()->getRegion()->velocityRange == sfz::Range<uint8_t>(64, 127) );
+
+    // The sequence advances with every note on the key, whatever the layer
+    synth.noteOn(0, 62, 30);
+    REQUIRE( synth.getNumActiveVoices() == 5 );
+    REQUIRE( lastVoice()->getRegion()->sequencePosition == 2 );
+    synth.noteOn(0, 62, 100);
+    REQUIRE( synth.getNumActiveVoices() == 6 );
+    REQUIRE( lastVoice()->getRegion()->sequencePosition == 1 );
+    REQUIRE( lastVoice()->getRegion()->velocityRange == sfz::Range<uint8_t>(64, 127) );
+    synth.noteOn(0, 62, 100);
+    REQUIRE( synth.getNumActiveVoices() == 7 );
+    REQUIRE( lastVoice()->getRegion()->sequencePosition == 2 );
+    synth.noteOn(0, 62, 30);
+    REQUIRE( synth.getNumActiveVoices() == 8 );
+    REQUIRE( lastVoice()->getRegion()->sequencePosition == 1 );
+    REQUIRE( lastVoice()->getRegion()->velocityRange == sfz::Range<uint8_t>(0, 63) );
+}
+
+TEST_CASE("[Synth] Keep playing while loading an instrument")
+{
+    const auto testDirectory = fs::temp_directory_path() / "sfizz_background_load_test";
+    fs::remove_all(testDirectory);
+    fs::create_directories(testDirectory);
+    {
+        std::ofstream output { (testDirectory / "playing.sfz").string(), std::ios::trunc };
+        output << "<region> key=60 sample=*sine\n";
+    }
+    {
+        // Large enough for the parsing to span many blocks
+        std::ofstream output { (testDirectory / "loading.sfz").string(), std::ios::trunc };
+        for (int i = 0; i < 20000; ++i)
+            output << "<region> key=" << i % 128 << " lovel=" << i % 127 + 1 << " sample=*sine volume=-6\n";
+    }
+
+    sfz::Synth synth;
+    synth.setSamplesPerBlock(blockSize);
+    REQUIRE( synth.loadSfzFile(testDirectory / "playing.sfz") );
+    synth.noteOn(0, 60, 100);
+    sfz::AudioBuffer<float> buffer { 2, blockSize };
+    synth.renderBlock(buffer);
+    REQUIRE( synth.getNumActiveVoices() == 1 );
+
+    // The note of the previous instrument only stops when the new one is
+    // swapped in, right before the load returns
+    using Clock = std::chrono::steady_clock;
+    std::atomic<bool> loaded { false };
+    bool loadResult { false };
+    const auto loadStart = Clock::now();
+    std::thread loader { [&]() {
+        loadResult = synth.loadSfzFile(testDirectory / "loading.sfz");
+        loaded = true;
+    } };
+    auto lastAudibleBlock = loadStart;
+    while (!loaded) {
+        synth.renderBlock(buffer);
+        const auto left = buffer.getSpan(0);
+        if (std::any_of(left.begin(), left.end(), [](float value) { return value != 0.0f; }))
+            lastAudibleBlock = Clock::now();
+    }
+    loader.join();
+    const auto loadEnd = Clock::now();
+    REQUIRE( loadResult );
+    REQUIRE( loadEnd - lastAudibleBlock < (loadEnd - loadStart) / 2 );
+    REQUIRE( synth.getNumRegions() == 20000 );
+    REQUIRE( synth.getNumActiveVoices() == 0 );
+    fs::remove_all(testDirectory);
+}
+
+TEST_CASE("[Synth] Instrument cache")
+{
+    const auto testDirectory = fs::temp_directory_path() / "sfizz_instrument_cache_test";
+    const auto cacheDirectory = testDirectory / "cache";
+    fs::remove_all(testDirectory);
+    fs::create_directories(testDirectory);
+    fs::copy_file(fs::current_path() / "tests/TestFiles/kick.wav", testDirectory / "sample.wav");
+    const auto writeFile = [](const fs::path& file, const char* contents) {
+        std::ofstream output { file.string(), std::ios::trunc };
+        output << contents;
+    };
+    writeFile(testDirectory / "instrument.sfz",
+        "#define $KEY 60\n"
+        "<control> set_cc20=100 label_cc20=Test\n"
+        "<global> sw_lokey=30 sw_hikey=50 sw_default=40 ampeg_release=0.1 unknown_opcode=1\n"
+        "<group> volume=-6 amp_velcurve_64=0.5 xfin_locc1=0 xfin_hicc1=127\n"
+        "<region> sw_last=40 key=$KEY sample=sample.wav seq_length=2 seq_position=1\n"
+        "<region> sw_last=40 key=$KEY sample=*sine seq_length=2 seq_position=2\n"
+        "#include \"included.sfz\"\n");
+    writeFile(testDirectory / "included.sfz",
+        "<group> on_locc64=64 on_hicc64=127\n"
+        "<region> key=62 sample=*sine\n");
+
+    const auto load = [&](sfz::Synth& synth, bool useCache) {
+        synth.setSamplesPerBlock(blockSize);
+        if (useCache)
+            synth.setInstrumentCacheDirectory(cacheDirectory);
+        REQUIRE( synth.loadSfzFile(testDirectory / "instrument.sfz") );
+    };
+    const auto play = [](sfz::Synth& synth) {
+        sfz::AudioBuffer<float> buffer { 2, blockSize };
+        std::vector<float> output;
+        for (int i = 0; i < 20; ++i) {
+            if (i % 4 == 0)
+                synth.noteOn(0, 60, 100);
+            if (i == 5)
+                synth.cc(10, 64, 127);
+            if (i == 10)
+                synth.noteOn(0, 62, 30);
+            synth.renderBlock(buffer);
+            output.insert(output.end(), buffer.getSpan(0).begin(), buffer.getSpan(0).end());
+        }
+        return output;
+    };
+
+    sfz::Synth reference;
+    load(reference, false);
+    REQUIRE( !fs::exists(cacheDirectory) );
+    sfz::Synth first;
+    load(first, true);
+    REQUIRE( std::distance(fs::directory_iterator(cacheDirectory), fs::directory_iterator()) == 1 );
+    sfz::Synth second;
+    load(second, true);
+
+    for (auto* synth : { &first, &second }) {
+        REQUIRE( synth->getNumRegions() == reference.getNumRegions() );
+        REQUIRE( synth->getNumGroups() == reference.getNumGroups() );
+        REQUIRE( synth->getUnknownOpcodes() == reference.getUnknownOpcodes() );
+        REQUIRE( synth->getIncludedFiles() == reference.getIncludedFiles() );
+        REQUIRE( synth->getDefines().at("$KEY") == "60" );
+        for (int i = 0; i < reference.getNumRegions(); ++i) {
+            const auto* expected = reference.getRegionView(i);
+            const auto* region = synth->getRegionView(i);
+            REQUIRE( region->getSample() == expected->getSample() );
+            REQUIRE( region->keyRange == expected->keyRange );
+            REQUIRE( region->keyswitch == expected->keyswitch );
+            REQUIRE( region->sequencePosition == expected->sequencePosition );
+            REQUIRE( region->volume == expected->volume );
+            REQUIRE( region->velocityPoints == expected->velocityPoints );
+            REQUIRE( region->crossfadeCCInRange.contains(1) == expected->crossfadeCCInRange.contains(1) );
+            REQUIRE( region->ccTriggers.contains(64) == expected->ccTriggers.contains(64) );
+            REQUIRE( region->amplitudeEG.release == expected->amplitudeEG.release );
+            REQUIRE( region->isStereo == expected->isStereo );
+            REQUIRE( region->sampleEnd == expected->sampleEnd );
+        }
+    }
+
+    const auto expectedOutput = play(reference);
+    REQUIRE( play(first) == expectedOutput );
+    REQUIRE( play(second) == expectedOutput );
+
+    // The entry is kept while the included files keep their size and
+    // modification time, and is replaced otherwise
+    const auto included = testDirectory / "included.sfz";
+    const auto modificationTime = fs::last_write_time(included);
+    writeFile(included,
+        "<group> on_locc64=64 on_hicc64=127\n"
+        "<region> key=63 sample=*sine\n");
+    fs::last_write_time(included, modificationTime);
+    sfz::Synth cached;
+    load(cached, true);
+    REQUIRE( cached.getRegionView(cached.getNumRegions() - 1)->keyRange == sfz::Range<uint8_t>(62, 62) );
+
+    fs::last_write_time(included, modificationTime + std::chrono::seconds(1));
+    sfz::Synth modified;
+    load(modified, true);
+    REQUIRE( modified.getRegionView(modified.getNumRegions() - 1)->keyRange == sfz::Range<uint8_t>(63, 63) );
+    sfz::Synth reloaded;
+    load(reloaded, true);
+    REQUIRE( reloaded.getRegionView(reloaded.getNumRegions() - 1)->keyRange == sfz::Range<uint8_t>(63, 63) );
+
+    // An entry written with another region layout is not read, even if the
+    // included files did not change
+    const auto reloadedTime = fs::last_write_time(included);
+    writeFile(included,
+        "<group> on_locc64=64 on_hicc64=127\n"
+        "<region> key=64 sample=*sine\n");
+    fs::last_write_time(included, reloadedTime);
+    const auto entry = fs::directory_iterator(cacheDirectory)->path();
+    {
+        // The size of the regions follows the magic and the version
+        std::fstream stream { entry.string(), std::ios::binary | std::ios::in | std::ios::out };
+        stream.seekp(12);
+        const uint64_t otherSize { sizeof(sfz::Region) + 8 };
+        stream.write(reinterpret_cast<const char*>(&otherSize), sizeof(otherSize));
+    }
+    sfz::Synth otherLayout;
+    load(otherLayout, true);
+    REQUIRE( otherLayout.getRegionView(otherLayout.getNumRegions() - 1)->keyRange == sfz::Range<uint8_t>(64, 64) );
+    fs::remove_all(testDirectory);
+}
+
+TEST_CASE("[Synth] Sequences of regions triggered by a CC")
+{
+    sfz::Synth synth;
+    synth.loadSfzFile(fs::current_path() / "tests/TestFiles/cc_sequence.sfz");
+
+    // The CC region is in its position after the first note-on
+    synth.noteOn(0, 0, 100);
+    REQUIRE( synth.getNumActiveVoices() == 0 );
+    synth.cc(0, 64, 127);
+    REQUIRE( synth.getNumActiveVoices() == 1 );
+    REQUIRE( synth.getVoiceView(0)->getRegion()->sequencePosition == 2 );
+
+    // It leaves its position when the note region plays
+    synth.noteOn(0, 0, 100);
+    REQUIRE( synth.getNumActiveVoices() == 2 );
+    synth.cc(0, 64, 0);
+    synth.cc(0, 64, 127);
+    REQUIRE( synth.getNumActiveVoices() == 2 );
+}
+
+TEST_CASE("[Synth] Sequences of velocity-limited regions triggered by a CC")
+{
+    sfz::Synth synth;
+    synth.loadSfzFile(fs::current_path() / "tests/TestFiles/cc_sequence_velocity.sfz");
+
+    // The note-ons out of the velocity range of the CC region still advance
+    // its sequence
+    synth.noteOn(0, 0, 100);
+    REQUIRE( synth.getNumActiveVoices() == 0 );
+    synth.cc(0, 64, 127);
+    REQUIRE( synth.getNumActiveVoices() == 1 );
+    REQUIRE( synth.getVoiceView(0)->getRegion()->sequencePosition == 2 );
+
+    synth.noteOn(0, 0, 100);
+    REQUIRE( synth.getNumActiveVoices() == 2 );
+    synth.cc(0, 64, 0);
+    synth.cc(0, 64, 127);
+    REQUIRE( synth.getNumActiveVoices() == 2 );
+}